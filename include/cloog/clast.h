@@ -11,8 +11,16 @@ enum clast_expr_type {
     clast_expr_bin,
     clast_expr_red
 };
+struct clast_intern;
+
 struct clast_expr {
     enum clast_expr_type type;
+    int			arena;	/**< 1 if allocated in the arena of a clast. */
+    int			ref;	/**< Number of references to the expression. */
+    struct clast_intern *intern; /**< Table in which the expression is
+				  *   shared with all structurally equal
+				  *   ones, NULL if it is not shared.
+				  */
 };
 
 struct clast_name {
@@ -36,6 +44,13 @@ struct clast_term {
 #define CLAST_PARALLEL_MPI 2
 #define CLAST_PARALLEL_VEC 4
 #define CLAST_PARALLEL_USER 8
+/* Clauses of the OpenMP directives, see pprint_for. */
+#define CLAST_PARALLEL_COLLAPSE 16
+#define CLAST_PARALLEL_DYNAMIC 32
+#define CLAST_PARALLEL_SIMD 64
+/* Directive of the OpenScop loop extension asking for unroll-and-jam, see
+ * clast_unroll_jam. It is not kept in the parallel field. */
+#define CLAST_UNROLL_JAM 128
 
 enum clast_red_type { clast_red_sum, clast_red_min, clast_red_max };
 struct clast_reduction {
@@ -71,11 +86,26 @@ extern const struct clast_stmt_op stmt_guard;
 struct clast_stmt {
     const struct clast_stmt_op    *op;
     struct clast_stmt	*next;
+    int			arena;	/**< 1 if allocated in the arena of a clast. */
 };
 
+struct clast_arena;
+
 struct clast_root {
     struct clast_stmt	stmt;
     CloogNames *	names;       /**< Names of iterators and parameters. */
+    struct clast_arena *arena;       /**< Region holding all the other nodes
+				      *   of the clast, NULL if they are
+				      *   allocated one by one.
+				      */
+    struct clast_intern *intern;     /**< Table of the shared expressions
+				      *   of the clast, NULL if expressions
+				      *   are not shared.
+				      */
+    int nb_temporaries;              /**< Number of temporaries. */
+    char **temporaries;              /**< Names of the temporaries assigned
+				      *   by clast_hoist_bounds.
+				      */
 };
 
 struct clast_assignment {
@@ -155,6 +185,9 @@ struct clast_for *new_clast_for(CloogDomain *domain, const char *it,
                                 CloogStride *stride);
 struct clast_guard *new_clast_guard(int n);
 void clast_unroll_jam(struct clast_stmt *s);
+void clast_hoist_bounds(struct clast_stmt *s);
+void clast_root_adopt_stmt(struct clast_root *r, struct clast_stmt *s);
+void clast_root_adopt_expr(struct clast_root *r, struct clast_expr *e);
 
 void free_clast_name(struct clast_name *t);
 void free_clast_term(struct clast_term *t);
@@ -81,8 +81,12 @@ CloogConstraintSet *cloog_constraint_set_reduce(CloogConstraintSet *constraints,
 	int level, CloogEqualities *equal, int nb_par, cloog_int_t *bound);
 int cloog_constraint_set_foreach_constraint(CloogConstraintSet *constraints,
 	int (*fn)(CloogConstraint *constraint, void *user), void *user);
+int cloog_constraint_set_foreach_constraint_involving(
+	CloogConstraintSet *constraints, int level,
+	int (*fn)(CloogConstraint *constraint, void *user), void *user);
 int              cloog_constraint_is_valid(CloogConstraint *constraint);
 CloogConstraint *cloog_constraint_copy(CloogConstraint *constraint);
+CloogConstraint *cloog_constraint_dup(CloogConstraint *constraint);
 void             cloog_constraint_release(CloogConstraint *constraint);
 CloogConstraint *cloog_constraint_invalid(void);
 int              cloog_constraint_total_dimension(CloogConstraint *constraint);
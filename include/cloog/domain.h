@@ -88,10 +88,18 @@ CloogDomain * cloog_domain_union(CloogDomain *, CloogDomain *) ;
 CloogDomain * cloog_domain_intersection(CloogDomain *, CloogDomain *) ;
 CloogDomain * cloog_domain_difference(CloogDomain *, CloogDomain *) ;
 void          cloog_domain_sort(CloogDomain**,unsigned,unsigned,int *);
+void          cloog_domain_sort_parallel(CloogState *state, int nb_threads,
+				CloogDomain **doms, unsigned nb_doms,
+				unsigned level, int *permut);
 int cloog_domain_follows(CloogDomain *dom1, CloogDomain *dom2, unsigned level);
 CloogDomain * cloog_domain_empty(CloogDomain *model);
 int cloog_domain_is_bounded(CloogDomain *dim, unsigned level);
+void cloog_domain_level_bounds(CloogDomain *domain, int level,
+	cloog_int_t *lower, int *has_lower, cloog_int_t *upper, int *has_upper);
 CloogDomain *cloog_domain_bound_splitter(CloogDomain *dom, int level);
+CloogDomain *cloog_domain_minmax_splitter(CloogDomain *dom, int level,
+	int max);
+CloogDomain *cloog_domain_full_tiles(CloogDomain *dom, int level);
 
 
 /******************************************************************************
@@ -147,6 +155,11 @@ CloogDomain * cloog_domain_fixed_offset(CloogDomain *domain, int level,
 				CloogConstraint *lb, cloog_int_t offset);
 int           cloog_domain_lazy_disjoint(CloogDomain *, CloogDomain *) ;
 int           cloog_domain_lazy_equal(CloogDomain *, CloogDomain *) ;
+void          cloog_domain_separation_pieces(CloogState *state,
+				int nb_threads, CloogDomain *domain, int n,
+				CloogDomain **doms,
+				CloogDomain **inter, int *inter_empty,
+				CloogDomain **diff, int *diff_empty);
 int           cloog_scattering_lazy_block(CloogScattering *, CloogScattering *,
                                       CloogScatteringList *, int);
 int           cloog_scattering_lazy_isscalar(CloogScattering *, int,
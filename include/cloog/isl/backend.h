@@ -3,9 +3,20 @@
 
 #include <isl/constraint.h>
 
+struct cloog_domain_memo;
+
 struct cloogbackend {
 	struct isl_ctx	*ctx;
 	unsigned	ctx_allocated : 1;
+
+	/* Contexts of the worker threads, allocated on first use. */
+	struct isl_ctx	**worker_ctx;
+	int		nb_worker_ctx;
+
+	/* Cache of domain operations, see cloog_state_set_domain_cache. */
+	struct cloog_domain_memo	*memo;
 };
 
+void cloog_domain_memo_free(struct cloog_domain_memo *memo);
+
 #endif /* define _H */
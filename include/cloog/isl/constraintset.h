@@ -8,8 +8,22 @@ extern "C"
   {
 #endif 
 
+/* A basic set and, once they are needed, its constraints together with
+ * an index of the constraints involving each variable.  The variables are
+ * numbered in CLooG order (iterators, existentials, parameters) and "sign"
+ * holds the sign of the coefficient of each variable in each constraint.
+ * The set is reference counted and never modified after its creation.
+ */
 struct cloogconstraintset {
-	int dummy;	/* Solaris cc doesn't like zero-sized structs */
+	int			  ref;
+	isl_basic_set		 *bset;
+	int			  n;	/* -1 until the index is built */
+	int			  total;
+	isl_constraint		**constraints;
+	int			 *flags;
+	signed char		 *sign;
+	int			 *start;
+	int			 *index;
 };
 
 struct cloogequalities {
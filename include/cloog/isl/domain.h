@@ -12,8 +12,15 @@ extern "C"
 #endif 
 
 
+/* A domain is an isl_set together with the state whose statistics and
+ * domain cache the operations on the domain use.  The state is NULL for
+ * the domains built from an isl_set by the user and is passed on from
+ * the arguments of an operation to its result.
+ */
 struct cloogdomain {
-	int dummy;	/* Solaris cc doesn't like zero-sized structs */
+	int references;
+	struct cloogstate *state;
+	isl_set *set;
 };
 
 struct cloogscattering {
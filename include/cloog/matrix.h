@@ -8,9 +8,14 @@ extern "C"
 /* The CloogMatrix structure is equivalent to the PolyLib Matrix data structure
  * (see Wil93). This structure is devoted to represent a set of constraints.
  *
- * The whole matrix is stored in memory row after row at the p_Init address. p
- * is an array of pointers where p[i] points to the first element of the i^{th
- * row. NbRows and NbColumns are respectively the number of rows and columns of
+ * The whole matrix is stored in memory row after row at the p_Init address,
+ * the start of each row being Stride elements after the start of the
+ * previous one. Stride is NbColumns rounded up such that, with p_Init
+ * aligned on CLOOG_MATRIX_ALIGN bytes, every row is aligned as well, and
+ * the padding elements are zero. p is an array of pointers where p[i] points
+ * to the first element of the i^{th row, i.e., p[i] = p_Init + i * Stride;
+ * cloog_matrix_row returns the same row view without going through p.
+ * NbRows and NbColumns are respectively the number of rows and columns of
  * the matrix. Each row corresponds to a constraint. The first element of each
  * row is an equality/inequality tag. The constraint is an equality p(x) = 0 if
  * the first element is 0, but it is an inequality p(x) \geq 0 if the first
@@ -32,20 +37,28 @@ extern "C"
  * To be able to provide different precision version (CLooG supports 32 bits,
  * 64 bits and arbitrary precision through the GMP library), the cloog_int_t
  * type depends on the configuration options (it may be long int for 32 bits
- * version, long long int for 64 bits version, and mpz_t for multiple precision
- * version). */
+ * version, long long int for 64 bits version, and a small integer or mpz_t
+ * for multiple precision version). */
+
+#define CLOOG_MATRIX_ALIGN	64
 
 struct cloogmatrix
 { unsigned NbRows;    /* Number of rows. */
   unsigned NbColumns; /* Number of columns. */
   cloog_int_t ** p;         /* Array of pointers to the matrix rows. */
   cloog_int_t * p_Init;     /* Matrix rows contiguously in memory. */
+  unsigned Stride;    /* Distance in elements between two rows. */
 };
 
 typedef struct cloogmatrix CloogMatrix;
 
 CloogMatrix *cloog_matrix_alloc (unsigned, unsigned);
 void cloog_matrix_free (CloogMatrix *);
+cloog_int_t *cloog_matrix_row(CloogMatrix *M, unsigned i);
+void cloog_matrix_row_cpy(CloogMatrix *dst, unsigned i,
+		CloogMatrix *src, unsigned j);
+void cloog_matrix_row_swap(CloogMatrix *M, unsigned i, unsigned j);
+void cloog_matrix_cpy(CloogMatrix *dst, CloogMatrix *src);
 void cloog_matrix_print_structure(FILE *file, CloogMatrix *M,
 		const char *prefix, const char *suffix);
 CloogMatrix *cloog_matrix_read(FILE *input);
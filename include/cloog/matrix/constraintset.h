@@ -17,7 +17,7 @@ struct cloogequalities {
 
 struct cloogconstraint {
 	CloogConstraintSet	*set;
-	cloog_int_t		**line;
+	cloog_int_t		*line;	/* View of a row of set->M. */
 };
 
 CloogConstraintSet *cloog_constraint_set_from_cloog_matrix(CloogMatrix *M);
@@ -72,6 +72,41 @@ struct cloogoptions
                      */
   int sh;	    /* 1 for computing simple hulls */
   int first_unroll; /* The first dimension to unroll */
+  int nb_threads;   /* Number of threads used for loop separation, 1 (or
+                     * less) to separate sequentially.
+                     */
+  int domain_cache; /* Number of entries of the cache of domain operations,
+                     * 0 to disable it.
+                     */
+  int deadline;     /* Time budget of code generation in milliseconds, -1 for
+                     * no budget. Once it is exceeded, loops are merged instead
+                     * of being separated.
+                     */
+  int node_pool;    /* 1 to allocate loops, blocks and statements from
+                     * freelists of the CloogState, 0 to use malloc.
+                     */
+  int clast_arena;  /* 1 to allocate the nodes of a clast in a region owned
+                     * by its root, 0 to allocate them one by one.
+                     */
+  int clast_intern; /* 1 to share structurally equal expressions of a clast,
+                     * 0 to give each use its own copy.
+                     */
+  int hoist;        /* 1 to hoist loop-invariant bounds into temporaries
+                     * when pretty printing, 0 otherwise.
+                     */
+  int split_minmax; /* Maximal number of pieces a loop is split into to
+                     * avoid minima and maxima in the bounds of its inner
+                     * loops, 0 or 1 for no splitting.
+                     */
+  int report_guards; /* 1 to report the modulo guards that could not be
+                      * folded into a loop stride, 0 otherwise.
+                      */
+  int fold_guards;  /* 1 to fold the modulo guards on an iterator into the
+                     * stride of its loop even without strides, 0 otherwise.
+                     */
+  int full_tiles;   /* Level of the loops whose full tiles are separated
+                     * from the partial ones, 0 for no separation.
+                     */
 
   /* OPTIONS FOR PRETTY PRINTING */
   int esp ;       /* 1 if user wants to spread all equalities, i.e. when there
@@ -95,18 +130,42 @@ struct cloogoptions
                    * preprocessing, 0 otherwise.
                    */
   int language;   /* 1 to generate FORTRAN, 0 for C otherwise. */
+  int omp_collapse; /* Maximal number of perfectly nested OpenMP parallel
+                     * loops collapsed together, 0 or 1 for no collapse.
+                     */
+  int omp_schedule; /* Chunk size of the dynamic schedule of the OpenMP
+                     * parallel loops with unbalanced iterations, -1 for a
+                     * guided schedule, 0 for the default schedule.
+                     */
+  int omp_simd;     /* 1 to use "omp simd" for vector loops, n > 1 to also
+                     * set safelen(n) on unit stride loops, 0 for ivdep.
+                     */
+  int unroll_jam;   /* Unroll-and-jam factor of the loops marked with
+                     * CLAST_UNROLL_JAM in the OpenScop loop extension,
+                     * 0 or 1 for no unroll-and-jam.
+                     */
+  int iterator_type; /* Type of the iterators in the generated code: always
+                      * int, always long long, or long long only for those
+                      * not provably within the range of int (auto).
+                      */
 
   int save_domains;/* Save unsimplified copy of domain. */
 
   /* MISC OPTIONS */
   char * name ;   /* Name of the input file. */
   float time ;    /* Time spent for code generation in seconds. */
+  double deadline_start; /* Date of the start of code generation in seconds. */
+  int *degraded;  /* Depths where loops were merged because of the deadline. */
+  int nb_degraded;/* Size of the degraded array. */
   int openscop;   /* 1 if the input file has OpenScop format, 0 otherwise. */
   struct osl_scop *scop; /* Input OpenScop scop if any, NULL otherwise. */
 #ifdef CLOOG_MEMORY
   int memory ;    /* Memory spent for code generation in kilobytes. */
 #endif
   int quiet;      /* Don't print any informational messages. */
+  int stats;      /* 1 to print the statistics collected in the CloogState
+                   * as JSON on the standard error, 0 otherwise.
+                   */
   /* UNDOCUMENTED OPTIONS FOR THE AUTHOR ONLY */
   int leaks ;     /* 1 if I want to print the allocation statistics,
                    * 0 otherwise.
@@ -54,6 +54,10 @@ extern "C"
 #define CLOOG_LANGUAGE_C 0
 #define CLOOG_LANGUAGE_FORTRAN 1
 
+#define CLOOG_ITERATOR_INT 0
+#define CLOOG_ITERATOR_LONG 1
+#define CLOOG_ITERATOR_AUTO 2
+
 /******************************************************************************
  *                          Structure display function                        *
  ******************************************************************************/
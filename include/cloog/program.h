@@ -65,6 +65,11 @@ struct cloogprogram
   int * scaldims ;             /**< Boolean array saying whether a given
                                 *   scattering dimension is scalar or not.
 				*/
+  int * long_dims ;            /**< Boolean array saying whether a given
+                                *   non scalar scattering dimension, then
+                                *   iterator, then parameter, needs a long
+                                *   long type.
+                                */
   /* Library user reserved field. */
   void * usr;		       /**< User field, for library user convenience.
 			        *   This pointer is not freed when the
@@ -3,11 +3,82 @@
 
 struct cloogbackend;
 typedef struct cloogbackend CloogBackend;
+struct cloog_pool;
 
 #if defined(__cplusplus)
 extern "C" {
 #endif 
 
+/* Phases of code generation whose duration is measured. */
+enum cloog_phase {
+  CLOOG_PHASE_READ,
+  CLOOG_PHASE_SCATTER,
+  CLOOG_PHASE_BLOCK,
+  CLOOG_PHASE_SEPARATE,
+  CLOOG_PHASE_MERGE,
+  CLOOG_PHASE_SORT,
+  CLOOG_PHASE_COMPONENTS,
+  CLOOG_PHASE_SIMPLIFY,
+  CLOOG_PHASE_CLAST,
+  CLOOG_PHASE_PPRINT,
+  CLOOG_NB_PHASES
+};
+
+/* Domain primitives of the backend whose calls are counted. */
+enum cloog_primitive {
+  CLOOG_PRIM_CONVEX,
+  CLOOG_PRIM_SIMPLE_CONVEX,
+  CLOOG_PRIM_SIMPLIFY,
+  CLOOG_PRIM_UNION,
+  CLOOG_PRIM_INTERSECTION,
+  CLOOG_PRIM_DIFFERENCE,
+  CLOOG_PRIM_SORT,
+  CLOOG_PRIM_FOLLOWS,
+  CLOOG_PRIM_IS_BOUNDED,
+  CLOOG_PRIM_LEVEL_BOUNDS,
+  CLOOG_PRIM_ISEMPTY,
+  CLOOG_PRIM_PROJECT,
+  CLOOG_PRIM_EXTEND,
+  CLOOG_PRIM_NEVER_INTEGRAL,
+  CLOOG_PRIM_IS_OTL,
+  CLOOG_PRIM_STRIDE,
+  CLOOG_PRIM_CAN_STRIDE,
+  CLOOG_PRIM_STRIDE_LOWER_BOUND,
+  CLOOG_PRIM_ADD_STRIDE_CONSTRAINT,
+  CLOOG_PRIM_LAZY_EQUAL,
+  CLOOG_PRIM_BOUND_SPLITTER,
+  CLOOG_PRIM_LAZY_DISJOINT,
+  CLOOG_PRIM_SIMPLIFY_UNION,
+  CLOOG_PRIM_LAZY_ISCONSTANT,
+  CLOOG_PRIM_SCATTER,
+  CLOOG_PRIM_CAN_UNROLL,
+  CLOOG_PRIM_FIXED_OFFSET,
+  CLOOG_PRIM_MINMAX_SPLITTER,
+  CLOOG_PRIM_FULL_TILES,
+  CLOOG_NB_PRIMITIVES
+};
+
+/* Performance statistics collected during code generation.
+ * phase_calls[p] is the number of times phase p has been entered and
+ * phase_time[p] the wall clock time spent in it (in seconds, nested
+ * entries of the same phase being counted once).
+ * primitive_calls[p] is the number of calls to domain primitive p.
+ */
+struct cloogstats {
+  int phase_calls[CLOOG_NB_PHASES];
+  double phase_time[CLOOG_NB_PHASES];
+  int primitive_calls[CLOOG_NB_PRIMITIVES];
+};
+typedef struct cloogstats CloogStats;
+
+/* Structures of fixed size that can be allocated from the node pool. */
+enum cloog_node {
+  CLOOG_NODE_LOOP,
+  CLOOG_NODE_BLOCK,
+  CLOOG_NODE_STATEMENT,
+  CLOOG_NB_NODES
+};
+
 struct cloogstate {
   CloogBackend *backend;
 
@@ -30,6 +101,26 @@ struct cloogstate {
   int statement_allocated;
   int statement_freed;
   int statement_max;
+
+  int domain_cache_hits;
+  int domain_cache_misses;
+
+  int components_edges;
+  int components_tests;
+  int components_avoided;
+
+  CloogStats stats;
+  int stats_enabled;    /* Count the calls to the domain primitives. */
+  int phase_depth[CLOOG_NB_PHASES];
+  double phase_start[CLOOG_NB_PHASES];
+
+  FILE *trace;          /* Chrome trace event output, NULL if not tracing. */
+  int trace_events;     /* Number of events written to trace. */
+  double trace_start;   /* Date at which trace was set, in seconds. */
+
+  struct cloog_pool *pool; /* One pool per enum cloog_node, NULL if the
+                            * nodes are allocated with malloc.
+                            */
 };
 typedef struct cloogstate CloogState;
 
@@ -39,6 +130,28 @@ CloogState *cloog_state_malloc(void);
 void cloog_core_state_free(CloogState *state);
 void cloog_state_free(CloogState *state);
 
+void cloog_state_set_domain_cache(CloogState *state, int size);
+void cloog_state_set_stats(CloogState *state, int enable);
+
+void cloog_state_phase_start(CloogState *state, enum cloog_phase phase);
+void cloog_state_phase_end(CloogState *state, enum cloog_phase phase);
+const CloogStats *cloog_state_get_stats(CloogState *state);
+const char *cloog_phase_name(enum cloog_phase phase);
+const char *cloog_primitive_name(enum cloog_primitive primitive);
+void cloog_state_print_stats_json(FILE *file, CloogState *state);
+
+void cloog_state_set_trace(CloogState *state, FILE *file);
+void cloog_state_trace_begin(CloogState *state, const char *name,
+			     const char *format, ...);
+void cloog_state_trace_end(CloogState *state, const char *name);
+
+int cloog_state_set_node_pool(CloogState *state, int use);
+void *cloog_state_node_alloc(CloogState *state, enum cloog_node kind,
+			     size_t size);
+void cloog_state_node_free(CloogState *state, enum cloog_node kind,
+			   void *node);
+void cloog_state_node_pool_release(CloogState *state);
+
 #if defined(__cplusplus)
 }
 #endif 
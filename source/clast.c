@@ -2,6 +2,8 @@
 #include <string.h>
 #include <assert.h>
 #include <stdint.h>
+#include <limits.h>
+#include <math.h>
 #include "../include/cloog/cloog.h"
 
 #define ALLOC(type) (type*)malloc(sizeof(type))
@@ -26,6 +28,12 @@ struct clooginfos {
   CloogNames * names ;       /**< Names of iterators and parameters. */
   CloogOptions * options ;   /**< Options on CLooG's behaviour. */
   CloogEqualities *equal;    /**< Matrix of equalities. */
+  struct clast_arena *arena; /**< Region in which the nodes are allocated,
+                              *   NULL to allocate them with malloc.
+                              */
+  struct clast_intern *intern; /**< Table in which the expressions are
+                              *   interned, NULL to leave them unshared.
+                              */
 } ;
 
 typedef struct clooginfos CloogInfos ;
@@ -36,7 +44,10 @@ static int clast_binary_cmp(struct clast_binary *b1, struct clast_binary *b2);
 static int clast_reduction_cmp(struct clast_reduction *r1, 
 				 struct clast_reduction *r2);
 
-static struct clast_expr *clast_expr_copy(struct clast_expr *e);
+static struct clast_expr *clast_expr_copy(CloogInfos *infos,
+					  struct clast_expr *e);
+static struct clast_expr *bound_from_constraint(CloogInfos *infos,
+	CloogConstraint *constraint, int level, CloogNames *names);
 
 static int clast_equal_add(CloogEqualities *equal,
 				CloogConstraintSet *constraints,
@@ -70,44 +81,515 @@ static int concat_if_new(void **list1, int num1, void *list2, int num2,
     int size);
 static int list_compare(const int *list1, int num1, const int *list2, int num2);
 
-static void unroll_jam (struct clast_stmt *s, struct clast_stmt *prev);
-static struct clast_stmt* clast_ast_dup(struct clast_stmt *s);
-struct clast_name *new_clast_name(const char *name)
+static void unroll_jam(CloogInfos *infos, struct clast_stmt *s,
+	struct clast_stmt *prev);
+static struct clast_stmt* clast_ast_dup(CloogInfos *infos,
+	struct clast_stmt *s);
+static struct clast_for *clast_for_copy(CloogInfos *infos, struct clast_for *f);
+/* Region from which all the nodes of a clast are allocated when the
+ * clast_arena option is set.  It is made of chunks of growing size and is
+ * released in one go with the root of the clast, without walking the clast.
+ * Nodes allocated in the region are marked, such that freeing them
+ * does nothing.  The resources the nodes hold outside of the region
+ * (domains, GMP integers, the strings of the clast_for nodes, which may be
+ * set by the user, and the nodes allocated with malloc that the user
+ * has attached to the clast through clast_root_adopt_stmt or
+ * clast_root_adopt_expr) are recorded in the cleanup list of the region.
+ */
+#define CLAST_ARENA_MIN_CHUNK	4096
+#define CLAST_ARENA_MAX_CHUNK	(1 << 20)
+
+union clast_arena_align {
+    void *p;
+    double d;
+    long long l;
+};
+
+union clast_arena_chunk {
+    union clast_arena_chunk *next;
+    union clast_arena_align align;
+};
+
+struct clast_arena_cleanup {
+    void (*fn)(void *);
+    void *p;
+    struct clast_arena_cleanup *next;
+};
+
+struct clast_arena {
+    union clast_arena_chunk *chunks;
+    char *pos;
+    size_t left;
+    size_t chunk_size;
+    struct clast_arena_cleanup *cleanup;
+};
+
+static struct clast_arena *clast_arena_new(void)
+{
+    struct clast_arena *arena = ALLOC(struct clast_arena);
+    if (!arena)
+	cloog_die("memory overflow.\n");
+    arena->chunks = NULL;
+    arena->pos = NULL;
+    arena->left = 0;
+    arena->chunk_size = CLAST_ARENA_MIN_CHUNK / 2;
+    arena->cleanup = NULL;
+    return arena;
+}
+
+static void *clast_arena_alloc(struct clast_arena *arena, size_t size)
+{
+    size_t align = sizeof(union clast_arena_align);
+    void *p;
+
+    size = (size + align - 1) / align * align;
+    if (size > arena->left) {
+	union clast_arena_chunk *chunk;
+	size_t n;
+
+	if (arena->chunk_size < CLAST_ARENA_MAX_CHUNK)
+	    arena->chunk_size *= 2;
+	n = size > arena->chunk_size ? size : arena->chunk_size;
+	chunk = malloc(sizeof(union clast_arena_chunk) + n);
+	if (!chunk)
+	    cloog_die("memory overflow.\n");
+	chunk->next = arena->chunks;
+	arena->chunks = chunk;
+	arena->pos = (char *)(chunk + 1);
+	arena->left = n;
+    }
+    p = arena->pos;
+    arena->pos += size;
+    arena->left -= size;
+    return p;
+}
+
+/* Call "fn" on "p" when "arena" is released. */
+static void clast_arena_defer(struct clast_arena *arena,
+			      void (*fn)(void *), void *p)
+{
+    struct clast_arena_cleanup *c;
+
+    c = clast_arena_alloc(arena, sizeof(*c));
+    c->fn = fn;
+    c->p = p;
+    c->next = arena->cleanup;
+    arena->cleanup = c;
+}
+
+static void clast_arena_free(struct clast_arena *arena)
+{
+    struct clast_arena_cleanup *c;
+    union clast_arena_chunk *chunk, *next;
+
+    if (!arena)
+	return;
+    for (c = arena->cleanup; c; c = c->next)
+	c->fn(c->p);
+    for (chunk = arena->chunks; chunk; chunk = next) {
+	next = chunk->next;
+	free(chunk);
+    }
+    free(arena);
+}
+
+/* The arena in which the nodes built with "infos" are allocated, if any.
+ * The nodes built by the new_clast_* functions, without infos,
+ * are allocated with malloc.
+ */
+static struct clast_arena *clast_infos_arena(CloogInfos *infos)
+{
+    return infos ? infos->arena : NULL;
+}
+
+/* Allocate a node of "size" bytes in the arena of "infos", if any. */
+static void *clast_alloc(CloogInfos *infos, size_t size)
+{
+    if (clast_infos_arena(infos))
+	return clast_arena_alloc(infos->arena, size);
+    return malloc(size);
+}
+
+static void clast_cleanup_domain(void *p)
+{
+    cloog_domain_free((CloogDomain *)p);
+}
+
+/* Copy "domain", making sure the copy is freed with the arena of "infos". */
+static CloogDomain *clast_domain_copy(CloogInfos *infos, CloogDomain *domain)
+{
+    if (!domain)
+	return NULL;
+    domain = cloog_domain_copy(domain);
+    if (clast_infos_arena(infos))
+	clast_arena_defer(infos->arena, &clast_cleanup_domain, domain);
+    return domain;
+}
+
+#if defined(CLOOG_INT_GMP)
+static void clast_cleanup_int(void *p)
+{
+    cloog_int_clear(*(cloog_int_t *)p);
+}
+
+#define clast_arena_defer_int(infos, i)					\
+    do {								\
+	if (clast_infos_arena(infos))					\
+	    clast_arena_defer((infos)->arena,				\
+			      &clast_cleanup_int, &(i));		\
+    } while (0)
+#else
+#define clast_arena_defer_int(infos, i)
+#endif
+
+/* Copy the list of statements "source", in the arena of "infos" if any. */
+static CloogStatement *clast_statement_copy(CloogInfos *infos,
+					    CloogStatement *source)
+{
+    CloogStatement *res = NULL;
+    CloogStatement **next = &res;
+
+    if (!clast_infos_arena(infos))
+	return cloog_statement_copy(source);
+
+    for (; source; source = source->next) {
+	*next = clast_arena_alloc(infos->arena, sizeof(CloogStatement));
+	(*next)->state = source->state;
+	(*next)->number = source->number;
+	(*next)->name = NULL;
+	if (source->name) {
+	    (*next)->name = clast_arena_alloc(infos->arena,
+					      strlen(source->name) + 1);
+	    strcpy((*next)->name, source->name);
+	}
+	(*next)->usr = source->usr;
+	(*next)->next = NULL;
+	next = &(*next)->next;
+    }
+    return res;
+}
+
+/* Table of the expressions of a clast that are shared when the
+ * clast_intern option is set.  Expressions are interned bottom-up,
+ * such that two interned expressions are structurally equal (in the sense
+ * of clast_expr_cmp) if and only if they are the same instance.
+ * In particular, reductions with a single element are identified
+ * irrespective of their type, as clast_expr_cmp and the printers do.
+ * The table holds a reference to each of its expressions until the root
+ * of the clast is freed.  Interned expressions must not be modified.
+ */
+struct clast_intern {
+    int size;
+    int n;
+    struct clast_expr **entry;
+};
+
+static struct clast_intern *clast_intern_new(void)
+{
+    int i;
+    struct clast_intern *table = ALLOC(struct clast_intern);
+    if (!table)
+	cloog_die("memory overflow.\n");
+    table->size = 256;
+    table->n = 0;
+    table->entry = ALLOCN(struct clast_expr *, table->size);
+    if (!table->entry)
+	cloog_die("memory overflow.\n");
+    for (i = 0; i < table->size; ++i)
+	table->entry[i] = NULL;
+    return table;
+}
+
+/* Free "table".  The references it holds only need to be released
+ * if the expressions are not allocated in an arena.
+ */
+static void clast_intern_free(struct clast_intern *table, int arena)
+{
+    int i;
+
+    if (!table)
+	return;
+    for (i = 0; !arena && i < table->size; ++i) {
+	struct clast_expr *e = table->entry[i];
+	if (!e)
+	    continue;
+	e->intern = NULL;
+	free_clast_expr(e);
+    }
+    free(table->entry);
+    free(table);
+}
+
+static unsigned long clast_int_hash(cloog_int_t i)
+{
+#if defined(CLOOG_INT_GMP)
+    return cloog_int_get_si(i);
+#else
+    return (unsigned long) i;
+#endif
+}
+
+/* Hash of "e", whose subexpressions are interned. */
+static unsigned long clast_expr_hash(struct clast_expr *e)
+{
+    unsigned long h = e->type;
+    int i;
+
+    switch (e->type) {
+    case clast_expr_name: {
+	const char *s;
+	for (s = ((struct clast_name *) e)->name; *s; ++s)
+	    h = 31 * h + (unsigned char) *s;
+	break;
+    }
+    case clast_expr_term: {
+	struct clast_term *t = (struct clast_term *) e;
+	h = 31 * h + clast_int_hash(t->val);
+	h = 31 * h + (uintptr_t) t->var;
+	break;
+    }
+    case clast_expr_bin: {
+	struct clast_binary *b = (struct clast_binary *) e;
+	h = 31 * h + b->type;
+	h = 31 * h + clast_int_hash(b->RHS);
+	h = 31 * h + (uintptr_t) b->LHS;
+	break;
+    }
+    case clast_expr_red: {
+	struct clast_reduction *r = (struct clast_reduction *) e;
+	h = 31 * h + r->n;
+	if (r->n != 1)
+	    h = 31 * h + r->type;
+	for (i = 0; i < r->n; ++i)
+	    h = 31 * h + (uintptr_t) r->elts[i];
+	break;
+    }
+    }
+    return h ^ (h >> 16);
+}
+
+/* Are "e1" and "e2", whose subexpressions are interned, equal? */
+static int clast_expr_shallow_equal(struct clast_expr *e1,
+				    struct clast_expr *e2)
+{
+    int i;
+
+    if (e1->type != e2->type)
+	return 0;
+    switch (e1->type) {
+    case clast_expr_name: {
+	struct clast_name *n1 = (struct clast_name *) e1;
+	struct clast_name *n2 = (struct clast_name *) e2;
+	return n1->name == n2->name || !strcmp(n1->name, n2->name);
+    }
+    case clast_expr_term: {
+	struct clast_term *t1 = (struct clast_term *) e1;
+	struct clast_term *t2 = (struct clast_term *) e2;
+	return t1->var == t2->var && cloog_int_eq(t1->val, t2->val);
+    }
+    case clast_expr_bin: {
+	struct clast_binary *b1 = (struct clast_binary *) e1;
+	struct clast_binary *b2 = (struct clast_binary *) e2;
+	return b1->type == b2->type && b1->LHS == b2->LHS &&
+	       cloog_int_eq(b1->RHS, b2->RHS);
+    }
+    case clast_expr_red: {
+	struct clast_reduction *r1 = (struct clast_reduction *) e1;
+	struct clast_reduction *r2 = (struct clast_reduction *) e2;
+	if (r1->n != r2->n)
+	    return 0;
+	if (r1->n != 1 && r1->type != r2->type)
+	    return 0;
+	for (i = 0; i < r1->n; ++i)
+	    if (r1->elts[i] != r2->elts[i])
+		return 0;
+	return 1;
+    }
+    }
+    return 0;
+}
+
+static void clast_intern_grow(struct clast_intern *table)
+{
+    int i, j;
+    int size = table->size;
+    struct clast_expr **entry = table->entry;
+
+    table->size *= 2;
+    table->entry = ALLOCN(struct clast_expr *, table->size);
+    if (!table->entry)
+	cloog_die("memory overflow.\n");
+    for (i = 0; i < table->size; ++i)
+	table->entry[i] = NULL;
+    for (i = 0; i < size; ++i) {
+	if (!entry[i])
+	    continue;
+	j = clast_expr_hash(entry[i]) & (table->size - 1);
+	while (table->entry[j])
+	    j = (j + 1) & (table->size - 1);
+	table->entry[j] = entry[i];
+    }
+    free(entry);
+}
+
+/* Return the instance of "e" in the table of "infos", taking over
+ * the reference to "e".  The subexpressions of "e" are interned first.
+ * Without table, "e" is returned unchanged.
+ */
+static struct clast_expr *clast_expr_intern(CloogInfos *infos,
+					    struct clast_expr *e)
+{
+    struct clast_intern *table = infos->intern;
+    int i, j;
+
+    if (!table || !e || e->intern)
+	return e;
+
+    switch (e->type) {
+    case clast_expr_name:
+	break;
+    case clast_expr_term: {
+	struct clast_term *t = (struct clast_term *) e;
+	t->var = clast_expr_intern(infos, t->var);
+	break;
+    }
+    case clast_expr_bin: {
+	struct clast_binary *b = (struct clast_binary *) e;
+	b->LHS = clast_expr_intern(infos, b->LHS);
+	break;
+    }
+    case clast_expr_red: {
+	struct clast_reduction *r = (struct clast_reduction *) e;
+	for (i = 0; i < r->n; ++i)
+	    r->elts[i] = clast_expr_intern(infos, r->elts[i]);
+	break;
+    }
+    }
+
+    j = clast_expr_hash(e) & (table->size - 1);
+    for (; table->entry[j]; j = (j + 1) & (table->size - 1)) {
+	struct clast_expr *f = table->entry[j];
+	if (clast_expr_shallow_equal(e, f)) {
+	    f->ref++;
+	    free_clast_expr(e);
+	    return f;
+	}
+    }
+
+    if (2 * (table->n + 1) > table->size) {
+	clast_intern_grow(table);
+	j = clast_expr_hash(e) & (table->size - 1);
+	while (table->entry[j])
+	    j = (j + 1) & (table->size - 1);
+    }
+    table->entry[j] = e;
+    table->n++;
+    e->intern = table;
+    e->ref++;
+    return e;
+}
+
+/* Intern the expressions of the statement list "s". */
+static void clast_stmt_intern(CloogInfos *infos, struct clast_stmt *s)
+{
+    int i;
+
+    for (; s; s = s->next) {
+	if (CLAST_STMT_IS_A(s, stmt_ass)) {
+	    struct clast_assignment *a = (struct clast_assignment *) s;
+	    a->RHS = clast_expr_intern(infos, a->RHS);
+	} else if (CLAST_STMT_IS_A(s, stmt_user)) {
+	    clast_stmt_intern(infos, ((struct clast_user_stmt *) s)->substitutions);
+	} else if (CLAST_STMT_IS_A(s, stmt_block)) {
+	    clast_stmt_intern(infos, ((struct clast_block *) s)->body);
+	} else if (CLAST_STMT_IS_A(s, stmt_for)) {
+	    struct clast_for *f = (struct clast_for *) s;
+	    f->LB = clast_expr_intern(infos, f->LB);
+	    f->UB = clast_expr_intern(infos, f->UB);
+	    clast_stmt_intern(infos, f->body);
+	} else if (CLAST_STMT_IS_A(s, stmt_guard)) {
+	    struct clast_guard *g = (struct clast_guard *) s;
+	    for (i = 0; i < g->n; ++i) {
+		g->eq[i].LHS = clast_expr_intern(infos, g->eq[i].LHS);
+		g->eq[i].RHS = clast_expr_intern(infos, g->eq[i].RHS);
+	    }
+	    clast_stmt_intern(infos, g->then);
+	}
+    }
+}
+
+/* The nodes are allocated in the arena of "infos", if any.
+ * The new_clast_* functions allocate them with malloc.
+ */
+static struct clast_name *alloc_clast_name(CloogInfos *infos, const char *name)
 {
-    struct clast_name *n = malloc(sizeof(struct clast_name));
+    struct clast_name *n = clast_alloc(infos, sizeof(struct clast_name));
     n->expr.type = clast_expr_name;
+    n->expr.arena = clast_infos_arena(infos) != NULL;
+    n->expr.ref = 1;
+    n->expr.intern = NULL;
     n->name = name;
     return n;
 }
 
-struct clast_term *new_clast_term(cloog_int_t c, struct clast_expr *v)
+struct clast_name *new_clast_name(const char *name)
+{
+    return alloc_clast_name(NULL, name);
+}
+
+static struct clast_term *alloc_clast_term(CloogInfos *infos, cloog_int_t c,
+	struct clast_expr *v)
 {
-    struct clast_term *t = malloc(sizeof(struct clast_term));
+    struct clast_term *t = clast_alloc(infos, sizeof(struct clast_term));
     t->expr.type = clast_expr_term;
+    t->expr.arena = clast_infos_arena(infos) != NULL;
+    t->expr.ref = 1;
+    t->expr.intern = NULL;
     cloog_int_init(t->val);
     cloog_int_set(t->val, c);
+    clast_arena_defer_int(infos, t->val);
     t->var = v;
     return t;
 }
 
-struct clast_binary *new_clast_binary(enum clast_bin_type t, 
-				      struct clast_expr *lhs, cloog_int_t rhs)
+struct clast_term *new_clast_term(cloog_int_t c, struct clast_expr *v)
 {
-    struct clast_binary *b = malloc(sizeof(struct clast_binary));
+    return alloc_clast_term(NULL, c, v);
+}
+
+static struct clast_binary *alloc_clast_binary(CloogInfos *infos,
+	enum clast_bin_type t, struct clast_expr *lhs, cloog_int_t rhs)
+{
+    struct clast_binary *b = clast_alloc(infos, sizeof(struct clast_binary));
     b->expr.type = clast_expr_bin;
+    b->expr.arena = clast_infos_arena(infos) != NULL;
+    b->expr.ref = 1;
+    b->expr.intern = NULL;
     b->type = t;
     b->LHS = lhs;
     cloog_int_init(b->RHS);
     cloog_int_set(b->RHS, rhs);
+    clast_arena_defer_int(infos, b->RHS);
     return b;
 }
 
-struct clast_reduction *new_clast_reduction(enum clast_red_type t, int n)
+struct clast_binary *new_clast_binary(enum clast_bin_type t, 
+				      struct clast_expr *lhs, cloog_int_t rhs)
+{
+    return alloc_clast_binary(NULL, t, lhs, rhs);
+}
+
+static struct clast_reduction *alloc_clast_reduction(CloogInfos *infos,
+	enum clast_red_type t, int n)
 {
     int i;
     struct clast_reduction *r;
-    r = malloc(sizeof(struct clast_reduction)+(n-1)*sizeof(struct clast_expr *));
+    r = clast_alloc(infos, sizeof(struct clast_reduction) +
+			   (n-1) * sizeof(struct clast_expr *));
     r->expr.type = clast_expr_red;
+    r->expr.arena = clast_infos_arena(infos) != NULL;
+    r->expr.ref = 1;
+    r->expr.intern = NULL;
     r->type = t;
     r->n = n;
     for (i = 0; i < n; ++i)
@@ -115,6 +597,11 @@ struct clast_reduction *new_clast_reduction(enum clast_red_type t, int n)
     return r;
 }
 
+struct clast_reduction *new_clast_reduction(enum clast_red_type t, int n)
+{
+    return alloc_clast_reduction(NULL, t, n);
+}
+
 static void free_clast_root(struct clast_stmt *s);
 
 const struct clast_stmt_op stmt_root = { free_clast_root };
@@ -122,17 +609,31 @@ const struct clast_stmt_op stmt_root = { free_clast_root };
 static void free_clast_root(struct clast_stmt *s)
 {
     struct clast_root *r = (struct clast_root *)s;
+    int i;
     assert(CLAST_STMT_IS_A(s, stmt_root));
     cloog_names_free(r->names);
+    clast_intern_free(r->intern, r->arena != NULL);
+    clast_arena_free(r->arena);
+    for (i = 0; i < r->nb_temporaries; ++i)
+	free(r->temporaries[i]);
+    free(r->temporaries);
     free(r);
 }
 
+/* The root is never allocated in an arena, since it owns the arena
+ * of the clast, if any.
+ */
 struct clast_root *new_clast_root(CloogNames *names)
 {
     struct clast_root *r = malloc(sizeof(struct clast_root));
     r->stmt.op = &stmt_root;
     r->stmt.next = NULL;
+    r->stmt.arena = 0;
     r->names = cloog_names_copy(names);
+    r->arena = NULL;
+    r->intern = NULL;
+    r->nb_temporaries = 0;
+    r->temporaries = NULL;
     return r;
 }
 
@@ -144,21 +645,31 @@ static void free_clast_assignment(struct clast_stmt *s)
 {
     struct clast_assignment *a = (struct clast_assignment *)s;
     assert(CLAST_STMT_IS_A(s, stmt_ass));
+    if (s->arena)
+	return;
     free_clast_expr(a->RHS);
     free(a);
 }
 
-struct clast_assignment *new_clast_assignment(const char *lhs,
-					      struct clast_expr *rhs)
+static struct clast_assignment *alloc_clast_assignment(CloogInfos *infos,
+	const char *lhs, struct clast_expr *rhs)
 {
-    struct clast_assignment *a = malloc(sizeof(struct clast_assignment));
+    struct clast_assignment *a;
+    a = clast_alloc(infos, sizeof(struct clast_assignment));
     a->stmt.op = &stmt_ass;
     a->stmt.next = NULL;
+    a->stmt.arena = clast_infos_arena(infos) != NULL;
     a->LHS = lhs;
     a->RHS = rhs;
     return a;
 }
 
+struct clast_assignment *new_clast_assignment(const char *lhs,
+					      struct clast_expr *rhs)
+{
+    return alloc_clast_assignment(NULL, lhs, rhs);
+}
+
 static void free_clast_user_stmt(struct clast_stmt *s);
 
 const struct clast_stmt_op stmt_user = { free_clast_user_stmt };
@@ -167,24 +678,34 @@ static void free_clast_user_stmt(struct clast_stmt *s)
 {
     struct clast_user_stmt *u = (struct clast_user_stmt *)s;
     assert(CLAST_STMT_IS_A(s, stmt_user));
+    if (s->arena)
+	return;
+    cloog_clast_free(u->substitutions);
     cloog_domain_free(u->domain);
     cloog_statement_free(u->statement);
-    cloog_clast_free(u->substitutions);
     free(u);
 }
 
-struct clast_user_stmt *new_clast_user_stmt(CloogDomain *domain,
-    CloogStatement *stmt, struct clast_stmt *subs)
+static struct clast_user_stmt *alloc_clast_user_stmt(CloogInfos *infos,
+	CloogDomain *domain, CloogStatement *stmt, struct clast_stmt *subs)
 {
-    struct clast_user_stmt *u = malloc(sizeof(struct clast_user_stmt));
+    struct clast_user_stmt *u;
+    u = clast_alloc(infos, sizeof(struct clast_user_stmt));
     u->stmt.op = &stmt_user;
     u->stmt.next = NULL;
-    u->domain = cloog_domain_copy(domain);
-    u->statement = cloog_statement_copy(stmt);
+    u->stmt.arena = clast_infos_arena(infos) != NULL;
+    u->domain = clast_domain_copy(infos, domain);
+    u->statement = clast_statement_copy(infos, stmt);
     u->substitutions = subs;
     return u;
 }
 
+struct clast_user_stmt *new_clast_user_stmt(CloogDomain *domain,
+    CloogStatement *stmt, struct clast_stmt *subs)
+{
+    return alloc_clast_user_stmt(NULL, domain, stmt, subs);
+}
+
 static void free_clast_block(struct clast_stmt *b);
 
 const struct clast_stmt_op stmt_block = { free_clast_block };
@@ -193,47 +714,69 @@ static void free_clast_block(struct clast_stmt *s)
 {
     struct clast_block *b = (struct clast_block *)s;
     assert(CLAST_STMT_IS_A(s, stmt_block));
+    if (s->arena)
+	return;
     cloog_clast_free(b->body);
     free(b);
 }
 
-struct clast_block *new_clast_block()
+static struct clast_block *alloc_clast_block(CloogInfos *infos)
 {
-    struct clast_block *b = malloc(sizeof(struct clast_block));
+    struct clast_block *b = clast_alloc(infos, sizeof(struct clast_block));
     b->stmt.op = &stmt_block;
     b->stmt.next = NULL;
+    b->stmt.arena = clast_infos_arena(infos) != NULL;
     b->body = NULL;
     return b;
 }
 
+struct clast_block *new_clast_block(void)
+{
+    return alloc_clast_block(NULL);
+}
+
 static void free_clast_for(struct clast_stmt *s);
 
 const struct clast_stmt_op stmt_for = { free_clast_for };
 
+/* Free the strings attached to "f", which may have been set by the user. */
+static void clast_for_free_strings(struct clast_for *f)
+{
+    if (f->private_vars) free(f->private_vars);
+    if (f->reduction_vars) free(f->reduction_vars);
+    if (f->time_var_name) free(f->time_var_name);
+    if (f->user_directive) free(f->user_directive);
+}
+
+static void clast_cleanup_for(void *p)
+{
+    clast_for_free_strings((struct clast_for *)p);
+}
+
 static void free_clast_for(struct clast_stmt *s)
 {
     struct clast_for *f = (struct clast_for *)s;
     assert(CLAST_STMT_IS_A(s, stmt_for));
-    cloog_domain_free(f->domain);
+    if (s->arena)
+	return;
     free_clast_expr(f->LB);
     free_clast_expr(f->UB);
-    cloog_int_clear(f->stride);
     cloog_clast_free(f->body);
-    if (f->private_vars) free(f->private_vars);
-    if (f->reduction_vars) free(f->reduction_vars);
-    if (f->time_var_name) free(f->time_var_name);
-    if (f->user_directive) free(f->user_directive);
+    cloog_domain_free(f->domain);
+    cloog_int_clear(f->stride);
+    clast_for_free_strings(f);
     free(f);
 }
 
-struct clast_for *new_clast_for(CloogDomain *domain, const char *it,
-                                struct clast_expr *LB, struct clast_expr *UB,
-                                CloogStride *stride)
+static struct clast_for *alloc_clast_for(CloogInfos *infos, CloogDomain *domain,
+        const char *it, struct clast_expr *LB, struct clast_expr *UB,
+        CloogStride *stride)
 {
-    struct clast_for *f = malloc(sizeof(struct clast_for));
+    struct clast_for *f = clast_alloc(infos, sizeof(struct clast_for));
     f->stmt.op = &stmt_for;
     f->stmt.next = NULL;
-    f->domain = cloog_domain_copy(domain);
+    f->stmt.arena = clast_infos_arena(infos) != NULL;
+    f->domain = clast_domain_copy(infos, domain);
     f->iterator = it;
     f->LB = LB;
     f->UB = UB;
@@ -250,9 +793,19 @@ struct clast_for *new_clast_for(CloogDomain *domain, const char *it,
 	cloog_int_set(f->stride, stride->stride);
     else
 	cloog_int_set_si(f->stride, 1);
+    clast_arena_defer_int(infos, f->stride);
+    if (clast_infos_arena(infos))
+	clast_arena_defer(infos->arena, &clast_cleanup_for, f);
     return f;
 }
 
+struct clast_for *new_clast_for(CloogDomain *domain, const char *it,
+                                struct clast_expr *LB, struct clast_expr *UB,
+                                CloogStride *stride)
+{
+    return alloc_clast_for(NULL, domain, it, LB, UB, stride);
+}
+
 static void free_clast_guard(struct clast_stmt *s);
 
 const struct clast_stmt_op stmt_guard = { free_clast_guard };
@@ -262,6 +815,8 @@ static void free_clast_guard(struct clast_stmt *s)
     int i;
     struct clast_guard *g = (struct clast_guard *)s;
     assert(CLAST_STMT_IS_A(s, stmt_guard));
+    if (s->arena)
+	return;
     cloog_clast_free(g->then);
     for (i = 0; i < g->n; ++i) {
 	free_clast_expr(g->eq[i].LHS);
@@ -270,13 +825,14 @@ static void free_clast_guard(struct clast_stmt *s)
     free(g);
 }
 
-struct clast_guard *new_clast_guard(int n)
+static struct clast_guard *alloc_clast_guard(CloogInfos *infos, int n)
 {
     int i;
-    struct clast_guard *g = malloc(sizeof(struct clast_guard) + 
-				   (n-1) * sizeof(struct clast_equation));
+    struct clast_guard *g = clast_alloc(infos, sizeof(struct clast_guard) + 
+				        (n-1) * sizeof(struct clast_equation));
     g->stmt.op = &stmt_guard;
     g->stmt.next = NULL;
+    g->stmt.arena = clast_infos_arena(infos) != NULL;
     g->then = NULL;
     g->n = n;
     for (i = 0; i < n; ++i) {
@@ -286,28 +842,44 @@ struct clast_guard *new_clast_guard(int n)
     return g;
 }
 
+struct clast_guard *new_clast_guard(int n)
+{
+    return alloc_clast_guard(NULL, n);
+}
+
+/* Shared expressions are only released with their last reference.
+ * The nodes allocated in an arena are only released with the arena.
+ */
 void free_clast_name(struct clast_name *n)
 {
+    if (n->expr.arena || --n->expr.ref > 0)
+	return;
     free(n);
 }
 
 void free_clast_term(struct clast_term *t)
 {
-    cloog_int_clear(t->val);
+    if (t->expr.arena || --t->expr.ref > 0)
+	return;
     free_clast_expr(t->var);
+    cloog_int_clear(t->val);
     free(t);
 }
 
 void free_clast_binary(struct clast_binary *b)
 {
-    cloog_int_clear(b->RHS);
+    if (b->expr.arena || --b->expr.ref > 0)
+	return;
     free_clast_expr(b->LHS);
+    cloog_int_clear(b->RHS);
     free(b);
 }
 
 void free_clast_reduction(struct clast_reduction *r)
 {
     int i;
+    if (r->expr.arena || --r->expr.ref > 0)
+	return;
     for (i = 0; i < r->n; ++i)
 	free_clast_expr(r->elts[i]);
     free(r);
@@ -342,29 +914,69 @@ void free_clast_stmt(struct clast_stmt *s)
     s->op->free(s);
 }
 
+/* The statements following a node allocated in an arena, or a root
+ * with an arena, are released with the arena, so the list is only
+ * walked up to such a statement.
+ */
 void cloog_clast_free(struct clast_stmt *s)
 {
     struct clast_stmt *next;
-    while (s) {
+    while (s && !s->arena) {
 	next = s->next;
+	if (CLAST_STMT_IS_A(s, stmt_root) && ((struct clast_root *)s)->arena)
+	    next = NULL;
 	free_clast_stmt(s);
 	s = next;
     }
 }
 
-static int clast_name_cmp(struct clast_name *n1, struct clast_name *n2)
+static void clast_cleanup_stmt(void *p)
 {
-    return n1->name == n2->name ? 0 : strcmp(n1->name, n2->name);
+    cloog_clast_free((struct clast_stmt *)p);
 }
 
-static int clast_term_cmp(struct clast_term *t1, struct clast_term *t2)
+static void clast_cleanup_expr(void *p)
 {
-    int c;
-    if (!t1->var && t2->var)
-	return -1;
-    if (t1->var && !t2->var)
-	return 1;
-    c = clast_expr_cmp(t1->var, t2->var);
+    free_clast_expr((struct clast_expr *)p);
+}
+
+/* Hand the list of statements "s", allocated with malloc and attached
+ * to the clast rooted at "r", over to "r".  If "r" has an arena,
+ * the statements of the list up to the first one allocated in an arena,
+ * along with the nodes allocated with malloc below them, are freed
+ * when the arena is released.  Otherwise, they are freed along with
+ * the rest of the clast and nothing needs to be done.
+ */
+void clast_root_adopt_stmt(struct clast_root *r, struct clast_stmt *s)
+{
+    if (!r->arena || !s || s->arena)
+	return;
+    clast_arena_defer(r->arena, &clast_cleanup_stmt, s);
+}
+
+/* Hand the reference to "e", allocated with malloc and attached
+ * to the clast rooted at "r", over to "r".
+ */
+void clast_root_adopt_expr(struct clast_root *r, struct clast_expr *e)
+{
+    if (!r->arena || !e || e->arena)
+	return;
+    clast_arena_defer(r->arena, &clast_cleanup_expr, e);
+}
+
+static int clast_name_cmp(struct clast_name *n1, struct clast_name *n2)
+{
+    return n1->name == n2->name ? 0 : strcmp(n1->name, n2->name);
+}
+
+static int clast_term_cmp(struct clast_term *t1, struct clast_term *t2)
+{
+    int c;
+    if (!t1->var && t2->var)
+	return -1;
+    if (t1->var && !t2->var)
+	return 1;
+    c = clast_expr_cmp(t1->var, t2->var);
     if (c)
 	return c;
     return cloog_int_cmp(t1->val, t2->val);
@@ -400,7 +1012,7 @@ static int clast_reduction_cmp(struct clast_reduction *r1, struct clast_reductio
 
 static int clast_expr_cmp(struct clast_expr *e1, struct clast_expr *e2)
 {
-    if (!e1 && !e2)
+    if (e1 == e2)
 	return 0;
     if (!e1)
 	return -1;
@@ -428,6 +1040,11 @@ static int clast_expr_cmp(struct clast_expr *e1, struct clast_expr *e2)
 
 int clast_expr_equal(struct clast_expr *e1, struct clast_expr *e2)
 {
+    if (e1 == e2)
+	return 1;
+    /* Equal expressions interned in the same table are the same instance. */
+    if (e1 && e2 && e1->intern && e1->intern == e2->intern)
+	return 0;
     return clast_expr_cmp(e1, e2) == 0;
 }
 
@@ -497,36 +1114,58 @@ static void clast_guard_sort(struct clast_guard *g)
 /**
  * Construct a (deep) copy of an expression clast.
  */
-static struct clast_expr *clast_expr_copy(struct clast_expr *e)
+static struct clast_expr *clast_expr_copy(CloogInfos *infos,
+	struct clast_expr *e)
 {
     if (!e)
 	return NULL;
+    if (e->intern && infos && e->intern == infos->intern) {
+	e->ref++;
+	return e;
+    }
     switch (e->type) {
     case clast_expr_name: {
 	struct clast_name* n = (struct clast_name*) e;
-	return &new_clast_name(n->name)->expr;
+	return &alloc_clast_name(infos, n->name)->expr;
     }
     case clast_expr_term: {
 	struct clast_term* t = (struct clast_term*) e;
-	return &new_clast_term(t->val, clast_expr_copy(t->var))->expr;
+	return &alloc_clast_term(infos, t->val, clast_expr_copy(infos, t->var))->expr;
     }
     case clast_expr_red: {
 	int i;
 	struct clast_reduction *r = (struct clast_reduction*) e;
-	struct clast_reduction *r2 = new_clast_reduction(r->type, r->n);
+	struct clast_reduction *r2 = alloc_clast_reduction(infos, r->type, r->n);
 	for (i = 0; i < r->n; ++i)
-	    r2->elts[i] = clast_expr_copy(r->elts[i]);
+	    r2->elts[i] = clast_expr_copy(infos, r->elts[i]);
 	return &r2->expr;
     }
     case clast_expr_bin: {
 	struct clast_binary *b = (struct clast_binary*) e;
-	return &new_clast_binary(b->type, clast_expr_copy(b->LHS), b->RHS)->expr;
+	return &alloc_clast_binary(infos, b->type, clast_expr_copy(infos, b->LHS),
+				   b->RHS)->expr;
     }
     default:
 	assert(0);
     }
 }
 
+/* Return the expression of variable "level" in "constraint", allocated
+ * in the arena of "infos", if any.  The backend allocates it with malloc.
+ */
+static struct clast_expr *clast_variable_expr(CloogInfos *infos,
+	CloogConstraint *constraint, int level, CloogNames *names)
+{
+    struct clast_expr *e, *copy;
+
+    e = cloog_constraint_variable_expr(constraint, level, names);
+    if (!clast_infos_arena(infos))
+	return e;
+    copy = clast_expr_copy(infos, e);
+    free_clast_expr(e);
+    return copy;
+}
+
 
 /******************************************************************************
  *                        Equalities spreading functions                      *
@@ -609,13 +1248,13 @@ static struct clast_stmt *clast_equal(int level, CloogInfos *infos)
   for (i=infos->names->nb_scattering;i<level-1;i++)
   { if (cloog_equal_type(equal, i+1)) {
       equal_constraint = cloog_equal_constraint(equal, i);
-      e = clast_bound_from_constraint(equal_constraint, i+1, infos->names);
+      e = bound_from_constraint(infos, equal_constraint, i+1, infos->names);
       cloog_constraint_release(equal_constraint);
     } else {
-      e = &new_clast_term(infos->state->one, &new_clast_name(
+      e = &alloc_clast_term(infos, infos->state->one, &alloc_clast_name(infos, 
 		 cloog_names_name_at_level(infos->names, i+1))->expr)->expr;
     }
-    *next = &new_clast_assignment(NULL, e)->stmt;
+    *next = &alloc_clast_assignment(infos, NULL, e)->stmt;
     next = &(*next)->next;
   }
 
@@ -640,8 +1279,8 @@ static struct clast_stmt *clast_equal(int level, CloogInfos *infos)
  * - November 2nd 2001: first version. 
  * - June    27th 2003: 64 bits version ready.
  */
-struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
-					       int level, CloogNames *names)
+static struct clast_expr *bound_from_constraint(CloogInfos *infos,
+	CloogConstraint *constraint, int level, CloogNames *names)
 { 
   int i, sign, nb_elts=0, len;
   cloog_int_t *line, numerator, denominator, temp, division;
@@ -664,7 +1303,7 @@ struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
     for (i = 1, nb_elts = 0; i <= len - 1; ++i)
 	if (i != level && !cloog_int_is_zero(line[i]))
 	    nb_elts++;
-    r = new_clast_reduction(clast_red_sum, nb_elts);
+    r = alloc_clast_reduction(infos, clast_red_sum, nb_elts);
     nb_elts = 0;
 
     /* First, we have to print the iterators and the parameters. */
@@ -674,14 +1313,14 @@ struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
       if (i == level || cloog_int_is_zero(line[i]))
 	continue;
 
-      v = cloog_constraint_variable_expr(constraint, i, names);
+      v = clast_variable_expr(infos, constraint, i, names);
       
       if (sign == -1)
 	cloog_int_neg(temp,line[i]);
       else
 	cloog_int_set(temp,line[i]);
       
-      r->elts[nb_elts++] = &new_clast_term(temp, v)->expr;
+      r->elts[nb_elts++] = &alloc_clast_term(infos, temp, v)->expr;
     }    
 
     if (sign == -1) {
@@ -696,29 +1335,31 @@ struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
     /* Finally, the constant, and the final printing. */
     if (nb_elts) {
       if (!cloog_int_is_zero(numerator))
-	  r->elts[nb_elts++] = &new_clast_term(numerator, NULL)->expr;
+	  r->elts[nb_elts++] = &alloc_clast_term(infos, numerator, NULL)->expr;
     
       if (!cloog_int_is_one(line[level]) && !cloog_int_is_neg_one(line[level]))
       { if (!cloog_constraint_is_equality(constraint))
         { if (cloog_int_is_pos(line[level]))
-	    e = &new_clast_binary(clast_bin_cdiv, &r->expr, denominator)->expr;
+	    e = &alloc_clast_binary(infos, clast_bin_cdiv, &r->expr,
+				    denominator)->expr;
           else
-	    e = &new_clast_binary(clast_bin_fdiv, &r->expr, denominator)->expr;
+	    e = &alloc_clast_binary(infos, clast_bin_fdiv, &r->expr,
+				    denominator)->expr;
         } else
-	    e = &new_clast_binary(clast_bin_div, &r->expr, denominator)->expr;
+	    e = &alloc_clast_binary(infos, clast_bin_div, &r->expr, denominator)->expr;
       }
       else
 	e = &r->expr;
     } else { 
       free_clast_reduction(r);
       if (cloog_int_is_zero(numerator))
-	e = &new_clast_term(numerator, NULL)->expr;
+	e = &alloc_clast_term(infos, numerator, NULL)->expr;
       else
       { if (!cloog_int_is_one(denominator))
         { if (!cloog_constraint_is_equality(constraint)) { /* useful? */
             if (cloog_int_is_divisible_by(numerator, denominator)) {
               cloog_int_divexact(temp, numerator, denominator);
-	      e = &new_clast_term(temp, NULL)->expr;
+	      e = &alloc_clast_term(infos, temp, NULL)->expr;
             }
             else {
               cloog_int_init(division);
@@ -726,33 +1367,33 @@ struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
 	      if (cloog_int_is_neg(numerator)) {
                 if (cloog_int_is_pos(line[level])) {
 		    /* nb<0 need max */
-		    e = &new_clast_term(division, NULL)->expr;
+		    e = &alloc_clast_term(infos, division, NULL)->expr;
 		} else {
                   /* nb<0 need min */
                   cloog_int_sub_ui(temp, division, 1);
-		  e = &new_clast_term(temp, NULL)->expr;
+		  e = &alloc_clast_term(infos, temp, NULL)->expr;
                 }
 	      }
               else
               { if (cloog_int_is_pos(line[level]))
 	        { /* nb>0 need max */
                   cloog_int_add_ui(temp, division, 1);
-		  e = &new_clast_term(temp, NULL)->expr;
+		  e = &alloc_clast_term(infos, temp, NULL)->expr;
                 }
 		else
 		    /* nb>0 need min */
-		    e = &new_clast_term(division, NULL)->expr;
+		    e = &alloc_clast_term(infos, division, NULL)->expr;
               }
 	      cloog_int_clear(division);
             }
           }
           else
-	    e = &new_clast_binary(clast_bin_div, 
-				  &new_clast_term(numerator, NULL)->expr,
+	    e = &alloc_clast_binary(infos, clast_bin_div, 
+				  &alloc_clast_term(infos, numerator, NULL)->expr,
 				  denominator)->expr;
         }
         else
-	    e = &new_clast_term(numerator, NULL)->expr;
+	    e = &alloc_clast_term(infos, numerator, NULL)->expr;
       }
     }
   }
@@ -766,6 +1407,12 @@ struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
   return e;
 }
 
+struct clast_expr *clast_bound_from_constraint(CloogConstraint *constraint,
+					       int level, CloogNames *names)
+{
+    return bound_from_constraint(NULL, constraint, level, names);
+}
+
 
 /* Temporary structure for communication between clast_minmax and
  * its cloog_constraint_set_foreach_constraint callback functions.
@@ -885,12 +1532,13 @@ static int collect_bounds(CloogConstraint *c, void *user)
     if (d->lower_bound && d->infos->stride[d->level - 1])
 	c = update_lower_bound_c(c, d->level, d->infos->stride[d->level - 1]);
 
-    d->r->elts[d->n] = clast_bound_from_constraint(c, d->level,
-							    d->infos->names);
+    d->r->elts[d->n] = bound_from_constraint(d->infos, c, d->level,
+					     d->infos->names);
     if (d->lower_bound && d->infos->stride[d->level - 1]) {
 	update_lower_bound(d->r->elts[d->n], d->level,
 			   d->infos->stride[d->level - 1]);
     }
+    d->r->elts[d->n] = clast_expr_intern(d->infos, d->r->elts[d->n]);
 
     cloog_constraint_release(c);
 
@@ -937,17 +1585,20 @@ static struct clast_expr *clast_minmax(CloogConstraintSet *constraints,
   
     data.n = 0;
 
-    cloog_constraint_set_foreach_constraint(constraints, count_bounds, &data);
+    cloog_constraint_set_foreach_constraint_involving(constraints, level,
+						      count_bounds, &data);
 
     if (!data.n)
 	return NULL;
-    data.r = new_clast_reduction(max ? clast_red_max : clast_red_min, data.n);
+    data.r = alloc_clast_reduction(infos, max ? clast_red_max : clast_red_min,
+				   data.n);
 
     data.n = 0;
-    cloog_constraint_set_foreach_constraint(constraints, collect_bounds, &data);
+    cloog_constraint_set_foreach_constraint_involving(constraints, level,
+						      collect_bounds, &data);
 
     clast_reduction_sort(data.r);
-    return &data.r->expr;
+    return clast_expr_intern(infos, &data.r->expr);
 }
 
 
@@ -1072,10 +1723,14 @@ static int insert_guard_constraint(CloogConstraint *j, void *user)
 	    return 0;
     }
 
-    v = cloog_constraint_variable_expr(j, d->i, d->infos->names);
-    d->g->eq[d->n].LHS = &(t = new_clast_term(d->infos->state->one, v))->expr;
+    v = clast_variable_expr(d->infos, j, d->i, d->infos->names);
+    d->g->eq[d->n].LHS = &(t = alloc_clast_term(d->infos,
+					       d->infos->state->one, v))->expr;
     if (individual_constraint) {
-	/* put the "denominator" in the LHS */
+	/* put the "denominator" in the LHS, on a private copy of j since
+	 * the constraints of the set are shared.
+	 */
+	j = cloog_constraint_dup(j);
 	cloog_constraint_coefficient_get(j, d->i - 1, &t->val);
 	cloog_constraint_coefficient_set(j, d->i - 1, d->infos->state->one);
 	if (cloog_int_is_neg(t->val)) {
@@ -1088,7 +1743,9 @@ static int insert_guard_constraint(CloogConstraint *j, void *user)
 	    d->g->eq[d->n].sign = 1;
 	else
 	    d->g->eq[d->n].sign = -1;
-	d->g->eq[d->n].RHS = clast_bound_from_constraint(j, d->i, d->infos->names);
+	d->g->eq[d->n].RHS = bound_from_constraint(d->infos, j, d->i,
+						   d->infos->names);
+	cloog_constraint_release(j);
     } else {
 	int guarded;
 
@@ -1142,6 +1799,7 @@ static int insert_guard_constraint(CloogConstraint *j, void *user)
 static void insert_guard(CloogConstraintSet *constraints, int level,
 			 struct clast_stmt ***next, CloogInfos *infos)
 { 
+    int i;
     int total_dim;
     struct clast_guard_data data = {
         .level = level, .infos = infos, .n = 0,
@@ -1157,7 +1815,7 @@ static void insert_guard(CloogConstraintSet *constraints, int level,
     cloog_constraint_set_foreach_constraint(constraints,
 						guard_count_bounds, &data);
   
-    data.g = new_clast_guard(data.n);
+    data.g = alloc_clast_guard(infos, data.n);
     data.n = 0;
 
     /* Well, it looks complicated because I wanted to have a particular, more
@@ -1171,13 +1829,17 @@ static void insert_guard(CloogConstraintSet *constraints, int level,
     for (data.i = 1; data.i <= total_dim; data.i++) {
 	data.min = 0;
 	data.max = 0;
-	cloog_constraint_set_foreach_constraint(data.copy,
+	cloog_constraint_set_foreach_constraint_involving(data.copy, data.i,
 						insert_guard_constraint, &data);
     }
 
     cloog_constraint_set_free(data.copy);
 
     data.g->n = data.n;
+    for (i = 0; i < data.n; ++i) {
+	data.g->eq[i].LHS = clast_expr_intern(infos, data.g->eq[i].LHS);
+	data.g->eq[i].RHS = clast_expr_intern(infos, data.g->eq[i].RHS);
+    }
     if (data.n) {
 	clast_guard_sort(data.g);
 	**next = &data.g->stmt;
@@ -1201,29 +1863,72 @@ static int constant_modulo_guard_is_satisfied(CloogConstraint *lower,
 	return cloog_int_is_zero(cst);
 }
 
+/**
+ * Report the modulo guard "g", required by the equality defining
+ * the iterator at level "level", if the user asked for it.
+ * These are the guards that cloog_loop_stride did not (or, without
+ * -strides or -fold-guards, could not) fold into the stride of
+ * an enclosing loop.  The guard is printed to a temporary file first
+ * so that the whole report goes through a single cloog_msg.
+ */
+static void report_modulo_guard(struct clast_guard *g, int level,
+	CloogInfos *infos)
+{
+    CloogOptions *options = infos->options;
+    struct clast_equation *eq = &g->eq[0];
+    FILE *tmp;
+    char *text;
+    long len;
+
+    if (!options->report_guards || options->quiet)
+	return;
+
+    tmp = tmpfile();
+    if (!tmp)
+	cloog_die("cannot create a temporary file for the guard report.\n");
+    clast_pprint_expr(options, tmp, eq->LHS);
+    fprintf(tmp, eq->sign == 0 ? " == " : " <= ");
+    clast_pprint_expr(options, tmp, eq->RHS);
+    len = ftell(tmp);
+    text = (char *)malloc(len + 1);
+    if (!text)
+	cloog_die("memory overflow.\n");
+    rewind(tmp);
+    len = fread(text, 1, len, tmp);
+    text[len] = '\0';
+    fclose(tmp);
+
+    cloog_msg(options, CLOOG_INFO, "modulo guard for %s not turned into a "
+	    "stride%s: %s\n", cloog_names_name_at_level(infos->names, level),
+	    options->strides || options->fold_guards ? "" :
+		" (-fold-guards is off)", text);
+    free(text);
+}
+
 /**
  * Insert a modulo guard "r % mod == 0" or "r % mod <= bound",
  * depending on whether lower represents a valid constraint.
  */
 static void insert_computed_modulo_guard(struct clast_reduction *r,
 	CloogConstraint *lower, cloog_int_t mod, cloog_int_t bound,
-	struct clast_stmt ***next)
+	int level, struct clast_stmt ***next, CloogInfos *infos)
 {
     struct clast_expr *e;
     struct clast_guard *g;
 
-    e = &new_clast_binary(clast_bin_mod, &r->expr, mod)->expr;
-    g = new_clast_guard(1);
+    e = &alloc_clast_binary(infos, clast_bin_mod, &r->expr, mod)->expr;
+    g = alloc_clast_guard(infos, 1);
     if (!cloog_constraint_is_valid(lower)) {
 	g->eq[0].LHS = e;
 	cloog_int_set_si(bound, 0);
-	g->eq[0].RHS = &new_clast_term(bound, NULL)->expr;
+	g->eq[0].RHS = &alloc_clast_term(infos, bound, NULL)->expr;
 	g->eq[0].sign = 0;
     } else {
 	g->eq[0].LHS = e;
-	g->eq[0].RHS = &new_clast_term(bound, NULL)->expr;
+	g->eq[0].RHS = &alloc_clast_term(infos, bound, NULL)->expr;
 	g->eq[0].sign = -1;
     }
+    report_modulo_guard(g, level, infos);
 
     **next = &g->stmt;
     *next = &g->then;
@@ -1364,7 +2069,7 @@ static int insert_modulo_guard_constraint(CloogConstraint *c, void *user)
 	struct clast_reduction *r;
 	const char *name;
 
-	r = new_clast_reduction(clast_red_sum, nb_elts + 1);
+	r = alloc_clast_reduction(infos, clast_red_sum, nb_elts + 1);
 	nb_elts = 0;
 
 	/* First, the modulo guard : the iterators... */
@@ -1380,8 +2085,8 @@ static int insert_modulo_guard_constraint(CloogConstraint *c, void *user)
 
 	  name = cloog_names_name_at_level(infos->names, i);
 
-	  r->elts[nb_elts++] = &new_clast_term(line[i],
-				    &new_clast_name(name)->expr)->expr;
+	  r->elts[nb_elts++] = &alloc_clast_term(infos, line[i],
+				    &alloc_clast_name(infos, name)->expr)->expr;
 	}
 
 	/* ...the parameters... */
@@ -1390,14 +2095,14 @@ static int insert_modulo_guard_constraint(CloogConstraint *c, void *user)
 	    continue;
 
 	  name = infos->names->parameters[i-nb_iter-1] ;
-	  r->elts[nb_elts++] = &new_clast_term(line[i],
-				    &new_clast_name(name)->expr)->expr;
+	  r->elts[nb_elts++] = &alloc_clast_term(infos, line[i],
+				    &alloc_clast_name(infos, name)->expr)->expr;
 	}
 
 	constant = nb_elts == 0;
 	/* ...the constant. */
 	if (!cloog_int_is_zero(line[len-1]))
-	  r->elts[nb_elts++] = &new_clast_term(line[len-1], NULL)->expr;
+	  r->elts[nb_elts++] = &alloc_clast_term(infos, line[len-1], NULL)->expr;
 
 	/* our initial computation may have been an overestimate */
 	r->n = nb_elts;
@@ -1408,7 +2113,7 @@ static int insert_modulo_guard_constraint(CloogConstraint *c, void *user)
 	  free_clast_reduction(r);
 	} else
 	  insert_computed_modulo_guard(r, d->lower, line[level], d->bound,
-					d->next);
+					level, d->next, d->infos);
     }
 
     cloog_vec_free(line_vector);
@@ -1500,13 +2205,14 @@ static int insert_equation_as_loop(CloogDomain *domain, CloogConstraint *upper,
     struct clast_expr *e1, *e2;
     struct clast_for *f;
 
-    e2 = clast_bound_from_constraint(upper, level, infos->names);
+    e2 = bound_from_constraint(infos, upper, level, infos->names);
     if (!cloog_constraint_is_valid(lower))
-	e1 = clast_expr_copy(e2);
+	e1 = clast_expr_copy(infos, e2);
     else
-	e1 = clast_bound_from_constraint(lower, level, infos->names);
+	e1 = bound_from_constraint(infos, lower, level, infos->names);
 
-    f = new_clast_for(domain, iterator, e1, e2, infos->stride[level-1]);
+    f = alloc_clast_for(infos, domain, iterator, e1, e2,
+			infos->stride[level-1]);
     **next = &f->stmt;
     *next = &f->body;
 
@@ -1566,13 +2272,14 @@ static int insert_equation(CloogDomain *domain, CloogConstraint *upper,
      * for the same following condition to close the brace.
      */
     if (infos->options->block) {
-      struct clast_block *b = new_clast_block();
+      struct clast_block *b = alloc_clast_block(infos);
       **next = &b->stmt;
       *next = &b->body;
     }
 		
-    e = clast_bound_from_constraint(upper, level, infos->names);
-    ass = new_clast_assignment(cloog_names_name_at_level(infos->names, level), e);
+    e = bound_from_constraint(infos, upper, level, infos->names);
+    ass = alloc_clast_assignment(infos,
+		    cloog_names_name_at_level(infos->names, level), e);
 
     **next = &ass->stmt;
     *next = &(**next)->next;
@@ -1610,11 +2317,11 @@ static void insert_otl_for(CloogConstraintSet *constraints, int level,
 				cloog_constraint_invalid(), infos)) {
 	struct clast_assignment *ass;
 	if (infos->options->block) {
-	    struct clast_block *b = new_clast_block();
+	    struct clast_block *b = alloc_clast_block(infos);
 	    **next = &b->stmt;
 	    *next = &b->body;
 	}
-	ass = new_clast_assignment(iterator, e);
+	ass = alloc_clast_assignment(infos, iterator, e);
 	**next = &ass->stmt;
 	*next = &(**next)->next;
     } else {
@@ -1652,18 +2359,18 @@ static void insert_guarded_otl_for(CloogConstraintSet *constraints, int level,
     iterator = cloog_names_name_at_level(infos->names, level);
 
     if (infos->options->block) {
-	struct clast_block *b = new_clast_block();
+	struct clast_block *b = alloc_clast_block(infos);
 	**next = &b->stmt;
 	*next = &b->body;
     }
-    ass = new_clast_assignment(iterator, e1);
+    ass = alloc_clast_assignment(infos, iterator, e1);
     **next = &ass->stmt;
     *next = &(**next)->next;
 
-    guard = new_clast_guard(1);
+    guard = alloc_clast_guard(infos, 1);
     guard->eq[0].sign = -1;
-    guard->eq[0].LHS = &new_clast_term(infos->state->one,
-				       &new_clast_name(iterator)->expr)->expr;
+    guard->eq[0].LHS = &alloc_clast_term(infos, infos->state->one,
+				       &alloc_clast_name(infos, iterator)->expr)->expr;
     guard->eq[0].RHS = e2;
 
     **next = &guard->stmt;
@@ -1720,7 +2427,8 @@ static int insert_for(CloogDomain *domain, CloogConstraintSet *constraints,
     struct clast_for *f;
     iterator = cloog_names_name_at_level(infos->names, level);
 
-    f = new_clast_for(domain, iterator, e1, e2, infos->stride[level-1]);
+    f = alloc_clast_for(infos, domain, iterator, e1, e2,
+			infos->stride[level-1]);
     **next = &f->stmt;
     *next = &f->body;
   }
@@ -1755,62 +2463,26 @@ static void insert_block(CloogDomain *domain, CloogBlock *block, int level,
 	subs = clast_equal(level,infos);
 
 	statement->next = NULL;
-	**next = &new_clast_user_stmt(domain, statement, subs)->stmt;
+	**next = &alloc_clast_user_stmt(infos, domain, statement, subs)->stmt;
 	statement->next = s_next;
 	*next = &(**next)->next;
     }
 }
 
 
-/**
- * insert_loop function:
- * This function converts the content of a CloogLoop structure (loop) into a
- * clast_stmt (inserted at **next).
- * The iterator (level) of
- * the current loop is given by 'level': this is the column number of the
- * domain corresponding to the current loop iterator. The data of a loop are
- * written in this order:
- * 1. The guard of the loop, i.e. each constraint in the domain that does not
- *    depend on the iterator (when the entry in the column 'level' is 0).
- * 2. The iteration domain of the iterator, given by the constraints in the
- *    domain depending on the iterator, i.e.:
- *    * an equality if the iterator has only one value (possibly preceded by
- *      a guard verifying if this value is integral), *OR*
- *    * a loop from the minimum possible value of the iterator to the maximum
- *      possible value.
- * 3. The included statement block.
- * 4. The inner loops (recursive call).
- * 5. The following loops (recursive call).
- * - level is the recursion level or the iteration level that we are printing,
- * - the infos structure gives the user some options about code printing,
- *   the number of parameters in domain (nb_par), and the arrays of iterator
- *   names and parameters (iters and params). 
- **
- * - November   2nd 2001: first version. 
- * - March      6th 2003: infinite domain support. 
- * - April     19th 2003: (debug) NULL loop support. 
- * - June      29th 2003: non-unit strides support.
- * - April     28th 2005: (debug) level is level+equality when print statement!
- * - June      16th 2005: (debug) the N. Vasilache normalization step has been
- *                        added to avoid iteration duplication (see DaeGon Kim
- *                        bug in cloog_program_generate). Try vasilache.cloog
- *                        with and without the call to cloog_polylib_matrix_normalize,
- *                        using -f 8 -l 9 options for an idea.
- * - September 15th 2005: (debug) don't close equality braces when unnecessary.
- * - October   16th 2005: (debug) scalar value is saved for next loops.
+/* Generate the code for the single loop "loop", leaving its siblings
+ * to insert_loop.
  */
-static void insert_loop(CloogLoop * loop, int level,
+static void insert_loop_level(CloogLoop *loop, int level,
 			struct clast_stmt ***next, CloogInfos *infos)
 {
     int equality = 0;
     CloogConstraintSet *constraints, *temp;
-    struct clast_stmt **top = *next;
     CloogConstraint *i, *j;
     int empty_loop = 0;
 
-    /* It can happen that loop be NULL when an input polyhedron is empty. */
-    if (loop == NULL)
-	return;
+    cloog_state_trace_begin(infos->state, "insert_loop", "\"level\": %d",
+			    level);
 
     /* The constraints do not always have a shape that allows us to generate code from it,
     * thus we normalize it, we also simplify it with the equalities.
@@ -1864,11 +2536,318 @@ static void insert_loop(CloogLoop * loop, int level,
     }
     cloog_constraint_set_free(constraints);
 
-    /* Go to the next loop on the same level. */
-    while (*top)
-	top = &(*top)->next;
-    if (loop->next != NULL)
-	insert_loop(loop->next, level, &top,infos);
+    cloog_state_trace_end(infos->state, "insert_loop");
+}
+
+
+/**
+ * insert_loop function:
+ * This function converts the content of a CloogLoop structure (loop) into a
+ * clast_stmt (inserted at **next).
+ * The iterator (level) of
+ * the current loop is given by 'level': this is the column number of the
+ * domain corresponding to the current loop iterator. The data of a loop are
+ * written in this order:
+ * 1. The guard of the loop, i.e. each constraint in the domain that does not
+ *    depend on the iterator (when the entry in the column 'level' is 0).
+ * 2. The iteration domain of the iterator, given by the constraints in the
+ *    domain depending on the iterator, i.e.:
+ *    * an equality if the iterator has only one value (possibly preceded by
+ *      a guard verifying if this value is integral), *OR*
+ *    * a loop from the minimum possible value of the iterator to the maximum
+ *      possible value.
+ * 3. The included statement block.
+ * 4. The inner loops (recursive call).
+ * 5. The following loops, which are walked iteratively such that the depth
+ *    of the recursion is bounded by the depth of the loop nest.
+ * - level is the recursion level or the iteration level that we are printing,
+ * - the infos structure gives the user some options about code printing,
+ *   the number of parameters in domain (nb_par), and the arrays of iterator
+ *   names and parameters (iters and params). 
+ **
+ * - November   2nd 2001: first version. 
+ * - March      6th 2003: infinite domain support. 
+ * - April     19th 2003: (debug) NULL loop support. 
+ * - June      29th 2003: non-unit strides support.
+ * - April     28th 2005: (debug) level is level+equality when print statement!
+ * - June      16th 2005: (debug) the N. Vasilache normalization step has been
+ *                        added to avoid iteration duplication (see DaeGon Kim
+ *                        bug in cloog_program_generate). Try vasilache.cloog
+ *                        with and without the call to cloog_polylib_matrix_normalize,
+ *                        using -f 8 -l 9 options for an idea.
+ * - September 15th 2005: (debug) don't close equality braces when unnecessary.
+ * - October   16th 2005: (debug) scalar value is saved for next loops.
+ */
+static void insert_loop(CloogLoop * loop, int level,
+			struct clast_stmt ***next, CloogInfos *infos)
+{
+    struct clast_stmt **top = *next;
+
+    /* It can happen that loop be NULL when an input polyhedron is empty. */
+    for (; loop; loop = loop->next) {
+	struct clast_stmt **pos = top;
+
+	insert_loop_level(loop, level, &pos, infos);
+
+	/* Go to the next loop on the same level. */
+	while (*top)
+	    top = &(*top)->next;
+    }
+}
+
+
+/**
+ * The range of the values an expression of the generated code may take,
+ * with infinite bounds when it is not bounded.
+ */
+struct clast_range {
+    double lower;
+    double upper;
+};
+
+/**
+ * The data of clast_long_dims: the names and the long_dims array of the
+ * program, and the current range of each scattering dimension, iterator
+ * and parameter, in the order of long_dims.
+ */
+struct clast_long_data {
+    CloogNames *names;
+    int *long_dims;
+    struct clast_range *range;
+};
+
+static int range_fits_int(struct clast_range r)
+{
+    return r.lower >= INT_MIN && r.upper <= INT_MAX;
+}
+
+/**
+ * Call "fn" on the position in long_dims of each of the scattering
+ * dimensions, iterators and parameters called "name".  A scattering
+ * dimension may have the name of an iterator.
+ */
+static void clast_long_foreach(struct clast_long_data *d, const char *name,
+	void (*fn)(struct clast_long_data *d, int pos, void *user), void *user)
+{
+    CloogNames *names = d->names;
+    int i, pos = 0;
+
+    for (i = 0; i < names->nb_scattering; i++, pos++)
+	if (!strcmp(names->scattering[i], name))
+	    fn(d, pos, user);
+    for (i = 0; i < names->nb_iterators; i++, pos++)
+	if (!strcmp(names->iterators[i], name))
+	    fn(d, pos, user);
+    for (i = 0; i < names->nb_parameters; i++, pos++)
+	if (!strcmp(names->parameters[i], name))
+	    fn(d, pos, user);
+}
+
+static void clast_long_mark(struct clast_long_data *d, int pos, void *user)
+{
+    (void) user;
+    d->long_dims[pos] = 1;
+}
+
+static void clast_long_set_range(struct clast_long_data *d, int pos,
+	void *user)
+{
+    d->range[pos] = *(struct clast_range *) user;
+}
+
+static void clast_long_get_range(struct clast_long_data *d, int pos,
+	void *user)
+{
+    *(struct clast_range *) user = d->range[pos];
+}
+
+/* Mark all the variables that appear in "e" as needing a long long type. */
+static void clast_expr_mark_long(struct clast_long_data *d,
+	struct clast_expr *e)
+{
+    int i;
+
+    if (!e)
+	return;
+    switch (e->type) {
+    case clast_expr_name:
+	clast_long_foreach(d, ((struct clast_name *) e)->name,
+			   &clast_long_mark, NULL);
+	break;
+    case clast_expr_term:
+	clast_expr_mark_long(d, ((struct clast_term *) e)->var);
+	break;
+    case clast_expr_bin:
+	clast_expr_mark_long(d, ((struct clast_binary *) e)->LHS);
+	break;
+    case clast_expr_red:
+	for (i = 0; i < ((struct clast_reduction *) e)->n; i++)
+	    clast_expr_mark_long(d, ((struct clast_reduction *) e)->elts[i]);
+	break;
+    }
+}
+
+/**
+ * Return the range of the values of "e" and of all its subexpressions.
+ * If any of them may not fit in an int, the variables of the subexpression
+ * are marked as needing a long long type, so that it is evaluated in
+ * long long arithmetic.
+ */
+static struct clast_range clast_expr_range(struct clast_long_data *d,
+	struct clast_expr *e)
+{
+    struct clast_range r = { -HUGE_VAL, HUGE_VAL }, a;
+    struct clast_term *t;
+    struct clast_binary *b;
+    struct clast_reduction *red;
+    double c, m;
+    int i;
+
+    switch (e->type) {
+    case clast_expr_name:
+	clast_long_foreach(d, ((struct clast_name *) e)->name,
+			   &clast_long_get_range, &r);
+	break;
+    case clast_expr_term:
+	t = (struct clast_term *) e;
+	c = cloog_int_get_d(t->val);
+	if (!t->var) {
+	    r.lower = r.upper = c;
+	    break;
+	}
+	a = clast_expr_range(d, t->var);
+	r.lower = c > 0 ? c * a.lower : c * a.upper;
+	r.upper = c > 0 ? c * a.upper : c * a.lower;
+	break;
+    case clast_expr_bin:
+	b = (struct clast_binary *) e;
+	a = clast_expr_range(d, b->LHS);
+	m = cloog_int_get_d(b->RHS);
+	if (b->type == clast_bin_mod) {
+	    r.lower = a.lower >= 0 ? 0 : 1 - m;
+	    r.upper = m - 1;
+	} else {
+	    /* Rounding changes the quotient by less than one. */
+	    r.lower = a.lower / m - 1;
+	    r.upper = a.upper / m + 1;
+	}
+	break;
+    case clast_expr_red:
+	red = (struct clast_reduction *) e;
+	for (i = 0; i < red->n; i++) {
+	    a = clast_expr_range(d, red->elts[i]);
+	    if (i == 0)
+		r = a;
+	    else if (red->type == clast_red_sum) {
+		r.lower += a.lower;
+		r.upper += a.upper;
+	    } else if (red->type == clast_red_min) {
+		r.lower = a.lower < r.lower ? a.lower : r.lower;
+		r.upper = a.upper < r.upper ? a.upper : r.upper;
+	    } else {
+		r.lower = a.lower > r.lower ? a.lower : r.lower;
+		r.upper = a.upper > r.upper ? a.upper : r.upper;
+	    }
+	}
+	break;
+    }
+
+    if (!range_fits_int(r))
+	clast_expr_mark_long(d, e);
+    return r;
+}
+
+/**
+ * Compute the range of the iterators defined in the list "s" from the
+ * ranges of their bounds, and widen the types of the variables of the
+ * expressions that may not fit in an int.
+ */
+static void clast_stmt_long_dims(struct clast_long_data *d,
+	struct clast_stmt *s)
+{
+    struct clast_range r, lb, ub;
+    int i;
+
+    for ( ; s; s = s->next) {
+	if (CLAST_STMT_IS_A(s, stmt_for)) {
+	    struct clast_for *f = (struct clast_for *) s;
+	    r.lower = -HUGE_VAL;
+	    r.upper = HUGE_VAL;
+	    if (f->LB) {
+		lb = clast_expr_range(d, f->LB);
+		r.lower = lb.lower;
+	    }
+	    if (f->UB) {
+		ub = clast_expr_range(d, f->UB);
+		r.upper = ub.upper;
+	    }
+	    clast_long_foreach(d, f->iterator, &clast_long_set_range, &r);
+	    if (!range_fits_int(r))
+		clast_long_foreach(d, f->iterator, &clast_long_mark, NULL);
+	    clast_stmt_long_dims(d, f->body);
+	} else if (CLAST_STMT_IS_A(s, stmt_guard)) {
+	    struct clast_guard *g = (struct clast_guard *) s;
+	    for (i = 0; i < g->n; i++) {
+		clast_expr_range(d, g->eq[i].LHS);
+		clast_expr_range(d, g->eq[i].RHS);
+	    }
+	    clast_stmt_long_dims(d, g->then);
+	} else if (CLAST_STMT_IS_A(s, stmt_ass)) {
+	    struct clast_assignment *a = (struct clast_assignment *) s;
+	    r = clast_expr_range(d, a->RHS);
+	    if (!a->LHS)
+		continue;
+	    clast_long_foreach(d, a->LHS, &clast_long_set_range, &r);
+	    if (!range_fits_int(r))
+		clast_long_foreach(d, a->LHS, &clast_long_mark, NULL);
+	} else if (CLAST_STMT_IS_A(s, stmt_user))
+	    clast_stmt_long_dims(d, ((struct clast_user_stmt *) s)->substitutions);
+	else if (CLAST_STMT_IS_A(s, stmt_block))
+	    clast_stmt_long_dims(d, ((struct clast_block *) s)->body);
+    }
+}
+
+/**
+ * Widen to long long the types chosen by cloog_program_generate for the
+ * variables of the expressions of the generated code "root" that may not
+ * fit in an int, such as 10*ii in a bound of a loop on i even if ii
+ * itself fits.  The ranges of the parameters are taken from the context,
+ * those of the iterators from their bounds.
+ */
+static void clast_long_dims(struct clast_stmt *root, CloogProgram *program)
+{
+    struct clast_long_data d;
+    CloogNames *names = program->names;
+    CloogDomain *context;
+    cloog_int_t lower, upper;
+    int i, n, has_lower, has_upper;
+
+    n = names->nb_scattering + names->nb_iterators;
+    d.names = names;
+    d.long_dims = program->long_dims;
+    d.range = ALLOCN(struct clast_range, n + names->nb_parameters + 1);
+    for (i = 0; i < n + names->nb_parameters; i++) {
+	d.range[i].lower = -HUGE_VAL;
+	d.range[i].upper = HUGE_VAL;
+    }
+
+    cloog_int_init(lower);
+    cloog_int_init(upper);
+    context = cloog_domain_from_context(cloog_domain_copy(program->context));
+    for (i = 0; i < names->nb_parameters; i++) {
+	cloog_domain_level_bounds(context, i + 1,
+				  &lower, &has_lower, &upper, &has_upper);
+	if (has_lower)
+	    d.range[n + i].lower = cloog_int_get_d(lower);
+	if (has_upper)
+	    d.range[n + i].upper = cloog_int_get_d(upper);
+    }
+    cloog_domain_free(context);
+    cloog_int_clear(upper);
+    cloog_int_clear(lower);
+
+    clast_stmt_long_dims(&d, root);
+    free(d.range);
 }
 
 
@@ -1877,9 +2856,11 @@ struct clast_stmt *cloog_clast_create(CloogProgram *program,
 {
     CloogInfos *infos = ALLOC(CloogInfos);
     int nb_levels;
-    struct clast_stmt *root = &new_clast_root(program->names)->stmt;
+    struct clast_root *r = new_clast_root(program->names);
+    struct clast_stmt *root = &r->stmt;
     struct clast_stmt **next = &root->next;
 
+    cloog_state_phase_start(options->state, CLOOG_PHASE_CLAST);
     infos->state      = options->state;
     infos->names    = program->names;
     infos->options  = options;
@@ -1895,23 +2876,48 @@ struct clast_stmt *cloog_clast_create(CloogProgram *program,
 
     infos->equal = cloog_equal_alloc(nb_levels,
 			       nb_levels, program->names->nb_parameters);
+
+    if (options->clast_arena)
+	r->arena = clast_arena_new();
+    infos->arena = r->arena;
+    if (options->clast_intern)
+	r->intern = clast_intern_new();
+    infos->intern = r->intern;
 	
     insert_loop(program->loop, 0, &next, infos);
+    clast_stmt_intern(infos, root->next);
 
     cloog_equal_free(infos->equal);
 
     free(infos->stride);
     free(infos);
 
+    if (options->iterator_type == CLOOG_ITERATOR_AUTO && program->long_dims)
+	clast_long_dims(root, program);
+    cloog_state_phase_end(options->state, CLOOG_PHASE_CLAST);
+
     return root;
 }
 
 
+/* Returns NULL if an integer overflows with the checked integer type,
+ * unless the caller set an overflow handler, which it then reaches.
+ */
 struct clast_stmt *cloog_clast_create_from_input(CloogInput *input,
 						 CloogOptions *options)
 {
     CloogProgram *program;
     struct clast_stmt *root;
+    jmp_buf env;
+    int handler = !cloog_int_overflow_handler();
+
+    if (handler) {
+	if (setjmp(env)) {
+	    cloog_int_set_overflow_handler(NULL);
+	    return NULL;
+	}
+	cloog_int_set_overflow_handler(&env);
+    }
 
     program = cloog_program_alloc(input->context, input->ud, options);
     free(input);
@@ -1921,6 +2927,8 @@ struct clast_stmt *cloog_clast_create_from_input(CloogInput *input,
     root = cloog_clast_create(program, options);
     cloog_program_free(program);
 
+    if (handler)
+	cloog_int_set_overflow_handler(NULL);
     return root;
 }
 
@@ -2122,7 +3130,13 @@ void clast_filter(struct clast_stmt *node,
 */
 void clast_unroll_jam (struct clast_stmt *s)
 {
-    unroll_jam(s, NULL);
+    CloogInfos infos;
+
+    /* New nodes belong to the arena of the clast, if any. */
+    memset(&infos, 0, sizeof(infos));
+    if (s && CLAST_STMT_IS_A(s, stmt_root))
+	infos.arena = ((struct clast_root *)s)->arena;
+    unroll_jam(&infos, s, NULL);
 }
 
 /* Updates the epilogue of the statement. The loop epilogue of the loop being
@@ -2151,8 +3165,8 @@ static void update_epilogue_for_unrolling (struct clast_stmt *s)
 
 /* Replaces the iterator in the expression with the new iterator expression
  * after unroll jam. The new expression is given by (iter + uf). */
-static void replace_iter_in_expr(struct clast_expr * e, const char *iter,
-        cloog_int_t uf, struct clast_term *prev)
+static void replace_iter_in_expr(CloogInfos *infos, struct clast_expr * e,
+        const char *iter, cloog_int_t uf, struct clast_term *prev)
 {
     struct clast_name *n;
     struct clast_term *t;
@@ -2168,11 +3182,11 @@ static void replace_iter_in_expr(struct clast_expr * e, const char *iter,
             cloog_int_t one;
             cloog_int_init(one);
             cloog_int_set_si(one , 1);
-            new_n = &new_clast_name(iter)->expr;
-            new_t = &new_clast_term(one,new_n)->expr;
-            new_r = new_clast_reduction(clast_red_sum, 2);
+            new_n = &alloc_clast_name(infos, iter)->expr;
+            new_t = &alloc_clast_term(infos, one,new_n)->expr;
+            new_r = alloc_clast_reduction(infos, clast_red_sum, 2);
             new_r->elts[0] = new_t;
-            new_r->elts[1] = &new_clast_term(uf, NULL)->expr;
+            new_r->elts[1] = &alloc_clast_term(infos, uf, NULL)->expr;
             prev->var = &new_r->expr;
             cloog_int_clear(one);
             free_clast_expr(e);
@@ -2180,23 +3194,23 @@ static void replace_iter_in_expr(struct clast_expr * e, const char *iter,
     } else if (e->type == clast_expr_term) {
         t = (struct clast_term *)e;
         if (t->var) {
-            replace_iter_in_expr(t->var, iter, uf, t);
+            replace_iter_in_expr(infos, t->var, iter, uf, t);
         }
     } else if (e->type == clast_expr_red) {
         r = (struct clast_reduction *)e;
         for (i=0; i<r->n; i++) {
-            replace_iter_in_expr(r->elts[i], iter, uf, NULL);
+            replace_iter_in_expr(infos, r->elts[i], iter, uf, NULL);
         }
     } else {
         assert (e->type == clast_expr_bin);
         b = (struct clast_binary *)e;
-        replace_iter_in_expr(b->LHS, iter, uf, NULL);
+        replace_iter_in_expr(infos, b->LHS, iter, uf, NULL);
     }
 }
 
 /* Updates the iterator in a substitution of a user statement.  */
-static void update_iterator_in_substitution(struct clast_stmt* sub,
-        const char *iterator, cloog_int_t uf)
+static void update_iterator_in_substitution(CloogInfos *infos,
+        struct clast_stmt* sub, const char *iterator, cloog_int_t uf)
 {
     struct clast_stmt *t;
     struct clast_expr *iter;
@@ -2207,7 +3221,7 @@ static void update_iterator_in_substitution(struct clast_stmt* sub,
     for (t = sub; t; t = t->next) {
         assert (CLAST_STMT_IS_A(t, stmt_ass));
         iter = ((struct clast_assignment *)t)->RHS;
-        replace_iter_in_expr(iter, iterator, uf, NULL);
+        replace_iter_in_expr(infos, iter, iterator, uf, NULL);
     }
     cloog_int_clear(uj_one);
 }
@@ -2243,8 +3257,8 @@ static struct clast_stmt **get_statements_to_be_unrolled(struct clast_stmt *s,
 }
 
 /* Unroll jams a statement. */
-static void unroll_jam_statement(struct clast_stmt *s, unsigned ufactor,
-        const char *uj_iterator, cloog_int_t stride)
+static void unroll_jam_statement(CloogInfos *infos, struct clast_stmt *s,
+        unsigned ufactor, const char *uj_iterator, cloog_int_t stride)
 {
     struct clast_user_stmt *in;
     struct clast_stmt *curr, *prev, *last, *sub, **unroll_stmts;
@@ -2264,9 +3278,10 @@ static void unroll_jam_statement(struct clast_stmt *s, unsigned ufactor,
         cloog_int_mul(uf, uf, stride);
         for (j = 0; j < num_unroll_stmts; j++) {
             in = (struct clast_user_stmt *)unroll_stmts[j];
-            sub = clast_ast_dup(in->substitutions);
-            update_iterator_in_substitution(sub, uj_iterator, uf);
-            curr = &new_clast_user_stmt(in->domain, in->statement, sub)->stmt;
+            sub = clast_ast_dup(infos, in->substitutions);
+            update_iterator_in_substitution(infos, sub, uj_iterator, uf);
+            curr = &alloc_clast_user_stmt(infos, in->domain, in->statement,
+                    sub)->stmt;
             prev->next = curr;
             prev = curr;
         }
@@ -2289,41 +3304,509 @@ static void update_loop_stride_for_unrolling(struct clast_for *loop)
     cloog_int_clear(uf);
 }
 
-/* Unroll jams a loop body. */
-static void unroll_jam_loop_body(struct clast_stmt *s, int ufactor,
-        const char *iterator, cloog_int_t stride)
+/* Returns the direction in which the expression e varies with the
+ * iterator: 1 if it does not decrease and -1 if it does not increase when
+ * the iterator grows, 0 if it does not depend on it and 2 if the direction
+ * is unknown, e.g., because of a modulo. The divisions are by positive
+ * constants, so they keep the direction of their dividend. */
+static int expr_iterator_direction(struct clast_expr *e, const char *iterator)
 {
-    struct clast_for *loop;
-    struct clast_guard *g;
-    struct clast_stmt *next_stmt;
-    if (!s)
-        return;
-    if (CLAST_STMT_IS_A(s, stmt_user)) {
-        next_stmt = s->next;
-        while (next_stmt) {
-            if (!CLAST_STMT_IS_A(next_stmt, stmt_user)) {
-                break;
-            }
-            next_stmt = next_stmt->next;
+    struct clast_term *t;
+    struct clast_reduction *r;
+    struct clast_binary *b;
+    int i, d, res;
+
+    if (!e)
+        return 0;
+    switch (e->type) {
+    case clast_expr_name:
+        return strcmp(((struct clast_name *)e)->name, iterator) ? 0 : 1;
+    case clast_expr_term:
+        t = (struct clast_term *)e;
+        d = expr_iterator_direction(t->var, iterator);
+        if (d == 2 || !cloog_int_is_neg(t->val))
+            return d;
+        return -d;
+    case clast_expr_bin:
+        b = (struct clast_binary *)e;
+        d = expr_iterator_direction(b->LHS, iterator);
+        if (d && b->type == clast_bin_mod)
+            return 2;
+        return d;
+    case clast_expr_red:
+        r = (struct clast_reduction *)e;
+        res = 0;
+        for (i = 0; i < r->n; i++) {
+            d = expr_iterator_direction(r->elts[i], iterator);
+            if (!res)
+                res = d;
+            else if (d && d != res)
+                return 2;
         }
-        unroll_jam_statement(s, ufactor, iterator, stride);
-        unroll_jam_loop_body(next_stmt, ufactor, iterator, stride);
-    } else if (CLAST_STMT_IS_A(s, stmt_for)) {
-        loop = (struct clast_for *)s;
-        unroll_jam_loop_body(loop->body, ufactor, iterator, stride);
-        unroll_jam_loop_body(s->next, ufactor, iterator, stride);
-    } else if (CLAST_STMT_IS_A (s, stmt_guard)){
-        g = (struct clast_guard *)s;
-        unroll_jam_loop_body(g->then, ufactor, iterator, stride);
-        unroll_jam_loop_body(s->next, ufactor, iterator, stride);
+        return res;
     }
-    return;
+    return 2;
 }
 
-/* Updates the loop upper bound during unroll jam. The new upper bound is
- * given by (UB - (unroll factor-1)* loop stride) where UB is the upper bound
+/* Affine expression sum_i coef[i] * var[i] + cst, in which the sums of an
+ * expression are collected by clast_affine_add. */
+struct clast_affine {
+    int n;
+    struct clast_expr **var;
+    cloog_int_t *coef;
+    cloog_int_t cst;
+};
+
+static struct clast_expr *clast_expr_simplify(CloogInfos *infos,
+	struct clast_expr *e);
+
+/* Adds c times the expression e to a.  The operands of e that are not
+ * terms or sums are collected as simplified copies, equal ones once.
+ * A minimum or maximum may simplify to a single sum, which is added. */
+static void clast_affine_add(CloogInfos *infos, struct clast_affine *a,
+	struct clast_expr *e, cloog_int_t c)
+{
+    struct clast_term *t;
+    struct clast_reduction *r;
+    cloog_int_t v;
+    int i;
+
+    if (!e)
+	return;
+    if (e->type == clast_expr_term) {
+	t = (struct clast_term *)e;
+	cloog_int_init(v);
+	cloog_int_mul(v, c, t->val);
+	if (t->var)
+	    clast_affine_add(infos, a, t->var, v);
+	else
+	    cloog_int_add(a->cst, a->cst, v);
+	cloog_int_clear(v);
+	return;
+    }
+    r = (struct clast_reduction *)e;
+    if (e->type == clast_expr_red && r->type == clast_red_sum) {
+	for (i = 0; i < r->n; ++i)
+	    clast_affine_add(infos, a, r->elts[i], c);
+	return;
+    }
+    e = clast_expr_simplify(infos, clast_expr_copy(infos, e));
+    r = (struct clast_reduction *)e;
+    if (e->type == clast_expr_term ||
+	(e->type == clast_expr_red && r->type == clast_red_sum)) {
+	clast_affine_add(infos, a, e, c);
+	free_clast_expr(e);
+	return;
+    }
+    for (i = 0; i < a->n; ++i)
+	if (clast_expr_equal(a->var[i], e))
+	    break;
+    if (i < a->n) {
+	cloog_int_add(a->coef[i], a->coef[i], c);
+	free_clast_expr(e);
+	return;
+    }
+    a->var = realloc(a->var, (a->n + 1) * sizeof(struct clast_expr *));
+    a->coef = realloc(a->coef, (a->n + 1) * sizeof(cloog_int_t));
+    if (!a->var || !a->coef)
+	cloog_die("memory overflow.\n");
+    a->var[a->n] = e;
+    cloog_int_init(a->coef[a->n]);
+    cloog_int_set(a->coef[a->n], c);
+    a->n++;
+}
+
+/* Returns the sum of the terms of a, the constant last, and clears a.
+ * A single term is returned as is, and a minimum or a maximum with
+ * a unit coefficient without a term. */
+static struct clast_expr *clast_affine_expr(CloogInfos *infos,
+	struct clast_affine *a)
+{
+    struct clast_reduction *r;
+    struct clast_expr *e;
+    int i, n;
+
+    n = !cloog_int_is_zero(a->cst);
+    for (i = 0; i < a->n; ++i)
+	if (!cloog_int_is_zero(a->coef[i]))
+	    n++;
+    r = n > 1 ? alloc_clast_reduction(infos, clast_red_sum, n) : NULL;
+
+    n = 0;
+    e = NULL;
+    for (i = 0; i < a->n; ++i) {
+	if (cloog_int_is_zero(a->coef[i]))
+	    free_clast_expr(a->var[i]);
+	else if (!r && cloog_int_is_one(a->coef[i]) &&
+		 a->var[i]->type == clast_expr_red)
+	    e = a->var[i];
+	else {
+	    e = &alloc_clast_term(infos, a->coef[i], a->var[i])->expr;
+	    if (r)
+		r->elts[n++] = e;
+	}
+	cloog_int_clear(a->coef[i]);
+    }
+    if (r && !cloog_int_is_zero(a->cst))
+	r->elts[n++] = &alloc_clast_term(infos, a->cst, NULL)->expr;
+    else if (!e)
+	e = &alloc_clast_term(infos, a->cst, NULL)->expr;
+    cloog_int_clear(a->cst);
+    free(a->var);
+    free(a->coef);
+    return r ? &r->expr : e;
+}
+
+/* Does e make f redundant in a reduction of type "type", i.e., are they
+ * equal or is e a constant that is larger (for a maximum) or smaller
+ * (for a minimum) than the constant f? */
+static int clast_expr_dominates(enum clast_red_type type,
+	struct clast_expr *e, struct clast_expr *f)
+{
+    if (clast_expr_equal(e, f))
+	return 1;
+    if (type == clast_red_max)
+	return clast_expr_is_bigger_constant(e, f);
+    return clast_expr_is_bigger_constant(f, e);
+}
+
+/* Returns a simplified version of the expression e, which is taken and
+ * may not be shared, like the bounds computed by clast_minmax: the sums
+ * are flattened, with their constants and equal terms combined, and
+ * the minima and maxima are flattened, without duplicate or dominated
+ * constant elements, and sorted. */
+static struct clast_expr *clast_expr_simplify(CloogInfos *infos,
+	struct clast_expr *e)
+{
+    struct clast_affine a = { 0, NULL, NULL };
+    struct clast_reduction *r, *s, *res;
+    struct clast_binary *b;
+    struct clast_expr *f;
+    cloog_int_t one;
+    int i, j, k, n;
+
+    if (!e || e->type == clast_expr_name)
+	return e;
+    if (e->type == clast_expr_bin) {
+	b = (struct clast_binary *)e;
+	b->LHS = clast_expr_simplify(infos, b->LHS);
+	return e;
+    }
+    r = (struct clast_reduction *)e;
+    if (e->type == clast_expr_term || r->type == clast_red_sum) {
+	cloog_int_init(a.cst);
+	cloog_int_init(one);
+	cloog_int_set_si(one, 1);
+	clast_affine_add(infos, &a, e, one);
+	cloog_int_clear(one);
+	free_clast_expr(e);
+	return clast_affine_expr(infos, &a);
+    }
+
+    n = 0;
+    for (i = 0; i < r->n; ++i) {
+	r->elts[i] = clast_expr_simplify(infos, r->elts[i]);
+	s = (struct clast_reduction *)r->elts[i];
+	n += r->elts[i]->type == clast_expr_red && s->type == r->type ? s->n : 1;
+    }
+    res = alloc_clast_reduction(infos, r->type, n);
+    n = 0;
+    for (i = 0; i < r->n; ++i) {
+	s = (struct clast_reduction *)r->elts[i];
+	if (r->elts[i]->type != clast_expr_red || s->type != r->type) {
+	    res->elts[n++] = r->elts[i];
+	    r->elts[i] = NULL;
+	    continue;
+	}
+	for (j = 0; j < s->n; ++j)
+	    res->elts[n++] = clast_expr_copy(infos, s->elts[j]);
+    }
+    free_clast_expr(e);
+
+    for (i = n - 1; i >= 0; --i) {
+	for (j = 0; j < n; ++j)
+	    if (j != i && res->elts[j] &&
+		clast_expr_dominates(res->type, res->elts[j],
+					   res->elts[i]))
+		break;
+	if (j < n) {
+	    free_clast_expr(res->elts[i]);
+	    res->elts[i] = NULL;
+	}
+    }
+    for (i = k = 0; i < n; ++i)
+	if (res->elts[i])
+	    res->elts[k++] = res->elts[i];
+    res->n = k;
+    if (k == 1) {
+	f = res->elts[0];
+	res->elts[0] = NULL;
+	free_clast_expr(&res->expr);
+	return f;
+    }
+    clast_reduction_sort(res);
+    return &res->expr;
+}
+
+/* Replaces the iterator by (iterator + uf) in the expression stored at e
+ * and returns the number of replacements. */
+static int shift_iterator(CloogInfos *infos, struct clast_expr **e,
+        const char *iterator, cloog_int_t uf)
+{
+    struct clast_reduction *r;
+    cloog_int_t one;
+    int i, n;
+
+    if (!*e)
+        return 0;
+    switch ((*e)->type) {
+    case clast_expr_name:
+        if (strcmp(((struct clast_name *)*e)->name, iterator))
+            return 0;
+        cloog_int_init(one);
+        cloog_int_set_si(one, 1);
+        r = alloc_clast_reduction(infos, clast_red_sum, 2);
+        r->elts[0] = &alloc_clast_term(infos, one, *e)->expr;
+        r->elts[1] = &alloc_clast_term(infos, uf, NULL)->expr;
+        *e = &r->expr;
+        cloog_int_clear(one);
+        return 1;
+    case clast_expr_term:
+        return shift_iterator(infos, &((struct clast_term *)*e)->var,
+                iterator, uf);
+    case clast_expr_bin:
+        return shift_iterator(infos, &((struct clast_binary *)*e)->LHS,
+                iterator, uf);
+    case clast_expr_red:
+        r = (struct clast_reduction *)*e;
+        for (i = n = 0; i < r->n; i++)
+            n += shift_iterator(infos, &r->elts[i], iterator, uf);
+        return n;
+    }
+    return 0;
+}
+
+/* Replaces the iterator by (iterator + uf) in the expression stored at e,
+ * which may not be shared, and simplifies the result if the iterator
+ * appears in it.  The first copy, with uf = 0, keeps the iterator as is. */
+static void shift_iterator_in_expr(CloogInfos *infos, struct clast_expr **e,
+        const char *iterator, cloog_int_t uf)
+{
+    if (cloog_int_is_zero(uf))
+        return;
+    if (shift_iterator(infos, e, iterator, uf))
+        *e = clast_expr_simplify(infos, *e);
+}
+
+/* Replaces the iterator by (iterator + uf) in the statements of the list s
+ * and in all the statements they contain. */
+static void shift_iterator_in_stmts(CloogInfos *infos, struct clast_stmt *s,
+        const char *iterator, cloog_int_t uf)
+{
+    struct clast_for *loop;
+    struct clast_guard *g;
+    int i;
+
+    for (; s; s = s->next) {
+        if (CLAST_STMT_IS_A(s, stmt_user)) {
+            shift_iterator_in_stmts(infos,
+                    ((struct clast_user_stmt *)s)->substitutions,
+                    iterator, uf);
+        } else if (CLAST_STMT_IS_A(s, stmt_ass)) {
+            shift_iterator_in_expr(infos, &((struct clast_assignment *)s)->RHS,
+                    iterator, uf);
+        } else if (CLAST_STMT_IS_A(s, stmt_for)) {
+            loop = (struct clast_for *)s;
+            shift_iterator_in_expr(infos, &loop->LB, iterator, uf);
+            shift_iterator_in_expr(infos, &loop->UB, iterator, uf);
+            shift_iterator_in_stmts(infos, loop->body, iterator, uf);
+        } else if (CLAST_STMT_IS_A(s, stmt_guard)) {
+            g = (struct clast_guard *)s;
+            for (i = 0; i < g->n; i++) {
+                shift_iterator_in_expr(infos, &g->eq[i].LHS, iterator, uf);
+                shift_iterator_in_expr(infos, &g->eq[i].RHS, iterator, uf);
+            }
+            shift_iterator_in_stmts(infos, g->then, iterator, uf);
+        }
+    }
+}
+
+/* Returns the expression (e + c), where e is taken. */
+static struct clast_expr *clast_expr_add_constant(CloogInfos *infos,
+	struct clast_expr *e, int c)
+{
+    struct clast_reduction *r;
+    cloog_int_t v;
+
+    cloog_int_init(v);
+    r = alloc_clast_reduction(infos, clast_red_sum, 2);
+    cloog_int_set_si(v, 1);
+    r->elts[0] = &alloc_clast_term(infos, v, e)->expr;
+    cloog_int_set_si(v, c);
+    r->elts[1] = &alloc_clast_term(infos, v, NULL)->expr;
+    cloog_int_clear(v);
+    return clast_expr_simplify(infos, &r->expr);
+}
+
+/* Returns the reduction of type "type" of e1 and e2, which are taken. */
+static struct clast_expr *clast_expr_pair(CloogInfos *infos,
+        enum clast_red_type type, struct clast_expr *e1, struct clast_expr *e2)
+{
+    struct clast_reduction *r;
+
+    r = alloc_clast_reduction(infos, type, 2);
+    r->elts[0] = e1;
+    r->elts[1] = e2;
+    return clast_expr_simplify(infos, &r->expr);
+}
+
+/* Returns a copy of the expression e where the unroll jammed iterator is
+ * replaced by (iterator + k*stride). */
+static struct clast_expr *unroll_jam_copy_expr(CloogInfos *infos,
+        struct clast_expr *e, int k, const char *iterator, cloog_int_t stride)
+{
+    cloog_int_t uf;
+
+    e = clast_expr_copy(infos, e);
+    cloog_int_init(uf);
+    cloog_int_set_si(uf, k);
+    cloog_int_mul(uf, uf, stride);
+    shift_iterator_in_expr(infos, &e, iterator, uf);
+    cloog_int_clear(uf);
+    return e;
+}
+
+/* Returns a copy of the loop where the unroll jammed iterator is
+ * replaced by (iterator + k*stride). */
+static struct clast_for *unroll_jam_copy_loop(CloogInfos *infos,
+        struct clast_for *loop, int k, const char *iterator, cloog_int_t stride)
+{
+    struct clast_for *copy;
+    cloog_int_t uf;
+
+    cloog_int_init(uf);
+    cloog_int_set_si(uf, k);
+    cloog_int_mul(uf, uf, stride);
+    copy = clast_for_copy(infos, loop);
+    shift_iterator_in_expr(infos, &copy->LB, iterator, uf);
+    shift_iterator_in_expr(infos, &copy->UB, iterator, uf);
+    shift_iterator_in_stmts(infos, copy->body, iterator, uf);
+    cloog_int_clear(uf);
+    return copy;
+}
+
+static void unroll_jam_loop_body(CloogInfos *infos, struct clast_stmt **list,
+        int ufactor, const char *iterator, cloog_int_t stride);
+
+/* Unroll jams the loop stored at pos, whose bounds depend on the unroll
+ * jammed iterator. Each of the ufactor copies of its body has its own
+ * range, the loop is restricted to the range they have in common, where the
+ * copies can be jammed. As the bounds are monotone in the iterator (see
+ * expr_iterator_direction), that range is bounded by the lower bound of the
+ * first or the last copy and by the upper bound of the other one. Before it,
+ * a loop scans the remaining iterations of each copy whose lower bound is
+ * smaller, and after it, a loop scans those of each copy whose upper bound is
+ * larger. Returns the position after the last of these loops. */
+static struct clast_stmt **unroll_jam_split_loop(CloogInfos *infos,
+        struct clast_stmt **pos, int ufactor, const char *iterator,
+        cloog_int_t stride)
+{
+    struct clast_for *loop, *part;
+    struct clast_expr *lb, *ub;
+    struct clast_stmt **after;
+    int lb_dir, ub_dir, lb_copy, ub_copy, k;
+
+    loop = (struct clast_for *)*pos;
+    lb_dir = expr_iterator_direction(loop->LB, iterator);
+    ub_dir = expr_iterator_direction(loop->UB, iterator);
+    /* The copy providing each bound of the common range. */
+    lb_copy = lb_dir > 0 ? ufactor - 1 : 0;
+    ub_copy = ub_dir < 0 ? ufactor - 1 : 0;
+    lb = unroll_jam_copy_expr(infos, loop->LB, lb_copy, iterator, stride);
+    ub = unroll_jam_copy_expr(infos, loop->UB, ub_copy, iterator, stride);
+
+    for (k = 0; lb_dir && k < ufactor; k++) {
+        if (k == lb_copy)
+            continue;
+        part = unroll_jam_copy_loop(infos, loop, k, iterator, stride);
+        part->UB = clast_expr_pair(infos, clast_red_min, part->UB,
+                clast_expr_add_constant(infos, clast_expr_copy(infos, lb), -1));
+        part->unroll_type = clast_no_unroll;
+        part->stmt.next = *pos;
+        *pos = &part->stmt;
+        pos = &part->stmt.next;
+    }
+
+    after = &loop->stmt.next;
+    for (k = 0; ub_dir && k < ufactor; k++) {
+        if (k == ub_copy)
+            continue;
+        part = unroll_jam_copy_loop(infos, loop, k, iterator, stride);
+        free_clast_expr(part->LB);
+        part->LB = clast_expr_pair(infos, clast_red_max,
+                clast_expr_copy(infos, lb),
+                clast_expr_add_constant(infos, clast_expr_copy(infos, ub), 1));
+        part->unroll_type = clast_no_unroll;
+        part->stmt.next = *after;
+        *after = &part->stmt;
+        after = &part->stmt.next;
+    }
+
+    free_clast_expr(loop->LB);
+    free_clast_expr(loop->UB);
+    loop->LB = lb;
+    loop->UB = ub;
+    unroll_jam_loop_body(infos, &loop->body, ufactor, iterator, stride);
+
+    return after;
+}
+
+/* Unroll jams the loop body stored at list. */
+static void unroll_jam_loop_body(CloogInfos *infos, struct clast_stmt **list,
+        int ufactor, const char *iterator, cloog_int_t stride)
+{
+    struct clast_for *loop;
+    struct clast_guard *g;
+    struct clast_stmt *s, *next_stmt;
+    struct clast_stmt **pos = list;
+
+    while ((s = *pos)) {
+        if (CLAST_STMT_IS_A(s, stmt_user)) {
+            next_stmt = s->next;
+            while (next_stmt) {
+                if (!CLAST_STMT_IS_A(next_stmt, stmt_user)) {
+                    break;
+                }
+                next_stmt = next_stmt->next;
+            }
+            unroll_jam_statement(infos, s, ufactor, iterator, stride);
+            while (*pos != next_stmt)
+                pos = &(*pos)->next;
+        } else if (CLAST_STMT_IS_A(s, stmt_for)) {
+            loop = (struct clast_for *)s;
+            if (expr_iterator_direction(loop->LB, iterator) ||
+                expr_iterator_direction(loop->UB, iterator)) {
+                pos = unroll_jam_split_loop(infos, pos, ufactor, iterator,
+                        stride);
+                continue;
+            }
+            unroll_jam_loop_body(infos, &loop->body, ufactor, iterator, stride);
+            pos = &s->next;
+        } else if (CLAST_STMT_IS_A (s, stmt_guard)){
+            g = (struct clast_guard *)s;
+            unroll_jam_loop_body(infos, &g->then, ufactor, iterator, stride);
+            pos = &s->next;
+        } else
+            break;
+    }
+    return;
+}
+
+/* Updates the loop upper bound during unroll jam. The new upper bound is
+ * given by (UB - (unroll factor-1)* loop stride) where UB is the upper bound
  * of the original loop. */
-static void update_loop_upper_bound_for_unrolling (struct clast_for *loop)
+static void update_loop_upper_bound_for_unrolling(CloogInfos *infos,
+	struct clast_for *loop)
 {
     cloog_int_t i, j;
     struct clast_expr *new_term1, *new_term2;
@@ -2334,26 +3817,26 @@ static void update_loop_upper_bound_for_unrolling (struct clast_for *loop)
     cloog_int_set_si(i,1);
     cloog_int_sub(j, loop->stride, i);
     cloog_int_neg(j,j);
-    new_term1 = &(new_clast_term(j, NULL))->expr;
-    new_term2 = &(new_clast_term(i, loop->UB))->expr;
-    new_ub = new_clast_reduction(clast_red_sum, 2);
+    new_term1 = &(alloc_clast_term(infos, j, NULL))->expr;
+    new_term2 = &(alloc_clast_term(infos, i, loop->UB))->expr;
+    new_ub = alloc_clast_reduction(infos, clast_red_sum, 2);
     new_ub->elts[0] = new_term2;
     new_ub->elts[1] = new_term1;
-    loop->UB = &new_ub->expr;
+    loop->UB = clast_expr_simplify(infos, &new_ub->expr);
     cloog_int_clear(i);
     cloog_int_clear(j);
 }
 
 /* Unroll jam a loop given by the ast node s. */
-static void unroll_jam_loop(struct clast_stmt *s)
+static void unroll_jam_loop(CloogInfos *infos, struct clast_stmt *s)
 {
     struct clast_for *loop;
     assert (CLAST_STMT_IS_A(s, stmt_for));
     loop = (struct clast_for *)s;
-    unroll_jam_loop_body(loop->body, loop->ufactor, loop->iterator,
+    unroll_jam_loop_body(infos, &loop->body, loop->ufactor, loop->iterator,
             loop->stride);
     update_loop_stride_for_unrolling(loop);
-    update_loop_upper_bound_for_unrolling(loop);
+    update_loop_upper_bound_for_unrolling(infos, loop);
 }
 
 /* Recursively checks whether an expression e contains the string given by
@@ -2397,98 +3880,90 @@ static int does_equation_contains(struct clast_equation *e, const char *iterator
             does_expr_contains(e->RHS, iterator));
 }
 
-/* Checks if a loop body is rectangular. Given a loop with iterator "iterator",
- * the routine checks if the loop body given by s, has a nested loop or a
- * conditional with "iterator" in its expression. That is, iterator of the loop
- * that is being unroll jammed shouldnt appear in the loop bounds or the guard
- * statements. If yes, then it returns true.  Else returns false. */
-static int is_domain_rectangular(struct clast_stmt *s, const char *iterator)
+/* Checks if a loop body can be unroll jammed. Given a loop with iterator
+ * "iterator", the routine checks that the iterator of the loop that is being
+ * unroll jammed does not appear in the guard statements of the loop body
+ * given by s. It may appear in the bounds of the nested loops, which are then
+ * split by unroll_jam_split_loop, provided these loops have a unit stride
+ * and bounds that are monotone in the iterator. If so, it returns true. Else
+ * returns false. */
+static int can_unroll_jam_body(struct clast_stmt *s, const char *iterator)
 {
     struct clast_for *loop;
     struct clast_guard *g;
-    if (!s)
-        return 1;
-    if (CLAST_STMT_IS_A(s, stmt_user))
-        return is_domain_rectangular(s->next, iterator);
-    if (CLAST_STMT_IS_A(s, stmt_ass))
-        return is_domain_rectangular(s->next, iterator);
-    if (CLAST_STMT_IS_A(s, stmt_for)) {
-        loop = (struct clast_for*)s;
-        if(does_expr_contains(loop->LB, iterator))
-            return 0;
-        if(does_expr_contains(loop->UB, iterator))
-            return 0;
-        if (!is_domain_rectangular(loop->body, iterator))
-            return 0;
-        return is_domain_rectangular(s->next, iterator);
-    }
-    /* Has to be a guard. */
-    assert(CLAST_STMT_IS_A(s, stmt_guard));
-    g = (struct clast_guard *)s;
-    for (int i=0; i<g->n; i++) {
-        if (does_equation_contains(&g->eq[i], iterator)
-                || does_equation_contains(&g->eq[i], iterator))
+    int lb_dir, ub_dir;
+    for (; s; s = s->next) {
+        if (CLAST_STMT_IS_A(s, stmt_user))
+            continue;
+        if (CLAST_STMT_IS_A(s, stmt_ass))
+            continue;
+        if (CLAST_STMT_IS_A(s, stmt_for)) {
+            loop = (struct clast_for*)s;
+            lb_dir = expr_iterator_direction(loop->LB, iterator);
+            ub_dir = expr_iterator_direction(loop->UB, iterator);
+            if (lb_dir == 2 || ub_dir == 2)
+                return 0;
+            if ((lb_dir || ub_dir) &&
+                (!loop->LB || !loop->UB || !cloog_int_is_one(loop->stride)))
+                return 0;
+            if (!can_unroll_jam_body(loop->body, iterator))
+                return 0;
+            continue;
+        }
+        /* Has to be a guard. */
+        assert(CLAST_STMT_IS_A(s, stmt_guard));
+        g = (struct clast_guard *)s;
+        for (int i=0; i<g->n; i++) {
+            if (does_equation_contains(&g->eq[i], iterator))
+                return 0;
+        }
+        if (!can_unroll_jam_body(g->then, iterator))
             return 0;
     }
-    if (!is_domain_rectangular(g->then, iterator))
-        return 0;
-    return is_domain_rectangular(s->next, iterator);
+    return 1;
 }
 
 /* Routine recursives traverses the AST in a top down manner and unroll jams for
- * loops that are marked with clast_unroll_and_jam if the domain is rectangluar with
- * respect to the loop that is being unroll jammed.   */
-static void unroll_jam (struct clast_stmt *s, struct clast_stmt *prev)
+ * loops that are marked with clast_unroll_and_jam if their body allows it (see
+ * can_unroll_jam_body).   */
+static void unroll_jam(CloogInfos *infos, struct clast_stmt *s,
+	struct clast_stmt *prev)
 {
     struct clast_for *loop;
     struct clast_stmt *epilogue, *tmp;
     struct clast_guard *g;
-    if (!s)
-        return;
-    if (CLAST_STMT_IS_A(s, stmt_root)) {
-        prev = s;
-        s = s-> next;
-        unroll_jam (s, prev);
-    } else if (CLAST_STMT_IS_A(s, stmt_for)) {
-        loop = (struct clast_for*) s;
-        if (loop->unroll_type == clast_unroll_and_jam) {
-            if (!is_domain_rectangular(loop->body, loop->iterator)) {
-                loop->unroll_type = clast_no_unroll;
-                unroll_jam (loop->body, s);
-                prev = s;
-                s = s->next;
-                unroll_jam (s, prev);
+    for (; s; s = s->next) {
+        if (CLAST_STMT_IS_A(s, stmt_root))
+            continue;
+        if (CLAST_STMT_IS_A(s, stmt_for)) {
+            loop = (struct clast_for*) s;
+            if (loop->unroll_type == clast_unroll_and_jam) {
+                if (!can_unroll_jam_body(loop->body, loop->iterator)) {
+                    loop->unroll_type = clast_no_unroll;
+                    unroll_jam(infos, loop->body, s);
+                    continue;
+                }
+                epilogue = &clast_for_copy(infos, loop)->stmt;
+                update_epilogue_for_unrolling(epilogue);
+                unroll_jam_loop(infos, s);
+                tmp = s->next;
+                s->next = epilogue;
+                epilogue->next = tmp;
+                /* Unroll jam inner loops of an unroll jammed loop. This is to
+                 * support multi-loop unroll jam. */
+                unroll_jam(infos, loop->body, s);
                 return;
+            } else {
+                unroll_jam(infos, loop->body, s);
             }
-            epilogue = clast_ast_dup(s);
-            update_epilogue_for_unrolling(epilogue);
-            unroll_jam_loop(s);
-            tmp = s->next;
-            s->next = epilogue;
-            epilogue->next = tmp;
-            /* Unroll jam inner loops of an unroll jammed loop. This is to
-             * support multi-loop unroll jam. */
-            unroll_jam(loop->body, s);
-            return;
-        } else {
-            unroll_jam(loop->body, s);
+        } else if(CLAST_STMT_IS_A(s, stmt_guard)) {
+            g = (struct clast_guard *)s;
+            unroll_jam(infos, g->then, s);
+        } else if (!CLAST_STMT_IS_A(s, stmt_user) &&
+                   !CLAST_STMT_IS_A(s, stmt_ass)) {
+            printf("Unkown statement found \n");
+            assert(0);
         }
-        prev = s;
-        s = s->next;
-        unroll_jam (s, prev);
-    } else if(CLAST_STMT_IS_A(s, stmt_guard)) {
-        g = (struct clast_guard *)s;
-        unroll_jam (g->then, s);
-        prev = s;
-        s = s->next;
-        unroll_jam(s, prev);
-    } else if (CLAST_STMT_IS_A(s, stmt_user) || CLAST_STMT_IS_A(s, stmt_ass)){
-        prev = s;
-        s = s->next;
-        unroll_jam (s, prev);
-    } else {
-        printf("Unkown statement found \n");
-        assert(0);
     }
 }
 
@@ -2499,16 +3974,16 @@ static char * clast_str_dup(const char *s)
 }
 
 /* Deep copy a for node in the AST. */
-static struct clast_for *clast_for_copy (struct clast_for *f)
+static struct clast_for *clast_for_copy(CloogInfos *infos, struct clast_for *f)
 {
     struct clast_expr *lb, *ub;
     const char *new_iterator;
     struct clast_for *new_for;
 
-    lb = clast_expr_copy(f->LB);
-    ub = clast_expr_copy(f->UB);
+    lb = clast_expr_copy(infos, f->LB);
+    ub = clast_expr_copy(infos, f->UB);
     new_iterator = f->iterator;
-    new_for = new_clast_for(f->domain, new_iterator, lb, ub, NULL);
+    new_for = alloc_clast_for(infos, f->domain, new_iterator, lb, ub, NULL);
     cloog_int_set(new_for->stride, f->stride);
     new_for->parallel = f->parallel;
     new_for->unroll_type = f->unroll_type;
@@ -2517,75 +3992,541 @@ static struct clast_for *clast_for_copy (struct clast_for *f)
     new_for->reduction_vars = clast_str_dup(f->reduction_vars);
     new_for->time_var_name = clast_str_dup(f->time_var_name);
     new_for->user_directive = clast_str_dup(f->user_directive);
-    new_for->body = clast_ast_dup(f->body);
+    new_for->body = clast_ast_dup(infos, f->body);
     return new_for;
 }
 
 /* Deep copy an assignment statement. */
-static struct clast_assignment *clast_assignment_copy(struct clast_assignment *a)
+static struct clast_assignment *clast_assignment_copy(CloogInfos *infos,
+	struct clast_assignment *a)
 {
     char *lhs;
     struct clast_expr *rhs;
     struct clast_assignment *new_a;
     lhs = clast_str_dup(a->LHS);
-    rhs = clast_expr_copy(a->RHS);
-    new_a = new_clast_assignment(lhs, rhs);
+    rhs = clast_expr_copy(infos, a->RHS);
+    new_a = alloc_clast_assignment(infos, lhs, rhs);
     return new_a;
 }
 
 /* Deep copy a user statement. */
-static struct clast_user_stmt *clast_user_stmt_copy(struct clast_user_stmt *u)
+static struct clast_user_stmt *clast_user_stmt_copy(CloogInfos *infos,
+	struct clast_user_stmt *u)
 {
     struct clast_stmt *new_subs;
     struct clast_user_stmt *new_u;
-    new_subs = clast_ast_dup(u->substitutions);
-    new_u = new_clast_user_stmt(u->domain, u->statement, new_subs);
+    new_subs = clast_ast_dup(infos, u->substitutions);
+    new_u = alloc_clast_user_stmt(infos, u->domain, u->statement, new_subs);
     return new_u;
 }
 
 /* Deep copy a guard statement. */
-static struct clast_guard * clast_guard_copy(struct clast_guard* g)
+static struct clast_guard * clast_guard_copy(CloogInfos *infos,
+	struct clast_guard* g)
 {
     int i;
-    struct clast_guard* new_g = new_clast_guard(g->n);
+    struct clast_guard* new_g = alloc_clast_guard(infos, g->n);
     for (i = 0; i < g->n; i++) {
-        new_g->eq[i].LHS = clast_expr_copy(g->eq[i].LHS);
-        new_g->eq[i].RHS = clast_expr_copy(g->eq[i].RHS);
+        new_g->eq[i].LHS = clast_expr_copy(infos, g->eq[i].LHS);
+        new_g->eq[i].RHS = clast_expr_copy(infos, g->eq[i].RHS);
         new_g->eq[i].sign = g->eq[i].sign;
     }
-    new_g->then = clast_ast_dup(g->then);
+    new_g->then = clast_ast_dup(infos, g->then);
     return new_g;
 }
 
 /* Duplicates the entire AST rooted at s. Returns a deep copy of the
  * AST under s. */
-static struct clast_stmt* clast_ast_dup(struct clast_stmt *s)
+static struct clast_stmt* clast_ast_dup(CloogInfos *infos, struct clast_stmt *s)
 {
-    struct clast_stmt *new_stmt;
+    struct clast_stmt *new_stmt, *first = NULL;
+    struct clast_stmt **next = &first;
     struct clast_for *f;
     struct clast_assignment *a;
     struct clast_user_stmt *u;
     struct clast_guard *g;
-    if (s == NULL)
-        return NULL;
-
-    if(CLAST_STMT_IS_A(s, stmt_for)) {
-        f = (struct clast_for *) s;
-        new_stmt = &clast_for_copy(f)->stmt;
-        new_stmt->next = clast_ast_dup(s->next);
-    } else if (CLAST_STMT_IS_A(s, stmt_ass)) {
-        a = (struct clast_assignment *) s;
-        new_stmt = &clast_assignment_copy(a)->stmt;
-        new_stmt->next = clast_ast_dup(s->next);
-    } else if (CLAST_STMT_IS_A(s, stmt_user)) {
-        u = (struct clast_user_stmt *) s;
-        new_stmt = &clast_user_stmt_copy(u)->stmt;
-        new_stmt->next = clast_ast_dup(s->next);
-    } else {
-        assert(CLAST_STMT_IS_A(s, stmt_guard));
-        g = (struct clast_guard *)s;
-        new_stmt = &clast_guard_copy(g)->stmt;
-        new_stmt->next = clast_ast_dup(s->next);
+
+    /* The siblings are copied iteratively, only the bodies recurse. */
+    for (; s; s = s->next) {
+        if(CLAST_STMT_IS_A(s, stmt_for)) {
+            f = (struct clast_for *) s;
+            new_stmt = &clast_for_copy(infos, f)->stmt;
+        } else if (CLAST_STMT_IS_A(s, stmt_ass)) {
+            a = (struct clast_assignment *) s;
+            new_stmt = &clast_assignment_copy(infos, a)->stmt;
+        } else if (CLAST_STMT_IS_A(s, stmt_user)) {
+            u = (struct clast_user_stmt *) s;
+            new_stmt = &clast_user_stmt_copy(infos, u)->stmt;
+        } else {
+            assert(CLAST_STMT_IS_A(s, stmt_guard));
+            g = (struct clast_guard *)s;
+            new_stmt = &clast_guard_copy(infos, g)->stmt;
+        }
+        *next = new_stmt;
+        next = &new_stmt->next;
+    }
+    *next = NULL;
+    return first;
+}
+
+
+/* State of clast_hoist_bounds.
+ * "loop" holds the loops enclosing the statement being visited, from
+ * loop[1] for the outermost one to loop[depth], and scope[d] is the index
+ * of the statement list receiving the temporaries that are invariant in
+ * the loops deeper than d, i.e., the body of loop[d] or the root for d = 0.
+ * Temporaries may not be placed at depth "barrier" or deeper.
+ * "assigned" is the sorted list of the names that are assigned somewhere
+ * in the clast.  The bounds that may be hoisted are collected in "cand".
+ */
+struct clast_hoist_candidate {
+    int scope;			/* Statement list receiving the temporary. */
+    int seq;			/* Order of appearance in the clast. */
+    int shared;			/* Only hoist if another bound is equal. */
+    struct clast_expr **slot;	/* Where the temporary is used. */
+    struct clast_expr *expr;	/* The expression computed by the temporary. */
+};
+
+struct clast_hoist {
+    CloogInfos *infos;
+
+    int depth;
+    int max_depth;
+    struct clast_for **loop;
+    int *scope;
+    int barrier;
+
+    int n_assigned;
+    const char **assigned;
+
+    int n_scope;
+    int size_scope;
+    struct clast_stmt ***insert;
+
+    int n;
+    int size;
+    struct clast_hoist_candidate *cand;
+};
+
+static void clast_hoist_collect_assigned(struct clast_hoist *h,
+					 struct clast_stmt *s, int *size)
+{
+    for (; s; s = s->next) {
+	if (CLAST_STMT_IS_A(s, stmt_ass)) {
+	    if (h->n_assigned >= *size) {
+		*size = 2 * *size + 16;
+		h->assigned = realloc(h->assigned, *size * sizeof(const char *));
+		if (!h->assigned)
+		    cloog_die("memory overflow.\n");
+	    }
+	    h->assigned[h->n_assigned++] = ((struct clast_assignment *) s)->LHS;
+	} else if (CLAST_STMT_IS_A(s, stmt_for))
+	    clast_hoist_collect_assigned(h, ((struct clast_for *) s)->body, size);
+	else if (CLAST_STMT_IS_A(s, stmt_guard))
+	    clast_hoist_collect_assigned(h, ((struct clast_guard *) s)->then,
+					 size);
+	else if (CLAST_STMT_IS_A(s, stmt_block))
+	    clast_hoist_collect_assigned(h, ((struct clast_block *) s)->body,
+					 size);
+    }
+}
+
+static int qsort_name_cmp(const void *p1, const void *p2)
+{
+    return strcmp(*(const char **) p1, *(const char **) p2);
+}
+
+static int clast_hoist_is_assigned(struct clast_hoist *h, const char *name)
+{
+    return h->n_assigned &&
+	   bsearch(&name, h->assigned, h->n_assigned, sizeof(const char *),
+		   qsort_name_cmp) != NULL;
+}
+
+/* Return the depth of the innermost enclosing loop whose iterator appears
+ * in "e", 0 if "e" only depends on parameters, or INT_MAX if "e" refers
+ * to an assigned variable, which may not be moved around.
+ */
+static int clast_hoist_level(struct clast_hoist *h, struct clast_expr *e)
+{
+    int i, level, l;
+
+    if (!e)
+	return 0;
+    switch (e->type) {
+    case clast_expr_name: {
+	const char *name = ((struct clast_name *) e)->name;
+	for (i = h->depth; i >= 1; --i)
+	    if (!strcmp(h->loop[i]->iterator, name))
+		return i;
+	return clast_hoist_is_assigned(h, name) ? INT_MAX : 0;
+    }
+    case clast_expr_term:
+	return clast_hoist_level(h, ((struct clast_term *) e)->var);
+    case clast_expr_bin:
+	return clast_hoist_level(h, ((struct clast_binary *) e)->LHS);
+    case clast_expr_red: {
+	struct clast_reduction *r = (struct clast_reduction *) e;
+	level = 0;
+	for (i = 0; i < r->n; ++i) {
+	    l = clast_hoist_level(h, r->elts[i]);
+	    if (l > level)
+		level = l;
+	}
+	return level;
+    }
+    }
+    return INT_MAX;
+}
+
+/* Is "e" worth a temporary, i.e., does it involve a division or
+ * a minimum or maximum?
+ */
+static int clast_hoist_costly(struct clast_expr *e)
+{
+    int i;
+
+    if (!e)
+	return 0;
+    switch (e->type) {
+    case clast_expr_name:
+	return 0;
+    case clast_expr_term:
+	return clast_hoist_costly(((struct clast_term *) e)->var);
+    case clast_expr_bin:
+	return 1;
+    case clast_expr_red: {
+	struct clast_reduction *r = (struct clast_reduction *) e;
+	if (r->n > 1 && r->type != clast_red_sum)
+	    return 1;
+	for (i = 0; i < r->n; ++i)
+	    if (clast_hoist_costly(r->elts[i]))
+		return 1;
+	return 0;
+    }
+    }
+    return 0;
+}
+
+static void clast_hoist_add(struct clast_hoist *h, int level, int shared,
+			    struct clast_expr **slot, struct clast_expr *expr)
+{
+    struct clast_hoist_candidate *c;
+
+    if (h->n >= h->size) {
+	h->size = 2 * h->size + 16;
+	h->cand = realloc(h->cand, h->size * sizeof(*h->cand));
+	if (!h->cand)
+	    cloog_die("memory overflow.\n");
+    }
+    c = &h->cand[h->n];
+    c->scope = h->scope[level];
+    c->seq = h->n++;
+    c->shared = shared;
+    c->slot = slot;
+    c->expr = expr;
+}
+
+/* Consider hoisting the loop bound at "slot" of a loop at depth
+ * h->depth + 1.  If the whole bound is invariant in the enclosing loop,
+ * it is hoisted out of that loop.  Otherwise, the elements of a minimum or
+ * maximum that are invariant in the enclosing loop are combined in
+ * a temporary on their own.  A bound that only depends on the enclosing
+ * loop is moved in front of it if a sibling loop shares the same bound.
+ */
+static void clast_hoist_bound(struct clast_hoist *h, struct clast_expr **slot)
+{
+    struct clast_expr *e = *slot;
+    struct clast_reduction *r, *group, *rest;
+    int d = h->depth;
+    int limit = d < h->barrier ? d : h->barrier;
+    int i, ng, pos, level, group_level, l;
+
+    if (!e || !clast_hoist_costly(e))
+	return;
+
+    level = clast_hoist_level(h, e);
+    if (level < limit) {
+	clast_hoist_add(h, level, 0, slot, e);
+	return;
+    }
+
+    if (e->type == clast_expr_red) {
+	r = (struct clast_reduction *) e;
+	ng = 0;
+	pos = -1;
+	group_level = 0;
+	if (r->type != clast_red_sum)
+	    for (i = 0; i < r->n; ++i) {
+		l = clast_hoist_level(h, r->elts[i]);
+		if (l >= limit)
+		    continue;
+		if (pos < 0)
+		    pos = i;
+		if (l > group_level)
+		    group_level = l;
+		ng++;
+	    }
+	if (ng > 1 || (ng == 1 && clast_hoist_costly(r->elts[pos]))) {
+	    group = ng > 1 ? alloc_clast_reduction(h->infos, r->type, ng) : NULL;
+	    rest = alloc_clast_reduction(h->infos, r->type, r->n - ng + 1);
+	    ng = 0;
+	    rest->n = 0;
+	    for (i = 0; i < r->n; ++i) {
+		if (clast_hoist_level(h, r->elts[i]) >= limit)
+		    rest->elts[rest->n++] = clast_expr_copy(h->infos,
+							    r->elts[i]);
+		else {
+		    if (i == pos)
+			rest->elts[rest->n++] = NULL;
+		    if (group)
+			group->elts[ng++] = clast_expr_copy(h->infos,
+							    r->elts[i]);
+		}
+	    }
+	    *slot = &rest->expr;
+	    clast_hoist_add(h, group_level, 0, &rest->elts[pos],
+			    group ? &group->expr :
+				    clast_expr_copy(h->infos, r->elts[pos]));
+	    free_clast_expr(e);
+	    return;
+	}
+    }
+
+    if (level == d && d < h->barrier)
+	clast_hoist_add(h, level, 1, slot, e);
+}
+
+static int clast_hoist_new_scope(struct clast_hoist *h,
+				 struct clast_stmt **insert)
+{
+    if (h->n_scope >= h->size_scope) {
+	h->size_scope = 2 * h->size_scope + 16;
+	h->insert = realloc(h->insert,
+			    h->size_scope * sizeof(struct clast_stmt **));
+	if (!h->insert)
+	    cloog_die("memory overflow.\n");
+    }
+    h->insert[h->n_scope] = insert;
+    return h->n_scope++;
+}
+
+/* Collect the loop bounds that may be hoisted in the list "s" and
+ * the statements nested in it.  Loops marked for parallel execution or
+ * unrolling do not receive temporaries, since those would be shared
+ * among threads or not be updated by unrolling.
+ */
+static void clast_hoist_walk(struct clast_hoist *h, struct clast_stmt *s)
+{
+    int barrier;
+    struct clast_for *f;
+
+    for (; s; s = s->next) {
+	if (CLAST_STMT_IS_A(s, stmt_for)) {
+	    f = (struct clast_for *) s;
+	    clast_hoist_bound(h, &f->LB);
+	    clast_hoist_bound(h, &f->UB);
+
+	    if (h->depth + 1 >= h->max_depth) {
+		h->max_depth = 2 * h->max_depth + 16;
+		h->loop = realloc(h->loop,
+				  h->max_depth * sizeof(struct clast_for *));
+		h->scope = realloc(h->scope, h->max_depth * sizeof(int));
+		if (!h->loop || !h->scope)
+		    cloog_die("memory overflow.\n");
+	    }
+	    h->depth++;
+	    h->loop[h->depth] = f;
+	    h->scope[h->depth] = clast_hoist_new_scope(h, &f->body);
+	    barrier = h->barrier;
+	    if ((f->parallel || f->unroll_type != clast_no_unroll) &&
+		h->depth < h->barrier)
+		h->barrier = h->depth;
+
+	    clast_hoist_walk(h, f->body);
+
+	    h->barrier = barrier;
+	    h->depth--;
+	} else if (CLAST_STMT_IS_A(s, stmt_guard))
+	    clast_hoist_walk(h, ((struct clast_guard *) s)->then);
+	else if (CLAST_STMT_IS_A(s, stmt_block))
+	    clast_hoist_walk(h, ((struct clast_block *) s)->body);
+    }
+}
+
+static int qsort_hoist_cmp(const void *p1, const void *p2)
+{
+    const struct clast_hoist_candidate *c1 = p1;
+    const struct clast_hoist_candidate *c2 = p2;
+    int c;
+
+    if (c1->scope != c2->scope)
+	return c1->scope - c2->scope;
+    c = clast_expr_cmp(c1->expr, c2->expr);
+    if (c)
+	return c;
+    return c1->seq - c2->seq;
+}
+
+/* A group of "n" candidates starting at "first" in the sorted array of
+ * candidates, the first of which appears at position "seq" in the clast.
+ */
+struct clast_hoist_run {
+    int seq;
+    int first;
+    int n;
+};
+
+static int qsort_hoist_run_cmp(const void *p1, const void *p2)
+{
+    const struct clast_hoist_run *r1 = p1;
+    const struct clast_hoist_run *r2 = p2;
+
+    return r1->seq - r2->seq;
+}
+
+/* Is "name" already used by a parameter, iterator or variable of
+ * the clast rooted at "r"?
+ */
+static int clast_hoist_name_used(struct clast_hoist *h, struct clast_root *r,
+				 const char *name)
+{
+    CloogNames *names = r->names;
+    int i;
+
+    for (i = 0; i < names->nb_parameters; ++i)
+	if (!strcmp(names->parameters[i], name))
+	    return 1;
+    for (i = 0; i < names->nb_iterators; ++i)
+	if (!strcmp(names->iterators[i], name))
+	    return 1;
+    for (i = 0; i < names->nb_scattering; ++i)
+	if (!strcmp(names->scattering[i], name))
+	    return 1;
+    for (i = 0; i < r->nb_temporaries; ++i)
+	if (!strcmp(r->temporaries[i], name))
+	    return 1;
+    return clast_hoist_is_assigned(h, name);
+}
+
+/* Return a fresh name for a temporary of the clast rooted at "r",
+ * which keeps track of it.
+ */
+static const char *clast_hoist_name(struct clast_hoist *h,
+				    struct clast_root *r, int *counter)
+{
+    char buffer[32];
+    char *name;
+
+    do
+	snprintf(buffer, sizeof(buffer), "t%d", ++*counter);
+    while (clast_hoist_name_used(h, r, buffer));
+
+    name = strdup(buffer);
+    r->temporaries = realloc(r->temporaries,
+			     (r->nb_temporaries + 1) * sizeof(char *));
+    if (!name || !r->temporaries)
+	cloog_die("memory overflow.\n");
+    r->temporaries[r->nb_temporaries++] = name;
+    return name;
+}
+
+/* Replace the candidates h->cand[first..last-1], which compute the same
+ * expression in the same statement list, by a temporary assigned at
+ * the beginning of that list.  The assignment takes over the expression
+ * of the first candidate, the others are released.
+ */
+static void clast_hoist_apply(struct clast_hoist *h, struct clast_root *r,
+			      struct clast_hoist_candidate *c, int n,
+			      int *counter)
+{
+    struct clast_assignment *a;
+    struct clast_stmt ***insert = &h->insert[c[0].scope];
+    const char *name = clast_hoist_name(h, r, counter);
+    int i;
+
+    a = alloc_clast_assignment(h->infos, name, c[0].expr);
+    *c[0].slot = &alloc_clast_name(h->infos, name)->expr;
+    for (i = 1; i < n; ++i) {
+	free_clast_expr(c[i].expr);
+	*c[i].slot = &alloc_clast_name(h->infos, name)->expr;
+    }
+
+    a->stmt.next = **insert;
+    **insert = &a->stmt;
+    *insert = &a->stmt.next;
+}
+
+/* Hoist the loop-invariant parts of the loop bounds of the clast rooted
+ * at "s" into temporaries.  Each temporary is assigned at the beginning
+ * of the body of the outermost loop in which it is invariant, or at
+ * the top of the clast, and equal bounds in the same body share
+ * a temporary.  The names of the temporaries, which the user has to
+ * declare, are kept in the root.  This should be called after loops
+ * have been marked for parallel execution or unrolling.
+ */
+void clast_hoist_bounds(struct clast_stmt *s)
+{
+    struct clast_root *r;
+    struct clast_hoist h;
+    CloogInfos infos;
+    struct clast_hoist_run *run;
+    int size = 0, counter = 0;
+    int i, j, n_run;
+
+    if (!s || !CLAST_STMT_IS_A(s, stmt_root))
+	return;
+    r = (struct clast_root *) s;
+
+    /* New nodes belong to the arena of the clast, if any. */
+    memset(&infos, 0, sizeof(infos));
+    infos.arena = r->arena;
+    infos.intern = r->intern;
+
+    memset(&h, 0, sizeof(h));
+    h.infos = &infos;
+    h.barrier = INT_MAX;
+    clast_hoist_collect_assigned(&h, s->next, &size);
+    if (h.n_assigned)
+	qsort(h.assigned, h.n_assigned, sizeof(const char *), qsort_name_cmp);
+    h.max_depth = 16;
+    h.loop = ALLOCN(struct clast_for *, h.max_depth);
+    h.scope = ALLOCN(int, h.max_depth);
+    if (!h.loop || !h.scope)
+	cloog_die("memory overflow.\n");
+    h.scope[0] = clast_hoist_new_scope(&h, &s->next);
+
+    clast_hoist_walk(&h, s->next);
+
+    /* Group the candidates with equal expressions in the same list and
+     * create the temporaries in order of appearance.
+     */
+    if (h.n)
+	qsort(h.cand, h.n, sizeof(*h.cand), qsort_hoist_cmp);
+    run = ALLOCN(struct clast_hoist_run, h.n + 1);
+    if (!run)
+	cloog_die("memory overflow.\n");
+    n_run = 0;
+    for (i = 0; i < h.n; i = j) {
+	for (j = i + 1; j < h.n; ++j)
+	    if (h.cand[j].scope != h.cand[i].scope ||
+		clast_expr_cmp(h.cand[j].expr, h.cand[i].expr))
+		break;
+	if (j - i == 1 && h.cand[i].shared)
+	    continue;
+	run[n_run].seq = h.cand[i].seq;
+	run[n_run].first = i;
+	run[n_run].n = j - i;
+	n_run++;
     }
-    return new_stmt;
+    qsort(run, n_run, sizeof(*run), qsort_hoist_run_cmp);
+    for (i = 0; i < n_run; ++i)
+	clast_hoist_apply(&h, r, &h.cand[run[i].first], run[i].n, &counter);
+
+    free(run);
+    free(h.cand);
+    free(h.insert);
+    free(h.scope);
+    free(h.loop);
+    free(h.assigned);
 }
@@ -45,12 +45,20 @@ int main(int argv, char * argc[])
   CloogOptions * options ;
   CloogState *state;
   FILE * input, * output ;
+  jmp_buf overflow ;
    
   state = cloog_state_malloc();
 
   /* Options and input/output file setting. */
   cloog_options_read(state, argv, argc, &input, &output, &options);
 
+  /* An integer overflow with the checked integer type comes back here. */
+  if (setjmp(overflow))
+  { fclose(output) ;
+    return CLOOG_INT_OVERFLOW_STATUS ;
+  }
+  cloog_int_set_overflow_handler(&overflow) ;
+
   /* Reading the program informations. */
   program = cloog_program_read(input,options) ;
   fclose(input) ;
@@ -61,6 +69,7 @@ int main(int argv, char * argc[])
   cloog_program_print(stdout,program) ;
   cloog_program_pprint(output,program,options) ;
   cloog_program_free(program) ;
+  cloog_int_set_overflow_handler(NULL) ;
 
   /* Printing the allocation statistics if asked. */
   if (options->leaks) {
@@ -72,8 +81,18 @@ int main(int argv, char * argc[])
            state->statement_allocated, state->statement_freed, state->statement_max);
     fprintf(output,"/* Blocks     : allocated=%5d, freed=%5d, max=%5d. */\n",
            state->block_allocated, state->block_freed, state->block_max);
+    fprintf(output,"/* Components : edges=%5d, tests=%5d, avoided=%5d. */\n",
+           state->components_edges, state->components_tests,
+           state->components_avoided);
+    if (options->domain_cache > 0)
+      fprintf(output,"/* Domain cache: hits=%5d, misses=%5d. */\n",
+             state->domain_cache_hits, state->domain_cache_misses);
   }
 
+  /* Printing the per-phase statistics if asked. */
+  if (options->stats)
+    cloog_state_print_stats_json(stderr, state);
+
   /* Inform the user in case of a problem with the allocation statistics. */
   if ((state->domain_allocated    != state->domain_freed)    ||
       (state->loop_allocated      != state->loop_freed)      ||
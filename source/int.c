@@ -22,6 +22,302 @@ cloog_int_t cloog_gcd(cloog_int_t a, cloog_int_t b)
 
 #endif
 
+/* On x86-64, the row operations on 64 bit machine integers have
+ * SSE4.2 and AVX2 versions, selected at run time.
+ */
+#if (defined(CLOOG_INT_LONG_LONG) || \
+     (defined(CLOOG_INT_LONG) && __SIZEOF_LONG__ == 8)) && \
+    defined(__GNUC__) && defined(__x86_64__)
+#define CLOOG_SEQ_SIMD
+
+#include <immintrin.h>
+
+#define SEQ_W		4
+#define SEQ_TARGET	"avx2"
+#define SEQ_ANY(v)	!_mm256_testz_si256((__m256i) (v), (__m256i) (v))
+#define SEQ_FN(name)	cloog_seq_avx2_ ## name
+#include "int_simd_templ.c"
+#undef SEQ_W
+#undef SEQ_TARGET
+#undef SEQ_ANY
+#undef SEQ_FN
+
+#define SEQ_W		2
+#define SEQ_TARGET	"sse4.2"
+#define SEQ_ANY(v)	!_mm_testz_si128((__m128i) (v), (__m128i) (v))
+#define SEQ_FN(name)	cloog_seq_sse4_ ## name
+#include "int_simd_templ.c"
+#undef SEQ_W
+#undef SEQ_TARGET
+#undef SEQ_ANY
+#undef SEQ_FN
+
+#define cloog_seq_avx2()	__builtin_cpu_supports("avx2")
+#define cloog_seq_sse4()	__builtin_cpu_supports("sse4.2")
+
+#endif
+
+/* The overflow handler of the current thread, see cloog_int_overflow. */
+#if defined(CLOOG_THREADS) && defined(__GNUC__)
+static __thread jmp_buf *cloog_int_overflow_env;
+#else
+static jmp_buf *cloog_int_overflow_env;
+#endif
+
+jmp_buf *cloog_int_overflow_handler(void)
+{
+	return cloog_int_overflow_env;
+}
+
+void cloog_int_set_overflow_handler(jmp_buf *env)
+{
+	cloog_int_overflow_env = env;
+}
+
+#if defined(CLOOG_INT_CHECKED)
+
+#include <errno.h>
+
+/* Report the overflow and jump back to the entry point that set the
+ * overflow handler, which returns an error.  Without a handler, exit with
+ * a status of its own, such that the caller can tell it from other errors
+ * and run a GMP build instead.
+ */
+void cloog_int_overflow(void)
+{
+	cloog_msg(NULL, CLOOG_ERROR, "integer overflow, CLooG must be "
+		  "configured with --with-cloog-int=gmp to handle this input.\n");
+	if (cloog_int_overflow_env)
+		longjmp(*cloog_int_overflow_env, 1);
+	exit(CLOOG_INT_OVERFLOW_STATUS);
+}
+
+int cloog_int_checked_read(cloog_int_t *r, const char *s)
+{
+	char *end;
+
+	errno = 0;
+	*r = strtoll(s, &end, 10);
+	if (end == s)
+		return 0;
+	if (errno == ERANGE)
+		cloog_int_overflow();
+	return 1;
+}
+
+#endif
+
+#if defined(CLOOG_INT_GMP)
+
+typedef void (*cloog_sio_gmp_free_t)(void *, size_t);
+
+void cloog_sio_free(cloog_sio *r)
+{
+	mpz_ptr z = cloog_sio_big(*r);
+
+	mpz_clear(z);
+	free(z);
+	*r = cloog_sio_from_small(0);
+}
+
+/* Make sure "r" is represented by an mpz_t, keeping its value,
+ * and return that mpz_t.
+ */
+static mpz_ptr cloog_sio_make_big(cloog_sio *r)
+{
+	mpz_ptr z;
+
+	if (!cloog_sio_is_small(*r))
+		return cloog_sio_big(*r);
+	z = ALLOC(__mpz_struct);
+	if (!z)
+		cloog_die("memory overflow.\n");
+	mpz_init_set_si(z, cloog_sio_small(*r));
+	*r = (cloog_sio) (uintptr_t) z;
+	return z;
+}
+
+/* Return the small representation of "r" again if its value
+ * fits in 32 bits, such that every value has a unique representation.
+ */
+static void cloog_sio_demote(cloog_sio *r)
+{
+	mpz_ptr z;
+
+	if (cloog_sio_is_small(*r))
+		return;
+	z = cloog_sio_big(*r);
+	if (mpz_cmp_si(z, INT32_MIN) >= 0 && mpz_cmp_si(z, INT32_MAX) <= 0)
+		cloog_sio_set_si64(r, mpz_get_si(z));
+}
+
+/* Storage for a read-only mpz_t view of a small integer. */
+struct cloog_sio_view {
+	__mpz_struct z;
+	mp_limb_t limb;
+};
+
+/* Return an mpz_t holding the value of "i", using "view" as storage
+ * if "i" is small.  The view points to a single limb in "view" itself,
+ * so it is built without any allocation and does not need to be cleared.
+ */
+static mpz_srcptr cloog_sio_src(const cloog_sio *i,
+	struct cloog_sio_view *view)
+{
+	int64_t v;
+
+	if (!cloog_sio_is_small(*i))
+		return cloog_sio_big(*i);
+	v = cloog_sio_small(*i);
+	view->limb = v < 0 ? -v : v;
+#if __GNU_MP_VERSION >= 6
+	return mpz_roinit_n(&view->z, &view->limb, v < 0 ? -1 : v > 0);
+#else
+	view->z._mp_alloc = 1;
+	view->z._mp_size = v < 0 ? -1 : v > 0;
+	view->z._mp_d = &view->limb;
+	return &view->z;
+#endif
+}
+
+static void cloog_sio_set_mpz_si64(mpz_ptr z, int64_t v)
+{
+	uint64_t u = v < 0 ? -(uint64_t) v : (uint64_t) v;
+
+	if (sizeof(long) >= sizeof(int64_t)) {
+		mpz_set_si(z, (long) v);
+		return;
+	}
+	mpz_set_ui(z, (unsigned long) (u >> 32));
+	mpz_mul_2exp(z, z, 32);
+	mpz_add_ui(z, z, (unsigned long) (u & 0xffffffffUL));
+	if (v < 0)
+		mpz_neg(z, z);
+}
+
+void cloog_sio_set_big(cloog_sio *r, int64_t v)
+{
+	cloog_sio_set_mpz_si64(cloog_sio_make_big(r), v);
+}
+
+/* The operands are converted before "r" is promoted,
+ * since "r" may be the same as one of them.
+ */
+void cloog_sio_apply(cloog_sio *r, const cloog_sio *i, const cloog_sio *j,
+	cloog_sio_binop op)
+{
+	struct cloog_sio_view ti, tj;
+	mpz_srcptr a, b;
+
+	a = cloog_sio_src(i, &ti);
+	b = cloog_sio_src(j, &tj);
+	op(cloog_sio_make_big(r), a, b);
+	cloog_sio_demote(r);
+}
+
+void cloog_sio_apply_unop(cloog_sio *r, const cloog_sio *i,
+	cloog_sio_unop op)
+{
+	struct cloog_sio_view ti;
+	mpz_srcptr a;
+
+	a = cloog_sio_src(i, &ti);
+	op(cloog_sio_make_big(r), a);
+	cloog_sio_demote(r);
+}
+
+void cloog_sio_apply_ui(cloog_sio *r, const cloog_sio *i, unsigned long j,
+	cloog_sio_binop_ui op)
+{
+	struct cloog_sio_view ti;
+	mpz_srcptr a;
+
+	a = cloog_sio_src(i, &ti);
+	op(cloog_sio_make_big(r), a, j);
+	cloog_sio_demote(r);
+}
+
+int cloog_sio_cmp_big(const cloog_sio *i, const cloog_sio *j)
+{
+	int res;
+	struct cloog_sio_view ti, tj;
+
+	res = mpz_cmp(cloog_sio_src(i, &ti), cloog_sio_src(j, &tj));
+	return res;
+}
+
+int cloog_sio_abs_cmp_big(const cloog_sio *i, const cloog_sio *j)
+{
+	int res;
+	struct cloog_sio_view ti, tj;
+
+	res = mpz_cmpabs(cloog_sio_src(i, &ti), cloog_sio_src(j, &tj));
+	return res;
+}
+
+int cloog_sio_divisible_big(const cloog_sio *i, const cloog_sio *j)
+{
+	int res;
+	struct cloog_sio_view ti, tj;
+
+	res = mpz_divisible_p(cloog_sio_src(i, &ti), cloog_sio_src(j, &tj));
+	return res;
+}
+
+long cloog_sio_get_si(const cloog_sio *i)
+{
+	if (cloog_sio_is_small(*i))
+		return cloog_sio_small(*i);
+	return mpz_get_si(cloog_sio_big(*i));
+}
+
+double cloog_sio_get_d(const cloog_sio *i)
+{
+	if (cloog_sio_is_small(*i))
+		return cloog_sio_small(*i);
+	return mpz_get_d(cloog_sio_big(*i));
+}
+
+void cloog_sio_get_mpz(mpz_ptr r, const cloog_sio *i)
+{
+	if (cloog_sio_is_small(*i))
+		mpz_set_si(r, cloog_sio_small(*i));
+	else
+		mpz_set(r, cloog_sio_big(*i));
+}
+
+void cloog_sio_set_mpz(cloog_sio *r, mpz_srcptr i)
+{
+	mpz_set(cloog_sio_make_big(r), i);
+	cloog_sio_demote(r);
+}
+
+int cloog_sio_read(cloog_sio *r, const char *s)
+{
+	int res;
+
+	res = mpz_set_str(cloog_sio_make_big(r), s, 10);
+	cloog_sio_demote(r);
+	return res;
+}
+
+void cloog_sio_print(FILE *out, const cloog_sio *i)
+{
+	char *s;
+	cloog_sio_gmp_free_t gmp_free;
+
+	if (cloog_sio_is_small(*i)) {
+		fprintf(out, "%d", (int) cloog_sio_small(*i));
+		return;
+	}
+	s = mpz_get_str(0, 10, cloog_sio_big(*i));
+	fprintf(out, "%s", s);
+	mp_get_memory_functions(NULL, NULL, &gmp_free);
+	(*gmp_free)(s, strlen(s)+1);
+}
+
+#endif
+
 struct cloog_vec *cloog_vec_alloc(unsigned size)
 {
 	unsigned int i;
@@ -73,6 +369,12 @@ int cloog_seq_first_non_zero(cloog_int_t *p, unsigned len)
 {
 	int i;
 
+#ifdef CLOOG_SEQ_SIMD
+	if (cloog_seq_avx2())
+		return cloog_seq_avx2_first_non_zero(p, len);
+	if (cloog_seq_sse4())
+		return cloog_seq_sse4_first_non_zero(p, len);
+#endif
 	for (i = 0; i < (int) len; ++i)
 		if (!cloog_int_is_zero(p[i]))
 			return i;
@@ -82,6 +384,16 @@ int cloog_seq_first_non_zero(cloog_int_t *p, unsigned len)
 void cloog_seq_neg(cloog_int_t *dst, cloog_int_t *src, unsigned len)
 {
 	unsigned int i;
+#ifdef CLOOG_SEQ_SIMD
+	if (cloog_seq_avx2()) {
+		cloog_seq_avx2_neg(dst, src, len);
+		return;
+	}
+	if (cloog_seq_sse4()) {
+		cloog_seq_sse4_neg(dst, src, len);
+		return;
+	}
+#endif
 	for (i = 0; i < len; ++i)
 		cloog_int_neg(dst[i], src[i]);
 }
@@ -106,6 +418,16 @@ void cloog_seq_combine(cloog_int_t *dst, cloog_int_t m1, cloog_int_t *src1,
 	unsigned int i;
 	cloog_int_t tmp;
 
+#ifdef CLOOG_SEQ_SIMD
+	if (cloog_seq_avx2()) {
+		cloog_seq_avx2_combine(dst, m1, src1, m2, src2, len);
+		return;
+	}
+	if (cloog_seq_sse4()) {
+		cloog_seq_sse4_combine(dst, m1, src1, m2, src2, len);
+		return;
+	}
+#endif
 	cloog_int_init(tmp);
 	for (i = 0; i < len; ++i) {
 		cloog_int_mul(tmp, m1, src1[i]);
@@ -131,8 +453,19 @@ static int cloog_seq_abs_min_non_zero(cloog_int_t *p, unsigned len)
 
 void cloog_seq_gcd(cloog_int_t *p, unsigned len, cloog_int_t *gcd)
 {
-	int i, min = cloog_seq_abs_min_non_zero(p, len);
+	int i, min;
 
+#ifdef CLOOG_SEQ_SIMD
+	if (cloog_seq_avx2()) {
+		cloog_seq_avx2_gcd(p, len, gcd);
+		return;
+	}
+	if (cloog_seq_sse4()) {
+		cloog_seq_sse4_gcd(p, len, gcd);
+		return;
+	}
+#endif
+	min = cloog_seq_abs_min_non_zero(p, len);
 	if (min < 0) {
 		cloog_int_set_si(*gcd, 0);
 		return;
@@ -169,6 +502,16 @@ void cloog_seq_normalize(cloog_int_t *p, unsigned len)
 	if (len == 0)
 		return;
 
+#ifdef CLOOG_SEQ_SIMD
+	if (cloog_seq_avx2()) {
+		cloog_seq_avx2_normalize(p, len);
+		return;
+	}
+	if (cloog_seq_sse4()) {
+		cloog_seq_sse4_normalize(p, len);
+		return;
+	}
+#endif
 	cloog_int_init(gcd);
 	cloog_seq_gcd(p, len, &gcd);
 	if (!cloog_int_is_zero(gcd) && !cloog_int_is_one(gcd))
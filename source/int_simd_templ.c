@@ -0,0 +1,156 @@
+/* Row kernels of source/int.c on vectors of SEQ_W 64 bit lanes.
+ * This file is included once per instruction set, with SEQ_W,
+ * SEQ_TARGET, SEQ_ANY and SEQ_FN defined by the includer.
+ */
+
+typedef long long SEQ_FN(vec)
+	__attribute__((vector_size(8 * SEQ_W), aligned(8), __may_alias__));
+typedef unsigned long long SEQ_FN(uvec)
+	__attribute__((vector_size(8 * SEQ_W), aligned(8), __may_alias__));
+
+#define SEQ_V	SEQ_FN(vec)
+#define SEQ_U	SEQ_FN(uvec)
+
+__attribute__((target(SEQ_TARGET)))
+static int SEQ_FN(first_non_zero)(cloog_int_t *p, unsigned len)
+{
+	unsigned i, l;
+
+	for (i = 0; i + SEQ_W <= len; i += SEQ_W) {
+		SEQ_V v = *(SEQ_V *) (p + i);
+		if (!SEQ_ANY(v))
+			continue;
+		for (l = 0; l < SEQ_W; ++l)
+			if (v[l])
+				return i + l;
+	}
+	for (; i < len; ++i)
+		if (p[i])
+			return i;
+	return -1;
+}
+
+__attribute__((target(SEQ_TARGET)))
+static void SEQ_FN(neg)(cloog_int_t *dst, cloog_int_t *src, unsigned len)
+{
+	unsigned i;
+
+	for (i = 0; i + SEQ_W <= len; i += SEQ_W)
+		*(SEQ_U *) (dst + i) = -*(SEQ_U *) (src + i);
+	for (; i < len; ++i)
+		dst[i] = -src[i];
+}
+
+/* The products wrap around exactly like the scalar ones do. */
+__attribute__((target(SEQ_TARGET)))
+static void SEQ_FN(combine)(cloog_int_t *dst, cloog_int_t m1,
+	cloog_int_t *src1, cloog_int_t m2, cloog_int_t *src2, unsigned len)
+{
+	unsigned i;
+	SEQ_U v1 = (SEQ_U) { 0 } + (unsigned long long) m1;
+	SEQ_U v2 = (SEQ_U) { 0 } + (unsigned long long) m2;
+
+	for (i = 0; i + SEQ_W <= len; i += SEQ_W)
+		*(SEQ_U *) (dst + i) = v1 * *(SEQ_U *) (src1 + i) +
+				       v2 * *(SEQ_U *) (src2 + i);
+	for (; i < len; ++i)
+		dst[i] = m1 * src1[i] + m2 * src2[i];
+}
+
+/* Binary gcd of each pair of lanes of "u" and "v".
+ * A lane is done as soon as one of its two values is zero.
+ * While both are even, the common factor 2 is counted in "s".
+ * When only one of them is even, it is halved.  When both are odd,
+ * the smaller one is kept and the larger is replaced by half
+ * the (even) difference.
+ */
+__attribute__((target(SEQ_TARGET)))
+static SEQ_U SEQ_FN(gcd_lanes)(SEQ_U u, SEQ_U v)
+{
+	SEQ_U s = { 0 };
+
+	for (;;) {
+		SEQ_U active = (SEQ_U) (u != 0) & (SEQ_U) (v != 0);
+		SEQ_U ue, ve, odd, gt, mn, mx;
+
+		if (!SEQ_ANY(active))
+			break;
+		ue = (SEQ_U) ((u & 1) == 0) & active;
+		ve = (SEQ_U) ((v & 1) == 0) & active;
+		odd = active & ~ue & ~ve;
+		s -= ue & ve;
+		gt = (SEQ_U) (u > v);
+		mn = (v & gt) | (u & ~gt);
+		mx = (u & gt) | (v & ~gt);
+		u = (u >> (ue & 1)) & ~odd;
+		u |= mn & odd;
+		v = (v >> (ve & 1)) & ~odd;
+		v |= ((mx - mn) >> 1) & odd;
+	}
+	return (u | v) << s;
+}
+
+/* Fold the absolute values of the elements into SEQ_W lanes of
+ * partial gcds and combine those at the end.  A partial gcd of one
+ * means the whole gcd is one.
+ */
+__attribute__((target(SEQ_TARGET)))
+static void SEQ_FN(gcd)(cloog_int_t *p, unsigned len, cloog_int_t *gcd)
+{
+	unsigned i, l;
+	SEQ_U g = { 0 };
+	cloog_int_t r = 0;
+
+	for (i = 0; i + SEQ_W <= len; i += SEQ_W) {
+		SEQ_V v = *(SEQ_V *) (p + i);
+		SEQ_V sign = v >> 63;
+		g = SEQ_FN(gcd_lanes)(g, (SEQ_U) ((v ^ sign) - sign));
+		if (SEQ_ANY(g == 1)) {
+			*gcd = 1;
+			return;
+		}
+	}
+	for (l = 0; l < SEQ_W; ++l)
+		r = cloog_gcd(r, g[l]);
+	for (; i < len && r != 1; ++i)
+		r = cloog_gcd(r, p[i]);
+	*gcd = r;
+}
+
+/* Divide the elements of "p", which are all multiples of "d" > 1,
+ * by "d".  Exact division by the odd part of "d" is a multiplication
+ * by its inverse modulo 2^64, exact division by the power of two
+ * an arithmetic shift.
+ */
+__attribute__((target(SEQ_TARGET)))
+static void SEQ_FN(scale_down)(cloog_int_t *p, cloog_int_t d, unsigned len)
+{
+	unsigned i;
+	int k = __builtin_ctzll(d);
+	unsigned long long odd = (unsigned long long) d >> k;
+	unsigned long long inv = odd;
+	SEQ_U vinv;
+
+	for (i = 0; i < 5; ++i)
+		inv *= 2 - odd * inv;
+	vinv = (SEQ_U) { 0 } + inv;
+	for (i = 0; i + SEQ_W <= len; i += SEQ_W) {
+		SEQ_U y = *(SEQ_U *) (p + i) * vinv;
+		*(SEQ_V *) (p + i) = (SEQ_V) y >> k;
+	}
+	for (; i < len; ++i)
+		p[i] /= d;
+}
+
+__attribute__((target(SEQ_TARGET)))
+static void SEQ_FN(normalize)(cloog_int_t *p, unsigned len)
+{
+	cloog_int_t gcd;
+
+	SEQ_FN(gcd)(p, len, &gcd);
+	if (gcd > 1)
+		SEQ_FN(scale_down)(p, gcd, len);
+}
+
+#undef SEQ_V
+#undef SEQ_U
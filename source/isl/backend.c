@@ -22,6 +22,10 @@ CloogState *cloog_isl_state_malloc(struct isl_ctx *ctx)
 	state->backend = isl_alloc_type(ctx, CloogBackend);
 	state->backend->ctx = ctx;
 	state->backend->ctx_allocated = allocated;
+	state->backend->worker_ctx = NULL;
+	state->backend->nb_worker_ctx = 0;
+	state->backend->memo = NULL;
+
 	return state;
 }
 
@@ -30,6 +34,13 @@ CloogState *cloog_isl_state_malloc(struct isl_ctx *ctx)
  */
 void cloog_state_free(CloogState *state)
 {
+	int i;
+
+	cloog_domain_memo_free(state->backend->memo);
+
+	for (i = 0; i < state->backend->nb_worker_ctx; ++i)
+		isl_ctx_free(state->backend->worker_ctx[i]);
+	free(state->backend->worker_ctx);
 	if (state->backend->ctx_allocated)
 		isl_ctx_free(state->backend->ctx);
 	free(state->backend);
@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <limits.h>
 #include <cloog/isl/cloog.h>
 #include <cloog/isl/backend.h>
 #include <isl/aff.h>
@@ -24,16 +25,28 @@ __isl_give isl_val *cloog_int_to_isl_val(isl_ctx* ctx, cloog_int_t c)
 	v = isl_val_int_from_si(ctx, c);
 #elif defined(CLOOG_INT_LONG_LONG)
 	v = isl_val_int_from_si(ctx, c);
+#elif defined(CLOOG_INT_CHECKED)
+	if (c < LONG_MIN || c > LONG_MAX)
+		cloog_int_overflow();
+	v = isl_val_int_from_si(ctx, c);
 #elif defined(CLOOG_INT_GMP)
+  if (cloog_sio_is_small(*c))
+    return isl_val_int_from_si(ctx, cloog_sio_small(*c));
+  {
+    mpz_t z;
+    mpz_init(z);
+    cloog_int_get_mpz(z, c);
   #if ISL_USING_GMP // ISL using GMP
-    v = isl_val_int_from_gmp(ctx, c);
+    v = isl_val_int_from_gmp(ctx, z);
   #else // ISL using iMath or iMath-32
     // The best way to ensure full precision is to go through strings!!!
     char* str = NULL;
-    str = mpz_get_str(str, 10, c);
+    str = mpz_get_str(str, 10, z);
     v = isl_val_read_from_str(ctx, str);
     free(str);
   #endif
+    mpz_clear(z);
+  }
 #else
 #error "No integer type defined"
 #endif
@@ -53,14 +66,29 @@ void isl_val_to_cloog_int(__isl_keep isl_val *val, cloog_int_t *cint)
 	*cint = isl_val_get_num_si(val);
 #elif defined(CLOOG_INT_LONG_LONG)
 	*cint = isl_val_get_num_si(val);
+#elif defined(CLOOG_INT_CHECKED)
+	if (isl_val_cmp_si(val, LONG_MIN) < 0 || isl_val_cmp_si(val, LONG_MAX) > 0)
+		cloog_int_overflow();
+	*cint = isl_val_get_num_si(val);
 #elif defined(CLOOG_INT_GMP)
+  if (isl_val_cmp_si(val, INT32_MIN) >= 0 &&
+      isl_val_cmp_si(val, INT32_MAX) <= 0) {
+    cloog_int_set_si(*cint, isl_val_get_num_si(val));
+    return;
+  }
   #if ISL_USING_GMP
-    isl_val_get_num_gmp(val, *cint);
+  {
+    mpz_t z;
+    mpz_init(z);
+    isl_val_get_num_gmp(val, z);
+    cloog_int_set_mpz(*cint, z);
+    mpz_clear(z);
+  }
   #else
     isl_printer *string_printer = isl_printer_to_str(isl_val_get_ctx(val));
     isl_printer_print_val(string_printer, val);
     char *str = isl_printer_get_str(string_printer);
-    mpz_set_str(*cint, str, 10);
+    cloog_int_read(*cint, str);
     isl_printer_free(string_printer);
     free(str);
   #endif
@@ -72,7 +100,19 @@ void isl_val_to_cloog_int(__isl_keep isl_val *val, cloog_int_t *cint)
 
 CloogConstraintSet *cloog_constraint_set_from_isl_basic_set(struct isl_basic_set *bset)
 {
-	return (CloogConstraintSet *)bset;
+	CloogConstraintSet *constraints;
+
+	constraints = ALLOC(CloogConstraintSet);
+	constraints->ref = 1;
+	constraints->bset = bset;
+	constraints->n = -1;
+	constraints->total = 0;
+	constraints->constraints = NULL;
+	constraints->flags = NULL;
+	constraints->sign = NULL;
+	constraints->start = NULL;
+	constraints->index = NULL;
+	return constraints;
 }
 
 CloogConstraint *cloog_constraint_from_isl_constraint(struct isl_constraint *constraint)
@@ -87,7 +127,20 @@ isl_constraint *cloog_constraint_to_isl(CloogConstraint *constraint)
 
 isl_basic_set *cloog_constraints_set_to_isl(CloogConstraintSet *constraints)
 {
-	return (isl_basic_set *)constraints;
+	return constraints->bset;
+}
+
+/* Return a reference to the basic set of "constraints" and release
+ * "constraints", for the functions that consume their argument.
+ */
+static __isl_give isl_basic_set *constraint_set_take_isl(
+	CloogConstraintSet *constraints)
+{
+	isl_basic_set *bset;
+
+	bset = isl_basic_set_copy(constraints->bset);
+	cloog_constraint_set_free(constraints);
+	return bset;
 }
 
 
@@ -99,7 +152,20 @@ isl_basic_set *cloog_constraints_set_to_isl(CloogConstraintSet *constraints)
 
 void cloog_constraint_set_free(CloogConstraintSet *constraints)
 {
-	isl_basic_set_free(cloog_constraints_set_to_isl(constraints));
+	int i;
+
+	if (!constraints || --constraints->ref > 0)
+		return;
+
+	for (i = 0; i < constraints->n; ++i)
+		isl_constraint_free(constraints->constraints[i]);
+	free(constraints->constraints);
+	free(constraints->flags);
+	free(constraints->sign);
+	free(constraints->start);
+	free(constraints->index);
+	isl_basic_set_free(constraints->bset);
+	free(constraints);
 }
 
 
@@ -145,51 +211,116 @@ static struct cloog_isl_dim set_cloog_dim_to_isl_dim(
 	return basic_set_cloog_dim_to_isl_dim(bset, pos);
 }
 
-/* Check if the variable at position level is defined by an
- * equality.  If so, return the row number.  Otherwise, return -1.
+#define CLOOG_CONSTRAINT_EQUALITY	1
+#define CLOOG_CONSTRAINT_DIV		2
+
+static isl_stat constraint_set_add(__isl_take isl_constraint *c, void *user)
+{
+	CloogConstraintSet *constraints = user;
+
+	constraints->constraints[constraints->n++] = c;
+	return isl_stat_ok;
+}
+
+/* Extract the constraints of the basic set of "constraints", if this
+ * has not been done yet, and index them by the variables they involve.
+ * The constraints are kept in the order of isl_basic_set_foreach_constraint,
+ * which, unlike isl_basic_set_get_constraint_list, also visits
+ * the constraints defining the existentially quantified variables.
  */
-CloogConstraint *cloog_constraint_set_defining_equality(
-	CloogConstraintSet *constraints, int level)
+static void constraint_set_index(CloogConstraintSet *constraints)
 {
-	struct isl_constraint *c;
+	int i, v, n, p, total;
+	isl_constraint *c;
+	isl_val *val;
 	struct cloog_isl_dim dim;
-	isl_basic_set *bset;
 
-	bset = cloog_constraints_set_to_isl(constraints);
-	dim = set_cloog_dim_to_isl_dim(constraints, level - 1);
-	if (isl_basic_set_has_defining_equality(bset, dim.type, dim.pos, &c))
-		return cloog_constraint_from_isl_constraint(c);
-	else
-		return NULL;
-}
+	if (constraints->n >= 0)
+		return;
 
+	n = isl_basic_set_n_constraint(constraints->bset);
+	total = isl_basic_set_total_dim(constraints->bset);
 
-struct cloog_isl_other {
-	int level;
-	int found;
-	isl_constraint *u;
-	isl_constraint *l;
-};
+	constraints->constraints = ALLOCN(isl_constraint *, n);
+	constraints->flags = ALLOCN(int, n);
+	constraints->sign = ALLOCN(signed char, n * total);
+	constraints->start = ALLOCN(int, total + 1);
+	constraints->index = ALLOCN(int, n * total);
 
+	constraints->n = 0;
+	isl_basic_set_foreach_constraint(constraints->bset,
+					 &constraint_set_add, constraints);
+	n = constraints->n;
 
-/* Set other->found to 1 if the given constraint involves other->level
- * and is different from other->u and other->l.
+	for (i = 0; i < n; ++i) {
+		c = constraints->constraints[i];
+		constraints->flags[i] = 0;
+		if (isl_constraint_is_equality(c))
+			constraints->flags[i] |= CLOOG_CONSTRAINT_EQUALITY;
+		if (isl_constraint_is_div_constraint(c))
+			constraints->flags[i] |= CLOOG_CONSTRAINT_DIV;
+		for (v = 0; v < total; ++v) {
+			dim = set_cloog_dim_to_isl_dim(constraints, v);
+			val = isl_constraint_get_coefficient_val(c, dim.type,
+								 dim.pos);
+			constraints->sign[i * total + v] = isl_val_sgn(val);
+			isl_val_free(val);
+		}
+	}
+
+	for (v = 0, p = 0; v < total; ++v) {
+		constraints->start[v] = p;
+		for (i = 0; i < n; ++i)
+			if (constraints->sign[i * total + v])
+				constraints->index[p++] = i;
+	}
+	constraints->start[total] = p;
+
+	constraints->total = total;
+	constraints->n = n;
+}
+
+/* Return the position of variable "v" (in CLooG order) in the isl order,
+ * where the parameters come first.
  */
-static int check_other_constraint(__isl_take isl_constraint *c, void *user)
+static int constraint_set_isl_rank(CloogConstraintSet *constraints, int v)
 {
-	struct cloog_isl_other *other = user;
-	CloogConstraint *cc;
-
-	if (!isl_constraint_is_equal(c, other->l) &&
-	    !isl_constraint_is_equal(c, other->u)) {
-		cc = cloog_constraint_from_isl_constraint(c);
-		if (cloog_constraint_involves(cc, other->level - 1))
-			other->found = 1;
-	}
+	int n_param = isl_basic_set_dim(constraints->bset, isl_dim_param);
+	int n_var = constraints->total - n_param;
 
-	isl_constraint_free(c);
+	return v < n_var ? n_param + v : v - n_var;
+}
 
-	return other->found ? -1 : 0;
+/* Check if the variable at position level is defined by an
+ * equality.  If so, return the row number.  Otherwise, return -1.
+ *
+ * As in isl_basic_set_has_defining_equality, this is the first equality
+ * that involves the variable but no variable after it in the isl order.
+ */
+CloogConstraint *cloog_constraint_set_defining_equality(
+	CloogConstraintSet *constraints, int level)
+{
+	int p, i, w, v = level - 1, rank;
+
+	constraint_set_index(constraints);
+	if (v >= constraints->total)
+		return NULL;
+	rank = constraint_set_isl_rank(constraints, v);
+	for (p = constraints->start[v]; p < constraints->start[v + 1]; ++p) {
+		i = constraints->index[p];
+		if (!(constraints->flags[i] & CLOOG_CONSTRAINT_EQUALITY))
+			continue;
+		for (w = 0; w < constraints->total; ++w)
+			if (constraints->sign[i * constraints->total + w] &&
+			    constraint_set_isl_rank(constraints, w) > rank)
+				break;
+		if (w < constraints->total)
+			continue;
+		return cloog_constraint_copy(
+		    cloog_constraint_from_isl_constraint(
+						constraints->constraints[i]));
+	}
+	return NULL;
 }
 
 
@@ -205,7 +336,9 @@ static int check_other_constraint(__isl_take isl_constraint *c, void *user)
  * then we currently return -1.  The modulo guard that we would generate
  * would still be correct, but we would also need to generate
  * guards corresponding to the other constraints, and this has not
- * been implemented yet.
+ * been implemented yet.  The index therefore tells us right away that
+ * there is no such pair unless exactly two inequalities involve the
+ * variable, in which case they are the pair if there is one.
  */
 CloogConstraint *cloog_constraint_set_defining_inequalities(
 	CloogConstraintSet *constraints,
@@ -215,27 +348,26 @@ CloogConstraint *cloog_constraint_set_defining_inequalities(
 	struct isl_constraint *l;
 	struct cloog_isl_dim dim;
 	struct isl_basic_set *bset;
-	struct cloog_isl_other other;
+	int v = level - 1;
+	int p;
 
 	(void) nb_par;
 
+	constraint_set_index(constraints);
+	if (v >= constraints->total ||
+	    constraints->start[v + 1] - constraints->start[v] != 2)
+		return cloog_constraint_invalid();
+	for (p = constraints->start[v]; p < constraints->start[v + 1]; ++p)
+		if (constraints->flags[constraints->index[p]] &
+						CLOOG_CONSTRAINT_EQUALITY)
+			return cloog_constraint_invalid();
+
 	bset = cloog_constraints_set_to_isl(constraints);
-	dim = set_cloog_dim_to_isl_dim(constraints, level - 1);
+	dim = set_cloog_dim_to_isl_dim(constraints, v);
 	if (!isl_basic_set_has_defining_inequalities(bset, dim.type, dim.pos,
 								&l, &u))
 		return cloog_constraint_invalid();
 
-	other.l = l;
-	other.u = u;
-	other.found = 0;
-	other.level = level;
-	isl_basic_set_foreach_constraint(bset, &check_other_constraint, &other);
-	if (other.found) {
-		isl_constraint_free(l);
-		isl_constraint_free(u);
-		*lower = NULL;
-		return NULL;
-	}
 	*lower = cloog_constraint_from_isl_constraint(l);
 	return cloog_constraint_from_isl_constraint(u);
 }
@@ -475,12 +607,12 @@ void cloog_constraint_set_normalize(CloogConstraintSet *matrix, int level)
  *
  * NOTE: this function used to return a "hard copy" (not a pointer copy) but isl
  * doesn't provide isl_basic_set_dup() anymore and a soft copy works as well.
+ * The copy shares the constraints and the index of the original.
  */
 CloogConstraintSet *cloog_constraint_set_copy(CloogConstraintSet *constraints)
 {
-	isl_basic_set *bset;
-	bset = cloog_constraints_set_to_isl(constraints);
-	return cloog_constraint_set_from_isl_basic_set(isl_basic_set_copy(bset));
+	constraints->ref++;
+	return constraints;
 }
 
 
@@ -717,7 +849,7 @@ static inline isl_stat cloog_basic_set_ignore_constraint(
 CloogConstraintSet *cloog_constraint_set_drop_constraint(
 	CloogConstraintSet *constraints, CloogConstraint *constraint)
 {
-  isl_basic_set* bset = cloog_constraints_set_to_isl(constraints);
+  isl_basic_set* bset = constraint_set_take_isl(constraints);
   isl_constraint* c = cloog_constraint_to_isl(cloog_constraint_copy(constraint));
 
   isl_space* space = isl_basic_set_get_space(bset);
@@ -964,9 +1096,9 @@ CloogConstraintSet *cloog_constraint_set_reduce(CloogConstraintSet *constraints,
 
 	(void) nb_par;
 
-	bset = cloog_constraints_set_to_isl(constraints);
+	bset = constraint_set_take_isl(constraints);
 	orig = isl_basic_set_copy(bset);
-	dim = set_cloog_dim_to_isl_dim(constraints, level - 1);
+	dim = basic_set_cloog_dim_to_isl_dim(bset, level - 1);
 	assert(dim.type == isl_dim_set);
 
 	eq = NULL;
@@ -1019,7 +1151,7 @@ CloogConstraintSet *cloog_constraint_set_reduce(CloogConstraintSet *constraints,
 
 	isl_val_free(v);
 	isl_basic_set_free(orig);
-	return cloog_constraint_set_from_isl_basic_set(bset);
+	return constraints;
 }
 
 CloogConstraint *cloog_constraint_copy(CloogConstraint *constraint)
@@ -1028,42 +1160,71 @@ CloogConstraint *cloog_constraint_copy(CloogConstraint *constraint)
 		isl_constraint_copy(cloog_constraint_to_isl(constraint)));
 }
 
+/* Return a copy of "constraint" that does not share its coefficients
+ * with "constraint" and may therefore be modified.
+ */
+CloogConstraint *cloog_constraint_dup(CloogConstraint *constraint)
+{
+	isl_constraint *c = cloog_constraint_to_isl(constraint);
+	isl_aff *aff = isl_constraint_get_aff(c);
+
+	if (isl_constraint_is_equality(c))
+		c = isl_equality_from_aff(aff);
+	else
+		c = isl_inequality_from_aff(aff);
+	return cloog_constraint_from_isl_constraint(c);
+}
+
 void cloog_constraint_release(CloogConstraint *constraint)
 {
 	isl_constraint_free(cloog_constraint_to_isl(constraint));
 }
 
-struct cloog_isl_foreach {
-	int (*fn)(CloogConstraint *constraint, void *user);
-	void *user;
-};
-
-static int cloog_isl_foreach_cb(__isl_take isl_constraint *c, void *user)
+/* Call "fn" on the constraints of "constraints", except those defining
+ * existentially quantified variables.  The constraints belong to
+ * "constraints": "fn" should take a copy of those it wants to keep
+ * and a cloog_constraint_dup of those it wants to modify.
+ */
+int cloog_constraint_set_foreach_constraint(CloogConstraintSet *constraints,
+	int (*fn)(CloogConstraint *constraint, void *user), void *user)
 {
-	struct cloog_isl_foreach *data = (struct cloog_isl_foreach *)user;
-	int ret;
+	int i;
 
-	if (isl_constraint_is_div_constraint(c)) {
-		isl_constraint_free(c);
-		return 0;
+	constraint_set_index(constraints);
+	for (i = 0; i < constraints->n; ++i) {
+		if (constraints->flags[i] & CLOOG_CONSTRAINT_DIV)
+			continue;
+		if (fn(cloog_constraint_from_isl_constraint(
+					constraints->constraints[i]), user) < 0)
+			return -1;
 	}
 
-	ret = data->fn(cloog_constraint_from_isl_constraint(c), data->user);
-
-	isl_constraint_free(c);
-
-	return ret;
+	return 0;
 }
 
-int cloog_constraint_set_foreach_constraint(CloogConstraintSet *constraints,
+/* Call "fn" on the constraints of "constraints" that involve the variable
+ * at position "level", as cloog_constraint_set_foreach_constraint does on
+ * all of them, but without looking at the other ones.
+ */
+int cloog_constraint_set_foreach_constraint_involving(
+	CloogConstraintSet *constraints, int level,
 	int (*fn)(CloogConstraint *constraint, void *user), void *user)
 {
-	struct cloog_isl_foreach data = { fn, user };
-	isl_basic_set *bset;
+	int p, i, v = level - 1;
 
-	bset = cloog_constraints_set_to_isl(constraints);
-	return isl_basic_set_foreach_constraint(bset,
-						cloog_isl_foreach_cb, &data);
+	constraint_set_index(constraints);
+	if (v < 0 || v >= constraints->total)
+		return 0;
+	for (p = constraints->start[v]; p < constraints->start[v + 1]; ++p) {
+		i = constraints->index[p];
+		if (constraints->flags[i] & CLOOG_CONSTRAINT_DIV)
+			continue;
+		if (fn(cloog_constraint_from_isl_constraint(
+					constraints->constraints[i]), user) < 0)
+			return -1;
+	}
+
+	return 0;
 }
 
 CloogConstraint *cloog_equal_constraint(CloogEqualities *equal, int j)
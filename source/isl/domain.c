@@ -12,24 +12,70 @@
 #include <isl/map.h>
 #include <isl/val.h>
 #include <isl/space.h>
+#include <isl/hash.h>
+
+#ifdef CLOOG_THREADS
+#include <pthread.h>
+#endif
 
 #ifdef OSL_SUPPORT
 #include <osl/macros.h>
 #include <osl/relation.h>
 #endif
 
-CloogDomain *cloog_domain_from_isl_set(__isl_take isl_set *set)
+/* Return a domain holding "set" for the operations of "state".
+ */
+static CloogDomain *domain_from_isl_set(__isl_take isl_set *set,
+	CloogState *state)
 {
+	CloogDomain *domain;
+
+	if (!set)
+		return NULL;
 	if (isl_set_is_params(set))
 		set = isl_set_from_params(set);
 	set = isl_set_detect_equalities(set);
 	set = isl_set_compute_divs(set);
-	return (CloogDomain *)set;
+
+	domain = (CloogDomain *)malloc(sizeof(CloogDomain));
+	if (!domain)
+		cloog_die("memory overflow.\n");
+	domain->references = 1;
+	domain->state = state;
+	domain->set = set;
+	return domain;
+}
+
+CloogDomain *cloog_domain_from_isl_set(__isl_take isl_set *set)
+{
+	return domain_from_isl_set(set, NULL);
 }
 
 __isl_give isl_set *isl_set_from_cloog_domain(CloogDomain *domain)
 {
-	return (isl_set *)domain;
+	return domain ? domain->set : NULL;
+}
+
+/* Return the set of "domain", which is released.
+ */
+static __isl_give isl_set *domain_take_set(CloogDomain *domain)
+{
+	isl_set *set;
+
+	if (!domain)
+		return NULL;
+	if (--domain->references > 0)
+		return isl_set_copy(domain->set);
+	set = domain->set;
+	free(domain);
+	return set;
+}
+
+/* Return the state of the operations on "dom1" and "dom2".
+ */
+static CloogState *domain_state2(CloogDomain *dom1, CloogDomain *dom2)
+{
+	return dom1->state ? dom1->state : dom2->state;
 }
 
 CloogScattering *cloog_scattering_from_isl_map(__isl_take isl_map *map)
@@ -56,20 +102,6 @@ int cloog_scattering_fully_specified(CloogScattering *scattering,
 }
 
 
-CloogConstraintSet *cloog_domain_constraints(CloogDomain *domain)
-{
-	isl_basic_set *bset;
-	isl_set *set = isl_set_from_cloog_domain(domain);
-	isl_basic_set_list *list;
-	assert(isl_set_n_basic_set(set) == 1);
-
-	list = isl_set_get_basic_set_list(set);
-	bset = isl_basic_set_list_get_basic_set(list, 0);
-	isl_basic_set_list_free(list);
-	return cloog_constraint_set_from_isl_basic_set(bset);
-}
-
-
 void cloog_domain_print_constraints(FILE *foo, CloogDomain *domain,
 					int print_number)
 {
@@ -109,8 +141,7 @@ void cloog_scattering_print_constraints(FILE *foo, CloogScattering *scattering)
 
 void cloog_domain_free(CloogDomain * domain)
 {
-	isl_set *set = isl_set_from_cloog_domain(domain);
-	isl_set_free(set);
+	isl_set_free(domain_take_set(domain));
 }
 
 
@@ -123,8 +154,300 @@ void cloog_scattering_free(CloogScattering *scatt)
 
 CloogDomain * cloog_domain_copy(CloogDomain * domain)
 {
+	domain->references++;
+	return domain;
+}
+
+
+/* Operations whose outcome may be stored in the domain cache.
+ */
+enum cloog_domain_memo_op {
+	cloog_memo_unused = 0,
+	cloog_memo_simplify,
+	cloog_memo_intersection,
+	cloog_memo_difference,
+	cloog_memo_follows,
+	cloog_memo_is_bounded,
+	cloog_memo_isempty,
+	cloog_memo_constraints
+};
+
+/* An entry of the domain cache.  "set1" and "set2" (NULL for operations
+ * on a single domain) are private copies of the arguments, "level" is the
+ * level argument, if any, and the outcome is kept in "res" for operations
+ * returning a domain, in "constraints" for cloog_domain_constraints and
+ * in "value" for the others.
+ */
+struct cloog_domain_memo_entry {
+	enum cloog_domain_memo_op op;
+	uint32_t hash;
+	int level;
+	isl_set *set1;
+	isl_set *set2;
+	isl_set *res;
+	CloogConstraintSet *constraints;
+	int value;
+};
+
+/* A direct-mapped cache of domain operations, attached to a CloogState.
+ */
+struct cloog_domain_memo {
+	int size;
+	struct cloog_domain_memo_entry *entry;
+};
+
+
+static void memo_entry_clear(struct cloog_domain_memo_entry *entry)
+{
+	isl_set_free(entry->set1);
+	isl_set_free(entry->set2);
+	isl_set_free(entry->res);
+	cloog_constraint_set_free(entry->constraints);
+	entry->op = cloog_memo_unused;
+	entry->set1 = NULL;
+	entry->set2 = NULL;
+	entry->res = NULL;
+	entry->constraints = NULL;
+}
+
+
+/**
+ * cloog_domain_memo_free function:
+ * Frees the domain cache (memo).
+ */
+void cloog_domain_memo_free(struct cloog_domain_memo *memo)
+{
+	int i;
+
+	if (!memo)
+		return;
+
+	for (i = 0; i < memo->size; ++i)
+		memo_entry_clear(&memo->entry[i]);
+	free(memo->entry);
+	free(memo);
+}
+
+
+/**
+ * cloog_state_set_domain_cache function:
+ * Makes the domain operations performed in the context of (state) remember
+ * up to (size) results.  A non-positive (size) disables the cache.  Any
+ * previously cached result is dropped.
+ */
+void cloog_state_set_domain_cache(CloogState *state, int size)
+{
+	int i;
+	struct cloog_domain_memo *memo;
+
+	cloog_domain_memo_free(state->backend->memo);
+	state->backend->memo = NULL;
+	if (size <= 0)
+		return;
+
+	memo = (struct cloog_domain_memo *)malloc(sizeof(*memo));
+	if (!memo)
+		cloog_die("memory overflow.\n");
+	memo->entry = (struct cloog_domain_memo_entry *)
+			malloc(size * sizeof(struct cloog_domain_memo_entry));
+	if (!memo->entry)
+		cloog_die("memory overflow.\n");
+	for (i = 0; i < size; ++i) {
+		memo->entry[i].op = cloog_memo_unused;
+		memo->entry[i].set1 = NULL;
+		memo->entry[i].set2 = NULL;
+		memo->entry[i].res = NULL;
+		memo->entry[i].constraints = NULL;
+	}
+	memo->size = size;
+
+	state->backend->memo = memo;
+}
+
+
+/* Return a copy of "set" that shares none of its structure with "set",
+ * down to its basic sets, and that has the same representation: the same
+ * basic sets, with the same constraints, in the same order.
+ * Some isl functions, e.g., isl_set_get_hash, isl_set_plain_is_equal or
+ * isl_set_coalesce, rearrange their argument in place, which would
+ * otherwise leak from the caller into the cache and back.  The cache
+ * therefore never hands out its own sets, never keeps references to
+ * the sets of the caller and only hashes and compares its own copies.
+ * isl has no public function for this, but changing the tuple name of
+ * a set that is shared is done on a copy of the set and of each of its
+ * basic sets.  The name is then changed back on that copy.
+ */
+static __isl_give isl_set *memo_set_dup(__isl_keep isl_set *set)
+{
+	isl_space *space;
+	const char *name;
+	isl_set *dup;
+
+	space = isl_set_get_space(set);
+	name = isl_space_get_tuple_name(space, isl_dim_set);
+	dup = isl_set_set_tuple_name(isl_set_copy(set), "cloog_memo_dup");
+	dup = isl_set_set_tuple_name(dup, name);
+	isl_space_free(space);
+
+	return dup;
+}
+
+
+/* Count a call to the domain primitive "primitive" on "domain" in the
+ * statistics of the state of "domain", if it counts them, and return
+ * this state.
+ */
+static CloogState *domain_count(CloogDomain *domain,
+	enum cloog_primitive primitive)
+{
+	CloogState *state = domain->state;
+
+	if (state && state->stats_enabled)
+		state->stats.primitive_calls[primitive]++;
+	return state;
+}
+
+
+/* The arguments of a lookup in the domain cache and the entry in which
+ * its outcome should be stored, if there is a cache.  "set1" and "set2"
+ * are private copies of the arguments, which are moved into the entry
+ * once the outcome is known.
+ */
+struct cloog_domain_memo_key {
+	struct cloog_domain_memo_entry *entry;
+	enum cloog_domain_memo_op op;
+	uint32_t hash;
+	int level;
+	isl_set *set1;
+	isl_set *set2;
+};
+
+/* Look up the outcome of operation "op" applied to "set1", "set2" (NULL
+ * for operations on a single domain) and "level" in the cache of "state".
+ * Return the entry holding the outcome, if any, and NULL otherwise.
+ * On a miss, "key" is set up for storing the outcome computed by the caller
+ * with memo_set_result, memo_int_result or memo_store, which the caller
+ * is required to do.
+ * The arguments are hashed and compared through private copies, such that
+ * the lookup leaves the representation of "set1" and "set2" untouched.
+ */
+static struct cloog_domain_memo_entry *memo_lookup(CloogState *state,
+	enum cloog_domain_memo_op op, __isl_keep isl_set *set1,
+	__isl_keep isl_set *set2, int level, struct cloog_domain_memo_key *key)
+{
+	uint32_t hash;
+	isl_set *copy1, *copy2;
+	struct cloog_domain_memo *memo;
+	struct cloog_domain_memo_entry *entry;
+
+	key->entry = NULL;
+	memo = state ? state->backend->memo : NULL;
+	if (!memo)
+		return NULL;
+
+	copy1 = memo_set_dup(set1);
+	copy2 = set2 ? memo_set_dup(set2) : NULL;
+	hash = isl_hash_init();
+	isl_hash_hash(hash, op);
+	isl_hash_hash(hash, level);
+	isl_hash_hash(hash, isl_set_get_hash(copy1));
+	if (copy2)
+		isl_hash_hash(hash, isl_set_get_hash(copy2));
+
+	entry = &memo->entry[hash % memo->size];
+	if (entry->op == op && entry->hash == hash && entry->level == level &&
+	    isl_set_plain_is_equal(entry->set1, copy1) > 0 &&
+	    (!copy2 || isl_set_plain_is_equal(entry->set2, copy2) > 0)) {
+		isl_set_free(copy1);
+		isl_set_free(copy2);
+		state->domain_cache_hits++;
+		return entry;
+	}
+
+	state->domain_cache_misses++;
+	key->entry = entry;
+	key->op = op;
+	key->hash = hash;
+	key->level = level;
+	key->set1 = copy1;
+	key->set2 = copy2;
+	return NULL;
+}
+
+
+/* Reset the entry of "key", if any, to the arguments of "key" and return it.
+ * The caller is expected to fill in the outcome.
+ */
+static struct cloog_domain_memo_entry *memo_store(
+	struct cloog_domain_memo_key *key)
+{
+	struct cloog_domain_memo_entry *entry = key->entry;
+
+	if (!entry)
+		return NULL;
+
+	memo_entry_clear(entry);
+	entry->op = key->op;
+	entry->hash = key->hash;
+	entry->level = key->level;
+	entry->set1 = key->set1;
+	entry->set2 = key->set2;
+	return entry;
+}
+
+
+/* Record "set" as the outcome of the lookup of "key".
+ */
+static void memo_set_result(struct cloog_domain_memo_key *key,
+	__isl_keep isl_set *set)
+{
+	struct cloog_domain_memo_entry *entry = memo_store(key);
+
+	if (entry)
+		entry->res = memo_set_dup(set);
+}
+
+
+static void memo_int_result(struct cloog_domain_memo_key *key, int value)
+{
+	struct cloog_domain_memo_entry *entry = memo_store(key);
+
+	if (entry)
+		entry->value = value;
+}
+
+
+/**
+ * cloog_domain_constraints function:
+ * Returns the constraints of the convex domain (domain).  The constraint
+ * set indexes its constraints the first time they are used and is shared
+ * through the domain cache, if any, with later calls on an equal domain,
+ * such that the clast of loops with equal domains is built from a single
+ * extraction of their constraints.
+ */
+CloogConstraintSet *cloog_domain_constraints(CloogDomain *domain)
+{
+	isl_basic_set *bset;
 	isl_set *set = isl_set_from_cloog_domain(domain);
-	return cloog_domain_from_isl_set(isl_set_copy(set));
+	isl_basic_set_list *list;
+	CloogConstraintSet *constraints;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
+	assert(isl_set_n_basic_set(set) == 1);
+
+	entry = memo_lookup(domain->state,
+			    cloog_memo_constraints, set, NULL, 0, &key);
+	if (entry)
+		return cloog_constraint_set_copy(entry->constraints);
+
+	list = isl_set_get_basic_set_list(set);
+	bset = isl_basic_set_list_get_basic_set(list, 0);
+	isl_basic_set_list_free(list);
+	constraints = cloog_constraint_set_from_isl_basic_set(bset);
+	entry = memo_store(&key);
+	if (entry)
+		entry->constraints = cloog_constraint_set_copy(constraints);
+	return constraints;
 }
 
 
@@ -134,10 +457,11 @@ CloogDomain * cloog_domain_copy(CloogDomain * domain)
  */ 
 CloogDomain *cloog_domain_convex(CloogDomain *domain)
 {
-	isl_set *set = isl_set_from_cloog_domain(domain);
-  set = isl_set_coalesce(set);
-	set = isl_set_from_basic_set(isl_set_convex_hull(isl_set_copy(set)));
-	return cloog_domain_from_isl_set(set);
+	isl_set *set;
+	domain_count(domain, CLOOG_PRIM_CONVEX);
+  domain->set = isl_set_coalesce(domain->set);
+	set = isl_set_from_basic_set(isl_set_convex_hull(isl_set_copy(domain->set)));
+	return domain_from_isl_set(set, domain->state);
 }
 
 
@@ -153,11 +477,12 @@ CloogDomain *cloog_domain_simple_convex(CloogDomain *domain)
 	struct isl_basic_set *hull;
 	isl_set *set = isl_set_from_cloog_domain(domain);
 
+	domain_count(domain, CLOOG_PRIM_SIMPLE_CONVEX);
 	if (cloog_domain_isconvex(domain))
 		return cloog_domain_copy(domain);
 
 	hull = isl_set_simple_hull(isl_set_copy(set));
-	return cloog_domain_from_isl_set(isl_set_from_basic_set(hull));
+	return domain_from_isl_set(isl_set_from_basic_set(hull), domain->state);
 }
 
 
@@ -174,8 +499,19 @@ CloogDomain *cloog_domain_simplify(CloogDomain *dom1, CloogDomain *dom2)
 {
 	isl_set *set1 = isl_set_from_cloog_domain(dom1);
 	isl_set *set2 = isl_set_from_cloog_domain(dom2);
-	set1 = isl_set_gist(isl_set_copy(set1), isl_set_copy(set2));
-	return cloog_domain_from_isl_set(set1);
+	CloogState *state;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
+	CloogDomain *res;
+
+	state = domain_count(dom1, CLOOG_PRIM_SIMPLIFY);
+	entry = memo_lookup(state, cloog_memo_simplify, set1, set2, 0, &key);
+	if (entry)
+		return domain_from_isl_set(memo_set_dup(entry->res), state);
+	res = domain_from_isl_set(isl_set_gist(isl_set_copy(set1),
+					isl_set_copy(set2)), domain_state2(dom1, dom2));
+	memo_set_result(&key, isl_set_from_cloog_domain(res));
+	return res;
 }
 
 
@@ -187,10 +523,14 @@ CloogDomain *cloog_domain_simplify(CloogDomain *dom1, CloogDomain *dom2)
  */
 CloogDomain *cloog_domain_union(CloogDomain *dom1, CloogDomain *dom2)
 {
-	isl_set *set1 = isl_set_from_cloog_domain(dom1);
-	isl_set *set2 = isl_set_from_cloog_domain(dom2);
+	CloogState *state = domain_state2(dom1, dom2);
+	isl_set *set1, *set2;
+
+	domain_count(dom1, CLOOG_PRIM_UNION);
+	set1 = domain_take_set(dom1);
+	set2 = domain_take_set(dom2);
 	set1 = isl_set_union(set1, set2);
-	return cloog_domain_from_isl_set(set1);
+	return domain_from_isl_set(set1, state);
 }
 
 
@@ -204,8 +544,19 @@ CloogDomain *cloog_domain_intersection(CloogDomain *dom1, CloogDomain *dom2)
 {
 	isl_set *set1 = isl_set_from_cloog_domain(dom1);
 	isl_set *set2 = isl_set_from_cloog_domain(dom2);
-	set1 = isl_set_intersect(isl_set_copy(set1), isl_set_copy(set2));
-	return cloog_domain_from_isl_set(set1);
+	CloogState *state;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
+	CloogDomain *res;
+
+	state = domain_count(dom1, CLOOG_PRIM_INTERSECTION);
+	entry = memo_lookup(state, cloog_memo_intersection, set1, set2, 0, &key);
+	if (entry)
+		return domain_from_isl_set(memo_set_dup(entry->res), state);
+	res = domain_from_isl_set(isl_set_intersect(isl_set_copy(set1),
+				isl_set_copy(set2)), domain_state2(dom1, dom2));
+	memo_set_result(&key, isl_set_from_cloog_domain(res));
+	return res;
 }
 
 
@@ -217,97 +568,241 @@ CloogDomain *cloog_domain_difference(CloogDomain *domain, CloogDomain *minus)
 {
 	isl_set *set1 = isl_set_from_cloog_domain(domain);
 	isl_set *set2 = isl_set_from_cloog_domain(minus);
-	set1 = isl_set_subtract(isl_set_copy(set1), isl_set_copy(set2));
-	return cloog_domain_from_isl_set(set1);
+	CloogState *state;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
+	CloogDomain *res;
+
+	state = domain_count(domain, CLOOG_PRIM_DIFFERENCE);
+	entry = memo_lookup(state, cloog_memo_difference, set1, set2, 0, &key);
+	if (entry)
+		return domain_from_isl_set(memo_set_dup(entry->res), state);
+	res = domain_from_isl_set(isl_set_subtract(isl_set_copy(set1),
+				isl_set_copy(set2)), domain_state2(domain, minus));
+	memo_set_result(&key, isl_set_from_cloog_domain(res));
+	return res;
 }
 
 
-/**
- * cloog_domain_sort function:
- * This function topologically sorts (nb_doms) domains. Here (doms) is an
- * array of pointers to CloogDomains, (nb_doms) is the number of domains,
- * (level) is the level to consider for partial ordering (nb_par) is the
- * parameter space dimension, (permut) if not NULL, is an array of (nb_doms)
- * integers that contains a permutation specification after call in order to
- * apply the topological sorting. 
+/* Bitsets used by cloog_domain_sort, stored as arrays of words.
  */
-void cloog_domain_sort(CloogDomain **doms, unsigned nb_doms, unsigned level,
-			int *permut)
+#define CLOOG_BITS_PER_WORD	(8 * sizeof(unsigned long))
+
+static unsigned bitset_words(unsigned n)
+{
+	return (n + CLOOG_BITS_PER_WORD - 1) / CLOOG_BITS_PER_WORD;
+}
+
+static int bitset_is_set(unsigned long *set, unsigned i)
+{
+	return (set[i / CLOOG_BITS_PER_WORD] >> (i % CLOOG_BITS_PER_WORD)) & 1;
+}
+
+static void bitset_set(unsigned long *set, unsigned i)
+{
+	set[i / CLOOG_BITS_PER_WORD] |= 1UL << (i % CLOOG_BITS_PER_WORD);
+}
+
+static void bitset_clear(unsigned long *set, unsigned i)
+{
+	set[i / CLOOG_BITS_PER_WORD] &= ~(1UL << (i % CLOOG_BITS_PER_WORD));
+}
+
+/* Return the smallest element of "set" that is greater than or equal
+ * to "start" and smaller than "n", or -1 if there is no such element.
+ */
+static int bitset_next(unsigned long *set, unsigned n, unsigned start)
+{
+	unsigned w, words = bitset_words(n);
+	unsigned long word;
+	unsigned i;
+
+	if (start >= n)
+		return -1;
+	w = start / CLOOG_BITS_PER_WORD;
+	word = set[w] & (~0UL << (start % CLOOG_BITS_PER_WORD));
+	for (;;) {
+		if (word) {
+			for (i = w * CLOOG_BITS_PER_WORD; !(word & 1); word >>= 1)
+				++i;
+			return i < n ? (int)i : -1;
+		}
+		if (++w >= words)
+			return -1;
+		word = set[w];
+	}
+}
+
+/* Add the elements of "src" to "dst" and, for each element k that was
+ * not yet in "dst", add "i" to the row k of the bit matrix "other" (with
+ * rows of "words" words).
+ */
+static void bitset_merge(unsigned long *dst, unsigned long *src,
+	unsigned words, unsigned long *other, unsigned i)
+{
+	unsigned w, k;
+	unsigned long new;
+
+	for (w = 0; w < words; ++w) {
+		new = src[w] & ~dst[w];
+		dst[w] |= new;
+		for (k = w * CLOOG_BITS_PER_WORD; new; new >>= 1, ++k)
+			if (new & 1)
+				bitset_set(other + k * words, i);
+	}
+}
+
+
+/* Outcome of the comparisons at a given level of pairs of domains,
+ * computed ahead of cloog_domain_sort.  If decided[i] is set, then
+ * bit j (j < i) of row i of "gt" (resp. "lt") is set if doms[i] is
+ * after (resp. before) doms[j] at that level.
+ */
+struct cloog_sort_cmp {
+	unsigned words;
+	unsigned long *gt;
+	unsigned long *lt;
+	int *decided;
+};
+
+/* Compare the single basic sets of doms[i] and doms[j] at (level), see
+ * isl_basic_set_compare_at.
+ */
+static int domain_compare_at(CloogDomain **doms, unsigned i, unsigned j,
+	unsigned level, struct cloog_sort_cmp *table)
 {
-  unsigned int i, j, k;
 	int cmp;
-	struct isl_ctx *ctx;
-	unsigned char **follows;
 	isl_set *set_i, *set_j;
 	isl_basic_set *bset_i, *bset_j;
 	isl_basic_set_list *list_i, *list_j;
 
-	if (!nb_doms)
-		return;
-	set_i = isl_set_from_cloog_domain(doms[0]);
-	ctx = isl_set_get_ctx(set_i);
-	for (i = 0; i < nb_doms; i++) {
-		set_i = isl_set_from_cloog_domain(doms[i]);
-		assert(isl_set_n_basic_set(set_i) == 1);
+	if (table && table->decided[i]) {
+		if (bitset_is_set(table->gt + i * table->words, j))
+			return 1;
+		if (bitset_is_set(table->lt + i * table->words, j))
+			return -1;
+		return 0;
 	}
 
-	follows = isl_alloc_array(ctx, unsigned char *, nb_doms);
-	assert(follows);
-	for (i = 0; i < nb_doms; ++i) {
-		follows[i] = isl_alloc_array(ctx, unsigned char, nb_doms);
-		assert(follows[i]);
-		for (j = 0; j < nb_doms; ++j)
-			follows[i][j] = 0;
-	}
+	set_i = isl_set_from_cloog_domain(doms[i]);
+	set_j = isl_set_from_cloog_domain(doms[j]);
+	list_i = isl_set_get_basic_set_list(set_i);
+	list_j = isl_set_get_basic_set_list(set_j);
+	bset_i = isl_basic_set_list_get_basic_set(list_i, 0);
+	bset_j = isl_basic_set_list_get_basic_set(list_j, 0);
+	isl_basic_set_list_free(list_i);
+	isl_basic_set_list_free(list_j);
+	cmp = isl_basic_set_compare_at(bset_i, bset_j, level-1);
+	isl_basic_set_free(bset_i);
+	isl_basic_set_free(bset_j);
+
+	return cmp;
+}
+
+/* Topologically sort the (nb_doms) domains of (doms), see
+ * cloog_domain_sort, using the outcome of the comparisons in (table),
+ * if any.
+ *
+ * follows[i] is the set of domains that should be scanned before doms[i]
+ * and precedes[i] the set of domains that should be scanned after it.
+ * When a new pair is found, its transitive consequences are only
+ * propagated to the domains with a smaller index, as the pairs involving
+ * greater indices have not been considered yet.  The domains are then
+ * scanned in order, starting each time after the last selected one, and
+ * the first one with no remaining predecessor is selected.
+ */
+static void domain_sort(CloogDomain **doms, unsigned nb_doms, unsigned level,
+	int *permut, struct cloog_sort_cmp *table)
+{
+	unsigned i, j, start, words;
+	int k, next, cmp;
+	unsigned long *follows, *precedes, *ready;
+	unsigned *nb_pred;
+
+	if (!nb_doms)
+		return;
+	domain_count(doms[0], CLOOG_PRIM_SORT);
+	for (i = 0; i < nb_doms; i++)
+		assert(isl_set_n_basic_set(
+				isl_set_from_cloog_domain(doms[i])) == 1);
+
+	words = bitset_words(nb_doms);
+	follows = (unsigned long *)calloc(nb_doms * words,
+						sizeof(unsigned long));
+	precedes = (unsigned long *)calloc(nb_doms * words,
+						sizeof(unsigned long));
+	ready = (unsigned long *)calloc(words, sizeof(unsigned long));
+	nb_pred = (unsigned *)calloc(nb_doms, sizeof(unsigned));
+	if (!follows || !precedes || !ready || !nb_pred)
+		cloog_die("memory overflow.\n");
 
 	for (i = 1; i < nb_doms; ++i) {
 		for (j = 0; j < i; ++j) {
-			if (follows[i][j] || follows[j][i])
+			if (bitset_is_set(follows + i * words, j) ||
+			    bitset_is_set(follows + j * words, i))
 				continue;
-			set_i = isl_set_from_cloog_domain(doms[i]);
-			set_j = isl_set_from_cloog_domain(doms[j]);
-			list_i = isl_set_get_basic_set_list(set_i);
-			list_j = isl_set_get_basic_set_list(set_j);
-			bset_i = isl_basic_set_list_get_basic_set(list_i, 0);
-			bset_j = isl_basic_set_list_get_basic_set(list_j, 0);
-			isl_basic_set_list_free(list_i);
-			isl_basic_set_list_free(list_j);
-			cmp = isl_basic_set_compare_at(bset_i, bset_j, level-1);
-			isl_basic_set_free(bset_i);
-			isl_basic_set_free(bset_j);
+			cmp = domain_compare_at(doms, i, j, level, table);
 			if (!cmp)
 				continue;
 			if (cmp > 0) {
-				follows[i][j] = 1;
-				for (k = 0; k < i; ++k)
-					follows[i][k] |= follows[j][k];
+				bitset_set(follows + i * words, j);
+				bitset_set(precedes + j * words, i);
+				bitset_merge(follows + i * words,
+					follows + j * words, words, precedes, i);
 			} else {
-				follows[j][i] = 1;
-				for (k = 0; k < i; ++k)
-					follows[k][i] |= follows[k][j];
+				bitset_set(follows + j * words, i);
+				bitset_set(precedes + i * words, j);
+				bitset_merge(precedes + i * words,
+					precedes + j * words, words, follows, i);
 			}
 		}
 	}
 
-	for (i = 0, j = 0; i < nb_doms; j = (j + 1) % nb_doms) {
-		for (k = 0; k < nb_doms; ++k)
-			if (follows[j][k])
-				break;
-		if (k < nb_doms)
-			continue;
-		for (k = 0; k < nb_doms; ++k)
-			follows[k][j] = 0;
-		follows[j][j] = 1;
-		permut[i] = 1 + j;
-		++i;
+	for (i = 0; i < nb_doms; ++i) {
+		for (k = bitset_next(follows + i * words, nb_doms, 0); k >= 0;
+		     k = bitset_next(follows + i * words, nb_doms, k + 1))
+			nb_pred[i]++;
+		if (!nb_pred[i])
+			bitset_set(ready, i);
 	}
 
-	for (i = 0; i < nb_doms; ++i)
-		free(follows[i]);
+	for (i = 0, start = 0; i < nb_doms; ++i) {
+		next = bitset_next(ready, nb_doms, start);
+		if (next < 0)
+			next = bitset_next(ready, nb_doms, 0);
+		assert(next >= 0);
+		bitset_clear(ready, next);
+		permut[i] = 1 + next;
+		start = next + 1;
+		for (k = bitset_next(precedes + next * words, nb_doms, 0);
+		     k >= 0; k = bitset_next(precedes + next * words, nb_doms, k + 1))
+			if (--nb_pred[k] == 0)
+				bitset_set(ready, k);
+	}
+
+	free(nb_pred);
+	free(ready);
+	free(precedes);
 	free(follows);
 }
 
 
+/**
+ * cloog_domain_sort function:
+ * This function topologically sorts (nb_doms) domains. Here (doms) is an
+ * array of pointers to CloogDomains, (nb_doms) is the number of domains,
+ * (level) is the level to consider for partial ordering (nb_par) is the
+ * parameter space dimension, (permut) if not NULL, is an array of (nb_doms)
+ * integers that contains a permutation specification after call in order to
+ * apply the topological sorting. 
+ */
+void cloog_domain_sort(CloogDomain **doms, unsigned nb_doms, unsigned level,
+			int *permut)
+{
+	domain_sort(doms, nb_doms, level, permut, NULL);
+}
+
+
 /**
  * Check whether there is or may be any value of dom1 at the given level
  * that is greater than or equal to a value of dom2 at the same level.
@@ -321,10 +816,19 @@ int cloog_domain_follows(CloogDomain *dom1, CloogDomain *dom2, unsigned level)
 {
 	isl_set *set1 = isl_set_from_cloog_domain(dom1);
 	isl_set *set2 = isl_set_from_cloog_domain(dom2);
+	CloogState *state;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
 	int follows;
 
+	state = domain_count(dom1, CLOOG_PRIM_FOLLOWS);
+	entry = memo_lookup(state, cloog_memo_follows, set1, set2, level, &key);
+	if (entry)
+		return entry->value;
+
 	follows = isl_set_follows_at(set1, set2, level - 1);
 	assert(follows >= -1);
+	memo_int_result(&key, follows);
 
 	return follows;
 }
@@ -338,7 +842,7 @@ CloogDomain *cloog_domain_empty(CloogDomain *template)
 {
 	isl_set *set = isl_set_from_cloog_domain(template);
 	isl_space *space = isl_set_get_space(set);
-	return cloog_domain_from_isl_set(isl_set_empty(space));
+	return domain_from_isl_set(isl_set_empty(space), template->state);
 }
 
 
@@ -348,7 +852,57 @@ CloogDomain *cloog_domain_empty(CloogDomain *template)
 int cloog_domain_is_bounded(CloogDomain *dom, unsigned level)
 {
 	isl_set *set = isl_set_from_cloog_domain(dom);
-	return isl_set_dim_is_bounded(set, isl_dim_set, level - 1);
+	CloogState *state;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
+	int bounded;
+
+	state = domain_count(dom, CLOOG_PRIM_IS_BOUNDED);
+	entry = memo_lookup(state, cloog_memo_is_bounded, set, NULL, level, &key);
+	if (entry)
+		return entry->value;
+	bounded = isl_set_dim_is_bounded(set, isl_dim_set, level - 1);
+	memo_int_result(&key, bounded);
+	return bounded;
+}
+
+
+/**
+ * cloog_domain_level_bounds function:
+ * Computes constant bounds, valid for all values of the parameters, on the
+ * dimension (level) of (domain). *has_lower (resp. *has_upper) is set to 0
+ * if there is no such lower (resp. upper) bound, in which case *lower (resp.
+ * *upper) is left untouched.
+ */
+void cloog_domain_level_bounds(CloogDomain *domain, int level,
+	cloog_int_t *lower, int *has_lower, cloog_int_t *upper, int *has_upper)
+{
+	isl_set *set = isl_set_from_cloog_domain(domain);
+	isl_local_space *ls;
+	isl_aff *aff;
+	isl_val *v;
+
+	domain_count(domain, CLOOG_PRIM_LEVEL_BOUNDS);
+	ls = isl_local_space_from_space(isl_set_get_space(set));
+	aff = isl_aff_var_on_domain(ls, isl_dim_set, level - 1);
+
+	v = isl_set_min_val(set, aff);
+	*has_lower = isl_val_is_rat(v) > 0;
+	if (*has_lower) {
+		v = isl_val_ceil(v);
+		isl_val_to_cloog_int(v, lower);
+	}
+	isl_val_free(v);
+
+	v = isl_set_max_val(set, aff);
+	*has_upper = isl_val_is_rat(v) > 0;
+	if (*has_upper) {
+		v = isl_val_floor(v);
+		isl_val_to_cloog_int(v, upper);
+	}
+	isl_val_free(v);
+
+	isl_aff_free(aff);
 }
 
 
@@ -441,7 +995,7 @@ CloogDomain *cloog_domain_read_context(CloogState *state, FILE *input)
 	set = isl_set_move_dims(set, isl_dim_param, 0,
 				isl_dim_set, 0, isl_set_dim(set, isl_dim_set));
 
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, state);
 }
 
 
@@ -451,12 +1005,13 @@ CloogDomain *cloog_domain_read_context(CloogState *state, FILE *input)
  */
 CloogDomain *cloog_domain_from_context(CloogDomain *context)
 {
-	isl_set *set = isl_set_from_cloog_domain(context);
+	CloogState *state = context->state;
+	isl_set *set = domain_take_set(context);
 
 	set = isl_set_move_dims(set, isl_dim_set, 0,
 			    isl_dim_param, 0, isl_set_dim(set, isl_dim_param));
 
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, state);
 }
 
 
@@ -477,7 +1032,7 @@ CloogDomain *cloog_domain_union_read(CloogState *state,
 		set = isl_set_move_dims(set, isl_dim_param, 0,
 			    isl_dim_set, dim - nb_parameters, nb_parameters);
 	}
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, state);
 }
 
 
@@ -636,7 +1191,7 @@ CloogDomain *cloog_domain_from_cloog_matrix(CloogState *state,
 
 	bset = isl_basic_set_read_from_matrix(ctx, matrix, nparam);
 
-	return cloog_domain_from_isl_set(isl_set_from_basic_set(bset));
+	return domain_from_isl_set(isl_set_from_basic_set(bset), state);
 }
 
 /**
@@ -681,7 +1236,7 @@ CloogDomain *cloog_domain_from_osl_relation(CloogState *state,
     set = isl_set_read_from_str(ctx, str);
     free(str);
 
-    domain = cloog_domain_from_isl_set(set);
+    domain = domain_from_isl_set(set, state);
   }
 
   return domain;
@@ -721,7 +1276,18 @@ CloogScattering *cloog_scattering_from_osl_relation(CloogState *state,
 int cloog_domain_isempty(CloogDomain *domain)
 {
 	isl_set *set = isl_set_from_cloog_domain(domain);
-	return isl_set_is_empty(set);
+	CloogState *state;
+	struct cloog_domain_memo_key key;
+	struct cloog_domain_memo_entry *entry;
+	int empty;
+
+	state = domain_count(domain, CLOOG_PRIM_ISEMPTY);
+	entry = memo_lookup(state, cloog_memo_isempty, set, NULL, 0, &key);
+	if (entry)
+		return entry->value;
+	empty = isl_set_is_empty(set);
+	memo_int_result(&key, empty);
+	return empty;
 }
 
 
@@ -736,7 +1302,7 @@ CloogDomain *cloog_domain_universe(CloogState *state, unsigned dim)
 
 	dims = isl_space_set_alloc(state->backend->ctx, 0, dim);
 	bset = isl_basic_set_universe(dims);
-	return cloog_domain_from_isl_set(isl_set_from_basic_set(bset));
+	return domain_from_isl_set(isl_set_from_basic_set(bset), state);
 }
 
 
@@ -748,13 +1314,14 @@ CloogDomain *cloog_domain_universe(CloogState *state, unsigned dim)
 CloogDomain *cloog_domain_project(CloogDomain *domain, int level)
 {
 	isl_set *set = isl_set_from_cloog_domain(domain);
+	domain_count(domain, CLOOG_PRIM_PROJECT);
 	set = isl_set_remove_dims(isl_set_copy(set), isl_dim_set,
 					level, isl_set_n_dim(set) - level);
 	set = isl_set_compute_divs(set);
 	if (level > 0)
 		set = isl_set_remove_divs_involving_dims(set,
 						isl_dim_set, level - 1, 1);
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, domain->state);
 }
 
 
@@ -768,8 +1335,9 @@ CloogDomain *cloog_domain_extend(CloogDomain *domain, int dim)
 {
 	isl_set *set = isl_set_from_cloog_domain(domain);
 	int n = isl_set_dim(set, isl_dim_set);
+	domain_count(domain, CLOOG_PRIM_EXTEND);
 	set = isl_set_add_dims(isl_set_copy(set), isl_dim_set, dim - n);
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, domain->state);
 }
 
 
@@ -782,6 +1350,7 @@ CloogDomain *cloog_domain_extend(CloogDomain *domain, int dim)
 int cloog_domain_never_integral(CloogDomain * domain)
 {
 	isl_set *set = isl_set_from_cloog_domain(domain);
+	domain_count(domain, CLOOG_PRIM_NEVER_INTEGRAL);
 	return isl_set_is_empty(set);
 }
 
@@ -803,6 +1372,7 @@ int cloog_domain_is_otl(CloogDomain *domain, int level)
 	isl_set *set = isl_set_from_cloog_domain(domain);
 	isl_map *map;
 
+	domain_count(domain, CLOOG_PRIM_IS_OTL);
 	map = isl_map_from_domain(isl_set_copy(set));
 	map = isl_map_move_dims(map, isl_dim_out, 0, isl_dim_in, level - 1, 1);
 	otl = isl_map_is_single_valued(map);
@@ -835,6 +1405,7 @@ void cloog_domain_stride(CloogDomain *domain, int strided_level,
 	isl_set *set = isl_set_from_cloog_domain(domain);
 	isl_val *stride_val = NULL;
 	isl_val *offset_val = NULL;
+	domain_count(domain, CLOOG_PRIM_STRIDE);
 	ret = isl_set_dim_residue_class_val(set, strided_level - 1, &stride_val, &offset_val);
 	if (ret != 0)
 		cloog_die("failure to compute stride.\n");
@@ -914,6 +1485,7 @@ int cloog_domain_can_stride(CloogDomain *domain, int level)
 	struct cloog_can_stride ccs = { level, 1 };
 	isl_set *set = isl_set_from_cloog_domain(domain);
 	int r;
+	domain_count(domain, CLOOG_PRIM_CAN_STRIDE);
 	r = isl_set_foreach_basic_set(set, basic_set_can_stride, &ccs);
 	assert(r == 0);
 	return ccs.can_stride;
@@ -1098,8 +1670,10 @@ CloogDomain *cloog_domain_stride_lower_bound(CloogDomain *domain, int level,
 {
 	struct cloog_stride_lower csl;
 	isl_set *set = isl_set_from_cloog_domain(domain);
+	CloogDomain *res;
 	int r;
 
+	domain_count(domain, CLOOG_PRIM_STRIDE_LOWER_BOUND);
 	csl.stride = stride;
 	csl.level = level;
 	csl.set = isl_set_empty(isl_set_get_space(set));
@@ -1107,8 +1681,9 @@ CloogDomain *cloog_domain_stride_lower_bound(CloogDomain *domain, int level,
 	r = isl_set_foreach_basic_set(set, basic_set_stride_lower, &csl);
 	assert(r == 0);
 
+	res = domain_from_isl_set(csl.set, domain->state);
 	cloog_domain_free(domain);
-	return cloog_domain_from_isl_set(csl.set);
+	return res;
 }
 
 
@@ -1118,17 +1693,20 @@ CloogDomain *cloog_domain_add_stride_constraint(CloogDomain *domain,
 	CloogStride *stride)
 {
 	isl_constraint *c;
+	CloogState *state;
 	isl_set *set;
 
 	if (!stride || !stride->constraint)
 		return domain;
 
-	set = isl_set_from_cloog_domain(domain);
+	domain_count(domain, CLOOG_PRIM_ADD_STRIDE_CONSTRAINT);
+	state = domain->state;
+	set = domain_take_set(domain);
 	c = isl_constraint_copy(cloog_constraint_to_isl(stride->constraint));
 
 	set = isl_set_add_constraint(set, c);
 
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, state);
 }
 
 
@@ -1141,6 +1719,7 @@ int cloog_domain_lazy_equal(CloogDomain *d1, CloogDomain *d2)
 {
 	isl_set *set1 = isl_set_from_cloog_domain(d1);
 	isl_set *set2 = isl_set_from_cloog_domain(d2);
+	domain_count(d1, CLOOG_PRIM_LAZY_EQUAL);
 	return isl_set_plain_is_equal(set1, set2);
 }
 
@@ -1212,11 +1791,300 @@ CloogDomain *cloog_domain_bound_splitter(CloogDomain *dom, int level)
 	struct cloog_bound_split cbs;
 	isl_set *set = isl_set_from_cloog_domain(dom);
 	int r;
+	domain_count(dom, CLOOG_PRIM_BOUND_SPLITTER);
 	cbs.level = level;
 	cbs.set = isl_set_universe(isl_set_get_space(set));
 	r = isl_set_foreach_basic_set(set, basic_set_bound_split, &cbs);
 	assert(r == 0);
-	return cloog_domain_from_isl_set(cbs.set);
+	return domain_from_isl_set(cbs.set, dom->state);
+}
+
+struct cloog_minmax_split {
+	int pos;
+	int fixed;
+	int n_lower;
+	int n_upper;
+	isl_aff **lower;
+	isl_aff **upper;
+};
+
+static int constraint_minmax_split(__isl_take isl_constraint *c, void *user)
+{
+	struct cloog_minmax_split *cms = (struct cloog_minmax_split *)user;
+	isl_val *v;
+	isl_aff *bound;
+
+	v = isl_constraint_get_coefficient_val(c, isl_dim_set, cms->pos);
+	if (isl_val_is_zero(v))
+		goto done;
+	if (isl_constraint_is_equality(c)) {
+		cms->fixed = 1;
+		goto done;
+	}
+	bound = isl_constraint_get_bound(c, isl_dim_set, cms->pos);
+	if (isl_val_is_pos(v))
+		cms->lower[cms->n_lower++] = bound;
+	else
+		cms->upper[cms->n_upper++] = bound;
+done:
+	isl_val_free(v);
+	isl_constraint_free(c);
+	return cms->fixed ? -1 : 0;
+}
+
+/* Return the set where the bound "a" is greater than or equal to
+ * the bound "b", or strictly greater if "strict" is set, assuming that
+ * the variables and parameters only take integer values.
+ */
+static __isl_give isl_set *bound_dominates(__isl_keep isl_aff *a,
+	__isl_keep isl_aff *b, int strict)
+{
+	isl_aff *diff;
+
+	diff = isl_aff_sub(isl_aff_copy(a), isl_aff_copy(b));
+	if (strict) {
+		diff = isl_aff_scale_val(diff, isl_aff_get_denominator_val(diff));
+		diff = isl_aff_add_constant_si(diff, -1);
+	}
+	return isl_aff_nonneg_set(diff);
+}
+
+/* Return the set where bound[i] is the first of the "n" bounds that is
+ * the greatest ("sign" = 1) or the smallest ("sign" = -1).
+ */
+static __isl_give isl_set *bound_region(__isl_keep isl_space *space,
+	isl_aff **bound, int n, int i, int sign)
+{
+	int j;
+	isl_set *region;
+
+	region = isl_set_universe(isl_space_copy(space));
+	for (j = 0; j < n; ++j) {
+		if (j == i)
+			continue;
+		if (sign > 0)
+			region = isl_set_intersect(region,
+				bound_dominates(bound[i], bound[j], j < i));
+		else
+			region = isl_set_intersect(region,
+				bound_dominates(bound[j], bound[i], j < i));
+	}
+	return region;
+}
+
+/**
+ * Return a union of disjoint sets S_i such that, when "dom" is intersected
+ * with one of the sets S_i, a single one of its lower bounds and a single
+ * one of its upper bounds on the dimension at "level" remain relevant.
+ * The sets S_i do not involve the dimensions starting at "level" and
+ * are returned in the space where those dimensions have been removed,
+ * i.e., the space of the enclosing loops.
+ * Within S_i, the selected lower bound is the first greatest one and
+ * the selected upper bound the first smallest one.
+ * NULL is returned if "dom" is not convex, if its dimension at "level"
+ * is fixed by an equality, if it already has at most one lower and one
+ * upper bound on that dimension, or if more than "max" sets would
+ * intersect "dom".
+ */
+CloogDomain *cloog_domain_minmax_splitter(CloogDomain *dom, int level,
+	int max)
+{
+	struct cloog_minmax_split cms;
+	isl_set *set = isl_set_from_cloog_domain(dom);
+	isl_basic_set *bset;
+	isl_space *space;
+	isl_set *res = NULL, *lower, *piece, *inter;
+	int i, j, n_lower, n_upper, n = 0, n_con, empty;
+
+	domain_count(dom, CLOOG_PRIM_MINMAX_SPLITTER);
+	if (isl_set_n_basic_set(set) != 1)
+		return NULL;
+
+	bset = isl_set_simple_hull(isl_set_copy(set));
+	bset = isl_basic_set_remove_redundancies(bset);
+	n_con = isl_basic_set_n_constraint(bset);
+	cms.pos = level - 1;
+	cms.fixed = 0;
+	cms.n_lower = 0;
+	cms.n_upper = 0;
+	cms.lower = (isl_aff **)malloc((n_con + 1) * sizeof(isl_aff *));
+	cms.upper = (isl_aff **)malloc((n_con + 1) * sizeof(isl_aff *));
+	if (!cms.lower || !cms.upper)
+		cloog_die("memory overflow.\n");
+	isl_basic_set_foreach_constraint(bset, constraint_minmax_split, &cms);
+	isl_basic_set_free(bset);
+
+	n_lower = cms.n_lower ? cms.n_lower : 1;
+	n_upper = cms.n_upper ? cms.n_upper : 1;
+	if (cms.fixed || n_lower * n_upper <= 1)
+		goto done;
+
+	space = isl_set_get_space(set);
+	for (i = 0; i < n_lower && n <= max; ++i) {
+		lower = cms.n_lower ?
+			bound_region(space, cms.lower, cms.n_lower, i, 1) :
+			isl_set_universe(isl_space_copy(space));
+		for (j = 0; j < n_upper && n <= max; ++j) {
+			piece = isl_set_copy(lower);
+			if (cms.n_upper)
+				piece = isl_set_intersect(piece,
+				    bound_region(space, cms.upper, cms.n_upper,
+						 j, -1));
+			inter = isl_set_intersect(isl_set_copy(piece),
+						  isl_set_copy(set));
+			empty = isl_set_is_empty(inter);
+			isl_set_free(inter);
+			if (empty) {
+				isl_set_free(piece);
+				continue;
+			}
+			n++;
+			res = res ? isl_set_union(res, piece) : piece;
+		}
+		isl_set_free(lower);
+	}
+	isl_space_free(space);
+
+	if (n <= 1 || n > max) {
+		isl_set_free(res);
+		res = NULL;
+	} else
+		res = isl_set_remove_dims(res, isl_dim_set, level - 1,
+					  isl_set_n_dim(res) - (level - 1));
+done:
+	for (i = 0; i < cms.n_lower; ++i)
+		isl_aff_free(cms.lower[i]);
+	for (i = 0; i < cms.n_upper; ++i)
+		isl_aff_free(cms.upper[i]);
+	free(cms.lower);
+	free(cms.upper);
+
+	return res ? domain_from_isl_set(res, dom->state) : NULL;
+}
+
+struct cloog_full_tiles {
+	int level;
+	int n_dim;
+	int *tiled;
+	isl_basic_set *tile;
+	isl_set *box;
+};
+
+/* Does "c" involve a dimension before "level"
+ * (or an existentially quantified variable)?
+ */
+static int constraint_ties_outer(__isl_keep isl_constraint *c, int level)
+{
+	int n_div = isl_constraint_dim(c, isl_dim_div);
+
+	return isl_constraint_involves_dims(c, isl_dim_set, 0, level - 1) ||
+	       isl_constraint_involves_dims(c, isl_dim_div, 0, n_div);
+}
+
+/* Mark the dimensions starting at level that are involved in "c"
+ * as tiled if "c" also involves an outer dimension, i.e., if it is
+ * (part of) the bound of a tile.
+ */
+static int constraint_mark_tiled(__isl_take isl_constraint *c, void *user)
+{
+	struct cloog_full_tiles *cft = (struct cloog_full_tiles *)user;
+	int i;
+
+	if (constraint_ties_outer(c, cft->level))
+		for (i = cft->level - 1; i < cft->n_dim; ++i)
+			if (isl_constraint_involves_dims(c, isl_dim_set, i, 1))
+				cft->tiled[i] = 1;
+	isl_constraint_free(c);
+	return 0;
+}
+
+/* Add constraint "c" to the tile, unless it is an inequality that only
+ * bounds tiled dimensions starting at level, i.e., a boundary of the
+ * original domain rather than a bound of a tile.  The bounds of the
+ * dimensions that are not tiled, e.g., those of "k" in a nest where only
+ * "i" and "j" are tiled, are kept, since the tile would be unbounded
+ * without them.
+ */
+static int constraint_full_tiles(__isl_take isl_constraint *c, void *user)
+{
+	struct cloog_full_tiles *cft = (struct cloog_full_tiles *)user;
+	int i, only_tiled = 1;
+
+	for (i = cft->level - 1; i < cft->n_dim; ++i)
+		if (!cft->tiled[i] &&
+		    isl_constraint_involves_dims(c, isl_dim_set, i, 1))
+			only_tiled = 0;
+
+	if (!isl_constraint_is_equality(c) && only_tiled &&
+	    isl_constraint_involves_dims(c, isl_dim_set, cft->level - 1,
+					 cft->n_dim - (cft->level - 1)) &&
+	    !constraint_ties_outer(c, cft->level)) {
+		isl_constraint_free(c);
+		return 0;
+	}
+
+	cft->tile = isl_basic_set_add_constraint(cft->tile, c);
+	return 0;
+}
+
+static int basic_set_full_tiles(__isl_take isl_basic_set *bset, void *user)
+{
+	struct cloog_full_tiles *cft = (struct cloog_full_tiles *)user;
+	int i, r;
+
+	for (i = 0; i < cft->n_dim; ++i)
+		cft->tiled[i] = 0;
+	r = isl_basic_set_foreach_constraint(bset, constraint_mark_tiled, cft);
+	cft->tile = isl_basic_set_universe(isl_basic_set_get_space(bset));
+	if (r == 0)
+		r = isl_basic_set_foreach_constraint(bset,
+						     constraint_full_tiles, cft);
+	isl_basic_set_free(bset);
+	cft->box = isl_set_union(cft->box, isl_set_from_basic_set(cft->tile));
+	return r;
+}
+
+/**
+ * Return the set of values of the dimensions before "level" for which
+ * all the points of the "tile" they define belong to "dom", i.e., the
+ * region of full tiles, in the space where the dimensions starting at
+ * "level" have been removed.  The tile of a basic set of "dom" is that
+ * basic set without the inequalities that bound tiled dimensions starting
+ * at "level" independently of the dimensions before "level", such as
+ * "i <= N" in a domain also bounded by "32*t <= i <= 32*t+31".
+ * The result is restricted to the projection of "dom" and may be empty.
+ */
+CloogDomain *cloog_domain_full_tiles(CloogDomain *dom, int level)
+{
+	struct cloog_full_tiles cft;
+	isl_set *set = isl_set_from_cloog_domain(dom);
+	isl_set *box, *partial, *full;
+	int r, n;
+
+	domain_count(dom, CLOOG_PRIM_FULL_TILES);
+	n = isl_set_n_dim(set);
+	assert(level >= 1 && level <= n);
+
+	cft.level = level;
+	cft.n_dim = n;
+	cft.tiled = (int *)malloc(n * sizeof(int));
+	if (!cft.tiled)
+		cloog_die("memory overflow.\n");
+	cft.box = isl_set_empty(isl_set_get_space(set));
+	r = isl_set_foreach_basic_set(set, basic_set_full_tiles, &cft);
+	assert(r == 0);
+	free(cft.tiled);
+	box = cft.box;
+
+	partial = isl_set_subtract(isl_set_copy(box), isl_set_copy(set));
+	partial = isl_set_project_out(partial, isl_dim_set,
+					level - 1, n - (level - 1));
+	box = isl_set_project_out(box, isl_dim_set, level - 1, n - (level - 1));
+	full = isl_set_subtract(box, partial);
+	full = isl_set_intersect(full, isl_set_project_out(isl_set_copy(set),
+				isl_dim_set, level - 1, n - (level - 1)));
+
+	return domain_from_isl_set(full, dom->state);
 }
 
 
@@ -1334,29 +2202,449 @@ int cloog_domain_lazy_disjoint(CloogDomain *d1, CloogDomain *d2)
 {
 	isl_set *set1 = isl_set_from_cloog_domain(d1);
 	isl_set *set2 = isl_set_from_cloog_domain(d2);
+	domain_count(d1, CLOOG_PRIM_LAZY_DISJOINT);
 	return isl_set_plain_is_disjoint(set1, set2);
 } 
  
  
+#ifdef CLOOG_THREADS
+/* Work shared by the threads of cloog_domain_separation_pieces.
+ * Domains are handed over as strings since an isl_ctx, and therefore
+ * any set living in it, may only be used by one thread at a time.
+ * The pieces computed by the threads are handed back the same way,
+ * each of them being printed once, and only if it is not empty.
+ */
+struct cloog_separation_work {
+	char *domain;
+	char **doms;
+	int n;
+	int next;
+	pthread_mutex_t lock;
+	char **inter;
+	int *inter_empty;
+	char **diff;
+	int *diff_empty;
+};
+
+struct cloog_separation_thread {
+	struct cloog_separation_work *work;
+	isl_ctx *ctx;
+};
+
+/* Normalize "set" as domain_from_isl_set does, check whether it is empty
+ * and, if not, print it to *str.  Return 1 if "set" is empty, 0 if not
+ * and -1 on error.
+ */
+static int separation_piece(__isl_take isl_set *set, char **str)
+{
+	int empty;
+
+	set = isl_set_detect_equalities(set);
+	set = isl_set_compute_divs(set);
+	empty = isl_set_is_empty(set);
+	if (empty == 0)
+		*str = isl_set_to_str(set);
+	if (empty == 0 && !*str)
+		empty = -1;
+	isl_set_free(set);
+	return empty;
+}
+
+static void *separation_thread(void *user)
+{
+	struct cloog_separation_thread *thread = user;
+	struct cloog_separation_work *work = thread->work;
+	isl_set *domain, *set, *test;
+	int i;
+
+	domain = isl_set_read_from_str(thread->ctx, work->domain);
+	for (;;) {
+		pthread_mutex_lock(&work->lock);
+		i = work->next++;
+		pthread_mutex_unlock(&work->lock);
+		if (i >= work->n)
+			break;
+		if (!domain)
+			continue;
+		set = isl_set_read_from_str(thread->ctx, work->doms[i]);
+		if (!set)
+			continue;
+		test = isl_set_intersect(isl_set_copy(set), isl_set_copy(domain));
+		work->inter_empty[i] = separation_piece(test, &work->inter[i]);
+		test = isl_set_subtract(set, isl_set_copy(domain));
+		work->diff_empty[i] = separation_piece(test, &work->diff[i]);
+	}
+	isl_set_free(domain);
+
+	return NULL;
+}
+
+/* Return the first n worker contexts of state, allocating them if needed.
+ */
+static isl_ctx **worker_ctx(CloogState *state, int n)
+{
+	CloogBackend *backend = state->backend;
+
+	if (n > backend->nb_worker_ctx) {
+		backend->worker_ctx = realloc(backend->worker_ctx,
+					      n * sizeof(isl_ctx *));
+		if (!backend->worker_ctx)
+			cloog_die("memory overflow.\n");
+		for (; backend->nb_worker_ctx < n; ++backend->nb_worker_ctx)
+			backend->worker_ctx[backend->nb_worker_ctx] =
+							isl_ctx_alloc();
+	}
+
+	return backend->worker_ctx;
+}
+#endif
+
+
+/* Give the dimensions of "set" the names they have in "template".
+ * The textual form names the parameters and variables that have no name.
+ */
+static __isl_give isl_set *separation_copy_names(__isl_take isl_set *set,
+	isl_set *template)
+{
+	enum isl_dim_type types[] = { isl_dim_param, isl_dim_set };
+	int i, t;
+	isl_size n;
+
+	for (t = 0; t < 2; ++t) {
+		n = isl_set_dim(template, types[t]);
+		for (i = 0; set && i < n; ++i)
+			set = isl_set_set_dim_name(set, types[t], i,
+				isl_set_get_dim_name(template, types[t], i));
+	}
+	return isl_set_set_tuple_name(set, isl_set_get_tuple_name(template));
+}
+
+/* Read back the piece "str" computed by a worker of
+ * cloog_domain_separation_pieces in the context of "template".
+ * The piece has been normalized by the worker.
+ */
+static CloogDomain *separation_read_piece(CloogDomain *template, char *str)
+{
+	isl_set *set = isl_set_from_cloog_domain(template);
+	CloogDomain *domain;
+
+	domain = (CloogDomain *)malloc(sizeof(CloogDomain));
+	if (!domain)
+		cloog_die("memory overflow.\n");
+	domain->references = 1;
+	domain->state = template->state;
+	domain->set = isl_set_read_from_str(isl_set_get_ctx(set), str);
+	domain->set = separation_copy_names(domain->set, set);
+	free(str);
+	if (!domain->set) {
+		free(domain);
+		return NULL;
+	}
+	return domain;
+}
+
+/**
+ * cloog_domain_separation_pieces function:
+ * For each of the (n) domains in (doms), this function computes
+ * doms[i] \cap domain and doms[i] \ domain, spreading the work over
+ * (nb_threads) threads, each of them working in its own isl_ctx.
+ * inter_empty[i] is set to 1 if the intersection is empty, to 0 if it is
+ * not, in which case inter[i] is set to the intersection, and to -1 if
+ * the threads were unable to compute it, in which case inter[i] is NULL.
+ * The same holds for diff_empty[i] and diff[i] with the difference.
+ * The sets are handed over in their textual form, which is parsed once
+ * in the context of the caller.
+ * Without thread support, or with fewer than two threads, nothing is
+ * computed.
+ */
+void cloog_domain_separation_pieces(CloogState *state, int nb_threads,
+	CloogDomain *domain, int n, CloogDomain **doms,
+	CloogDomain **inter, int *inter_empty,
+	CloogDomain **diff, int *diff_empty)
+{
+	int i;
+#ifdef CLOOG_THREADS
+	isl_ctx **ctx;
+	pthread_t *threads;
+	struct cloog_separation_work work;
+	struct cloog_separation_thread *thread;
+	int nb_started;
+#endif
+
+	for (i = 0; i < n; ++i) {
+		inter[i] = NULL;
+		inter_empty[i] = -1;
+		diff[i] = NULL;
+		diff_empty[i] = -1;
+	}
+
+#ifdef CLOOG_THREADS
+	if (nb_threads > n)
+		nb_threads = n;
+	if (nb_threads < 2)
+		return;
+
+	ctx = worker_ctx(state, nb_threads);
+
+	work.domain = isl_set_to_str(isl_set_from_cloog_domain(domain));
+	work.doms = (char **)malloc(n * sizeof(char *));
+	work.inter = (char **)malloc(n * sizeof(char *));
+	work.diff = (char **)malloc(n * sizeof(char *));
+	threads = (pthread_t *)malloc(nb_threads * sizeof(pthread_t));
+	thread = (struct cloog_separation_thread *)
+		malloc(nb_threads * sizeof(struct cloog_separation_thread));
+	if (!work.doms || !work.inter || !work.diff || !threads || !thread)
+		cloog_die("memory overflow.\n");
+	for (i = 0; i < n; ++i) {
+		work.doms[i] = isl_set_to_str(isl_set_from_cloog_domain(doms[i]));
+		work.inter[i] = NULL;
+		work.diff[i] = NULL;
+	}
+	work.n = n;
+	work.next = 0;
+	work.inter_empty = inter_empty;
+	work.diff_empty = diff_empty;
+	pthread_mutex_init(&work.lock, NULL);
+
+	nb_started = 0;
+	for (i = 0; i < nb_threads; ++i) {
+		thread[i].work = &work;
+		thread[i].ctx = ctx[i];
+		if (pthread_create(&threads[nb_started], NULL,
+				   &separation_thread, &thread[i]) == 0)
+			nb_started++;
+	}
+	/* If no thread could be started, do the work here, it remains
+	 * confined to a worker context.
+	 */
+	if (!nb_started)
+		separation_thread(&thread[0]);
+	for (i = 0; i < nb_started; ++i)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&work.lock);
+	for (i = 0; i < n; ++i) {
+		if (inter_empty[i] == 0) {
+			inter[i] = separation_read_piece(doms[i], work.inter[i]);
+			if (!inter[i])
+				inter_empty[i] = -1;
+		}
+		if (diff_empty[i] == 0) {
+			diff[i] = separation_read_piece(doms[i], work.diff[i]);
+			if (!diff[i])
+				diff_empty[i] = -1;
+		}
+		free(work.doms[i]);
+	}
+	free(work.diff);
+	free(work.inter);
+	free(work.doms);
+	free(work.domain);
+	free(thread);
+	free(threads);
+#else
+	(void) state;
+	(void) nb_threads;
+	(void) domain;
+	(void) doms;
+#endif
+}
+
+
+#ifdef CLOOG_THREADS
+struct cloog_sort_work {
+	char **doms;
+	unsigned n;
+	unsigned level;
+	unsigned next;
+	pthread_mutex_t lock;
+	struct cloog_sort_cmp *table;
+};
+
+struct cloog_sort_thread {
+	struct cloog_sort_work *work;
+	isl_ctx *ctx;
+};
+
+/* Compare each domain with all the domains of smaller index, handing out
+ * one row of the table at a time.  Each row is written by a single thread.
+ */
+static void *sort_thread(void *user)
+{
+	struct cloog_sort_thread *thread = user;
+	struct cloog_sort_work *work = thread->work;
+	struct cloog_sort_cmp *table = work->table;
+	isl_basic_set **bset;
+	unsigned i, j;
+	int cmp;
+
+	bset = (isl_basic_set **)malloc(work->n * sizeof(isl_basic_set *));
+	if (!bset)
+		return NULL;
+	for (i = 0; i < work->n; ++i)
+		bset[i] = isl_basic_set_read_from_str(thread->ctx,
+							work->doms[i]);
+
+	for (;;) {
+		pthread_mutex_lock(&work->lock);
+		i = work->next++;
+		pthread_mutex_unlock(&work->lock);
+		if (i >= work->n)
+			break;
+		if (!bset[i])
+			continue;
+		for (j = 0; j < i; ++j) {
+			if (!bset[j])
+				break;
+			cmp = isl_basic_set_compare_at(bset[i], bset[j],
+							work->level - 1);
+			if (cmp > 0)
+				bitset_set(table->gt + i * table->words, j);
+			else if (cmp < 0)
+				bitset_set(table->lt + i * table->words, j);
+		}
+		table->decided[i] = j == i;
+	}
+
+	for (i = 0; i < work->n; ++i)
+		isl_basic_set_free(bset[i]);
+	free(bset);
+
+	return NULL;
+}
+#endif
+
+
+/**
+ * cloog_domain_sort_parallel function:
+ * This function computes the same permutation as cloog_domain_sort, but
+ * the comparisons of the pairs of domains are first spread over
+ * (nb_threads) threads, each of them working in its own isl_ctx.  All the
+ * pairs are compared, including those whose order follows by transitivity,
+ * so this only pays off with enough threads.  The rows of comparisons that
+ * could not be made by the threads are made sequentially.
+ */
+void cloog_domain_sort_parallel(CloogState *state, int nb_threads,
+	CloogDomain **doms, unsigned nb_doms, unsigned level, int *permut)
+{
+#ifdef CLOOG_THREADS
+	unsigned i;
+	isl_ctx **ctx;
+	pthread_t *threads;
+	struct cloog_sort_cmp table;
+	struct cloog_sort_work work;
+	struct cloog_sort_thread *thread;
+	int nb_started;
+
+	if ((unsigned)nb_threads > nb_doms)
+		nb_threads = nb_doms;
+	if (nb_threads < 2) {
+		domain_sort(doms, nb_doms, level, permut, NULL);
+		return;
+	}
+
+	ctx = worker_ctx(state, nb_threads);
+
+	table.words = bitset_words(nb_doms);
+	table.gt = (unsigned long *)calloc(nb_doms * table.words,
+						sizeof(unsigned long));
+	table.lt = (unsigned long *)calloc(nb_doms * table.words,
+						sizeof(unsigned long));
+	table.decided = (int *)calloc(nb_doms, sizeof(int));
+	work.doms = (char **)malloc(nb_doms * sizeof(char *));
+	threads = (pthread_t *)malloc(nb_threads * sizeof(pthread_t));
+	thread = (struct cloog_sort_thread *)
+		malloc(nb_threads * sizeof(struct cloog_sort_thread));
+	if (!table.gt || !table.lt || !table.decided || !work.doms ||
+	    !threads || !thread)
+		cloog_die("memory overflow.\n");
+	for (i = 0; i < nb_doms; ++i)
+		work.doms[i] = isl_set_to_str(isl_set_from_cloog_domain(doms[i]));
+	work.n = nb_doms;
+	work.level = level;
+	work.next = 0;
+	work.table = &table;
+	pthread_mutex_init(&work.lock, NULL);
+
+	nb_started = 0;
+	for (i = 0; i < (unsigned)nb_threads; ++i) {
+		thread[i].work = &work;
+		thread[i].ctx = ctx[i];
+		if (pthread_create(&threads[nb_started], NULL,
+				   &sort_thread, &thread[i]) == 0)
+			nb_started++;
+	}
+	for (i = 0; i < (unsigned)nb_started; ++i)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&work.lock);
+
+	domain_sort(doms, nb_doms, level, permut, &table);
+
+	for (i = 0; i < nb_doms; ++i)
+		free(work.doms[i]);
+	free(work.doms);
+	free(thread);
+	free(threads);
+	free(table.decided);
+	free(table.lt);
+	free(table.gt);
+#else
+	(void) state;
+	(void) nb_threads;
+	domain_sort(doms, nb_doms, level, permut, NULL);
+#endif
+}
+
+
+/* A scattering function along with its hash, for sorting them. */
+struct cloog_scattering_hash {
+	uint32_t hash;
+	isl_map *map;
+};
+
+static int scattering_hash_cmp(const void *p1, const void *p2)
+{
+	const struct cloog_scattering_hash *h1 = p1, *h2 = p2;
+
+	return h1->hash < h2->hash ? -1 : h1->hash > h2->hash;
+}
+
 /**
  * cloog_scattering_list_lazy_same function:
  * This function returns 1 if two domains in the list are the same, 0 if it
  * is unable to decide.
+ * Maps that are plainly equal have the same hash, so only the maps with
+ * equal hashes need to be compared after sorting them by hash.
  */
 int cloog_scattering_list_lazy_same(CloogScatteringList *list)
 {
-	CloogScatteringList *one, *other;
-	isl_map *one_map, *other_map;
+	int i, j, n, same = 0;
+	CloogScatteringList *one;
+	struct cloog_scattering_hash *h;
 
-	for (one = list; one; one = one->next) {
-		one_map = isl_map_from_cloog_scattering(one->scatt);
-		for (other = one->next; other; other = other->next) {
-			other_map = isl_map_from_cloog_scattering(other->scatt);
-			if (isl_map_plain_is_equal(one_map, other_map))
-				return 1;
-		}
+	for (n = 0, one = list; one; one = one->next)
+		n++;
+	if (n < 2)
+		return 0;
+
+	h = (struct cloog_scattering_hash *)malloc(n * sizeof(*h));
+	if (!h)
+		cloog_die("memory overflow.\n");
+	for (i = 0, one = list; one; ++i, one = one->next) {
+		h[i].map = isl_map_from_cloog_scattering(one->scatt);
+		h[i].hash = isl_map_get_hash(h[i].map);
 	}
-	return 0;
+	qsort(h, n, sizeof(*h), &scattering_hash_cmp);
+
+	for (i = 0; i < n && !same; ++i)
+		for (j = i + 1; j < n && h[j].hash == h[i].hash; ++j)
+			if (isl_map_plain_is_equal(h[i].map, h[j].map) > 0) {
+				same = 1;
+				break;
+			}
+
+	free(h);
+	return same;
 }
 
 int cloog_domain_dimension(CloogDomain * domain)
@@ -1394,7 +2682,8 @@ int cloog_domain_isconvex(CloogDomain * domain)
  */
 CloogDomain *cloog_domain_cut_first(CloogDomain *domain, CloogDomain **rest)
 {
-	isl_set *set = isl_set_from_cloog_domain(domain);
+	CloogState *state = domain->state;
+	isl_set *set = domain_take_set(domain);
 	isl_basic_set *first;
 	isl_basic_set_list *list;
 	int i, n;
@@ -1411,9 +2700,9 @@ CloogDomain *cloog_domain_cut_first(CloogDomain *domain, CloogDomain **rest)
 			isl_basic_set_list_get_basic_set(list, i)));
 	}
 	isl_basic_set_list_free(list);
-	*rest = cloog_domain_from_isl_set(set);
+	*rest = domain_from_isl_set(set, state);
 
-	return cloog_domain_from_isl_set(isl_set_from_basic_set(first));
+	return domain_from_isl_set(isl_set_from_basic_set(first), state);
 }
 
 
@@ -1425,8 +2714,9 @@ CloogDomain *cloog_domain_cut_first(CloogDomain *domain, CloogDomain **rest)
  */
 CloogDomain *cloog_domain_simplify_union(CloogDomain *domain)
 {
-	isl_set *set = isl_set_from_cloog_domain(domain);
-	return cloog_domain_from_isl_set(isl_set_coalesce(set));
+	CloogState *state = domain_count(domain, CLOOG_PRIM_SIMPLIFY_UNION);
+	isl_set *set = domain_take_set(domain);
+	return domain_from_isl_set(isl_set_coalesce(set), state);
 }
 
 
@@ -1470,6 +2760,7 @@ int cloog_domain_lazy_isconstant(CloogDomain *domain, int dimension,
 {
 	isl_set *set = isl_set_from_cloog_domain(domain);
 	isl_val *cst = isl_set_plain_get_val_if_fixed(set, isl_dim_set, dimension);
+	domain_count(domain, CLOOG_PRIM_LAZY_ISCONSTANT);
 	if (cst != NULL) {
 		if (!isl_val_is_nan(cst)){
 			if (value != NULL)
@@ -1528,7 +2819,7 @@ CloogDomain *cloog_domain_cube(CloogState *state,
 		cube = isl_set_upper_bound_val(cube, isl_dim_set, i, max_v);
 	}
 
-	return cloog_domain_from_isl_set(cube);
+	return domain_from_isl_set(cube, state);
 }
 
 /**
@@ -1561,7 +2852,7 @@ CloogDomain *cloog_domain_from_bounds(
     domain = isl_set_upper_bound_val(domain, isl_dim_set, i, max_v);
   }
 
-  return cloog_domain_from_isl_set(domain);
+  return domain_from_isl_set(domain, state);
 }
 
 
@@ -1571,13 +2862,14 @@ CloogDomain *cloog_domain_from_bounds(
  */
 CloogDomain *cloog_domain_scatter(CloogDomain *domain, CloogScattering *scatt)
 {
-	isl_set *set = isl_set_from_cloog_domain(domain);
+	CloogState *state = domain_count(domain, CLOOG_PRIM_SCATTER);
+	isl_set *set = domain_take_set(domain);
 	isl_map *map = isl_map_from_cloog_scattering(scatt);
 
 	map = isl_map_reverse(isl_map_copy(map));
 	map = isl_map_intersect_range(map, set);
 	set = isl_set_flatten(isl_map_wrap(map));
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, state);
 }
 
 static int add_domain_from_map(__isl_take isl_map *map, void *user)
@@ -2058,6 +3350,7 @@ int cloog_domain_can_unroll(CloogDomain *domain, int level, cloog_int_t *n,
 	struct cloog_can_unroll ccu = { 1, level, NULL, set, v };
 	int r;
 
+	domain_count(domain, CLOOG_PRIM_CAN_UNROLL);
 	*lb = NULL;
 	r = isl_set_foreach_basic_set(set, &basic_set_can_unroll, &ccu);
 	assert(r == 0);
@@ -2091,7 +3384,8 @@ CloogDomain *cloog_domain_fixed_offset(CloogDomain *domain,
 	int level, CloogConstraint *lb, cloog_int_t offset)
 {
 	isl_aff *aff;
-	isl_set *set = isl_set_from_cloog_domain(domain);
+	CloogState *state = domain_count(domain, CLOOG_PRIM_FIXED_OFFSET);
+	isl_set *set = domain_take_set(domain);
 	isl_ctx *ctx = isl_set_get_ctx(set);
 	isl_constraint *c;
 	isl_constraint *eq;
@@ -2104,5 +3398,5 @@ CloogDomain *cloog_domain_fixed_offset(CloogDomain *domain,
 	eq = isl_equality_from_aff(aff);
 	set = isl_set_add_constraint(set, eq);
 
-	return cloog_domain_from_isl_set(set);
+	return domain_from_isl_set(set, state);
 }
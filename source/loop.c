@@ -39,6 +39,7 @@
 
 # include <stdlib.h>
 # include <stdio.h>
+# include <sys/time.h>
 # include "../include/cloog/cloog.h"
 
 #define ALLOC(type) (type*)malloc(sizeof(type))
@@ -62,9 +63,11 @@ static CloogLoop *cloog_loop_remove_empty_domain_loops(CloogLoop *loop);
 static CloogLoop *cloog_loop_specialize(CloogLoop *loop, int level, int scalar,
     int *scaldims, int nb_scattdims);
 static CloogLoop *cloog_loop_propagate_lower_bound(CloogLoop *loop, int level);
-static CloogLoop * cloog_loop_separate(CloogLoop * loop);
+static CloogLoop *cloog_loop_separate(CloogLoop *loop, int level,
+    CloogOptions *options);
 static CloogLoop *cloog_loop_merge(CloogLoop *loop, int level,
     CloogOptions *options);
+static int cloog_loop_count(CloogLoop *loop);
 static CloogLoop *cloog_loop_nest(CloogLoop *loop, CloogDomain *context,
     int level);
 static void cloog_loop_stride(CloogLoop * loop, int level);
@@ -268,7 +271,7 @@ void cloog_loop_free(CloogLoop * loop)
     cloog_loop_free(loop->inner) ;
     
     cloog_stride_free(loop->stride);
-    free(loop) ;
+    cloog_state_node_free(loop->state, CLOOG_NODE_LOOP, loop);
     loop = next ;
   }
 }
@@ -303,7 +306,7 @@ int domain, block, inner, next ;
     
     cloog_domain_free(loop->unsimplified);
     cloog_stride_free(loop->stride);
-    free(loop) ;
+    cloog_state_node_free(loop->state, CLOOG_NODE_LOOP, loop);
     if (next)
     loop = follow ;
     else
@@ -393,9 +396,8 @@ CloogLoop *cloog_loop_malloc(CloogState *state)
 { CloogLoop * loop ;
   
   /* Memory allocation for the CloogLoop structure. */
-  loop = (CloogLoop *)malloc(sizeof(CloogLoop)) ;
-  if (loop == NULL) 
-    cloog_die("memory overflow.\n");
+  loop = (CloogLoop *)cloog_state_node_alloc(state, CLOOG_NODE_LOOP,
+					     sizeof(CloogLoop));
   cloog_loop_leak_up(state);
  
   
@@ -494,21 +496,24 @@ void cloog_loop_add_list(CloogLoop ** start, CloogLoop ** now, CloogLoop * loop)
  * - July 3rd->11th 2003: memory leaks hunt and correction.
  */ 
 CloogLoop * cloog_loop_copy(CloogLoop * source)
-{ CloogLoop * loop ;
+{ CloogLoop * loop, * res, ** next ;
   CloogBlock * block ;
   CloogDomain * domain ;
 
-  loop = NULL ;
-  if (source != NULL)
+  /* The siblings are copied iteratively, only the inner loops recurse. */
+  res = NULL ;
+  next = &res ;
+  for (; source != NULL; source = source->next)
   { domain = cloog_domain_copy(source->domain) ;
     block  = cloog_block_copy(source->block) ;
     loop   = cloog_loop_alloc(source->state, domain, source->otl,
 		source->stride, block, NULL,  NULL);
     loop->usr = source->usr;
     loop->inner = cloog_loop_copy(source->inner) ;
-    loop->next = cloog_loop_copy(source->next) ;
+    *next = loop ;
+    next = &loop->next ;
   }
-  return(loop) ;
+  return(res) ;
 }
 
 
@@ -788,6 +793,21 @@ CloogLoop * cloog_loop_concat(CloogLoop * a, CloogLoop * b)
 } 
 
 
+/**
+ * Append the list "b" at "tail", the address of the next field of the last
+ * loop of a list (or of the list itself if it is empty), and return this
+ * address for the resulting list.  Unlike cloog_loop_concat, appending
+ * many lists one after the other this way only walks each of them once.
+ */
+static CloogLoop **cloog_loop_append(CloogLoop **tail, CloogLoop *b)
+{
+    *tail = b;
+    while (*tail)
+	tail = &(*tail)->next;
+    return tail;
+}
+
+
 /**
  * cloog_loop_combine:
  * Combine consecutive loops with identical domains into
@@ -796,14 +816,17 @@ CloogLoop * cloog_loop_concat(CloogLoop * a, CloogLoop * b)
  */
 CloogLoop *cloog_loop_combine(CloogLoop *loop)
 {
-    CloogLoop *first, *second;
+    CloogLoop *first, *second, **tail;
 
     for (first = loop; first; first = first->next) {
+	tail = NULL;
 	while (first->next) {
 	    if (!cloog_domain_lazy_equal(first->domain, first->next->domain))
 		break;
 	    second = first->next;
-	    first->inner = cloog_loop_concat(first->inner, second->inner);
+	    if (!tail)
+		tail = cloog_loop_append(&first->inner, first->inner);
+	    tail = cloog_loop_append(tail, second->inner);
 	    first->next = second->next;
 	    cloog_loop_free_parts(second, 1, 0, 0, 0);
 	}
@@ -905,11 +928,234 @@ CloogLoop *cloog_loop_propagate_lower_bound(CloogLoop *loop, int level)
     return loop;
 }
 
+/**
+ * Constant bounds on the values a loop may take at the level being separated,
+ * valid for all values of the parameters (see cloog_domain_level_bounds).
+ * They are computed once for each loop of the input list of
+ * cloog_loop_separate and then propagated to the loops that are built from
+ * it: the box of an intersection is the intersection of the boxes and the box
+ * of a difference is the box of the first operand. When the boxes of two loops
+ * do not overlap, their domains are disjoint and no polyhedral operation is
+ * needed to find it out.
+ */
+struct cloog_loop_box {
+  int has_lower, has_upper ;
+  cloog_int_t lower, upper ;
+} ;
+
+/* A dynamic array of boxes, the k-th one being the box of the k-th loop of
+ * some loop list.  The (size) allocated boxes stay initialized when the list
+ * is cleared, such that they can be reused.
+ */
+struct cloog_loop_box_list {
+  int n, size ;
+  struct cloog_loop_box *box ;
+} ;
+
+
+static void cloog_loop_box_init(struct cloog_loop_box *box)
+{ box->has_lower = 0 ;
+  box->has_upper = 0 ;
+  cloog_int_init(box->lower) ;
+  cloog_int_init(box->upper) ;
+}
+
+
+static void cloog_loop_box_clear(struct cloog_loop_box *box)
+{ cloog_int_clear(box->lower) ;
+  cloog_int_clear(box->upper) ;
+}
+
+
+static void cloog_loop_box_set(struct cloog_loop_box *dst,
+                               struct cloog_loop_box *src)
+{ dst->has_lower = src->has_lower ;
+  dst->has_upper = src->has_upper ;
+  cloog_int_set(dst->lower, src->lower) ;
+  cloog_int_set(dst->upper, src->upper) ;
+}
+
+
+static void cloog_loop_box_intersect(struct cloog_loop_box *dst,
+                      struct cloog_loop_box *b1, struct cloog_loop_box *b2)
+{ cloog_loop_box_set(dst, b1) ;
+  if (b2->has_lower &&
+      (!dst->has_lower || cloog_int_gt(b2->lower, dst->lower)))
+  { dst->has_lower = 1 ;
+    cloog_int_set(dst->lower, b2->lower) ;
+  }
+  if (b2->has_upper &&
+      (!dst->has_upper || cloog_int_lt(b2->upper, dst->upper)))
+  { dst->has_upper = 1 ;
+    cloog_int_set(dst->upper, b2->upper) ;
+  }
+}
+
+
+/* Returns 1 if the two boxes have no value in common, 0 otherwise. */
+static int cloog_loop_box_disjoint(struct cloog_loop_box *b1,
+                                   struct cloog_loop_box *b2)
+{ if (b1->has_upper && b2->has_lower && cloog_int_lt(b1->upper, b2->lower))
+  return 1 ;
+  if (b2->has_upper && b1->has_lower && cloog_int_lt(b2->upper, b1->lower))
+  return 1 ;
+  return 0 ;
+}
+
+
+/* Returns a new box at the end of (list), initialized but not set. */
+static struct cloog_loop_box *cloog_loop_box_list_next(
+                                    struct cloog_loop_box_list *list)
+{ int i ;
+
+  if (list->n == list->size)
+  { i = list->size ;
+    list->size = 2 * list->size + 8 ;
+    list->box = (struct cloog_loop_box *)realloc(list->box,
+                          list->size * sizeof(struct cloog_loop_box)) ;
+    if (list->box == NULL)
+      cloog_die("memory overflow.\n");
+    for (; i < list->size; i++)
+    cloog_loop_box_init(&list->box[i]) ;
+  }
+  return &list->box[list->n++] ;
+}
+
+
+static void cloog_loop_box_list_add(struct cloog_loop_box_list *list,
+                                    struct cloog_loop_box *box)
+{ cloog_loop_box_set(cloog_loop_box_list_next(list), box) ;
+}
+
+
+static void cloog_loop_box_list_clear(struct cloog_loop_box_list *list)
+{ list->n = 0 ;
+}
+
+
+static void cloog_loop_box_list_free(struct cloog_loop_box_list *list)
+{ int i ;
+
+  for (i = 0; i < list->size; i++)
+  cloog_loop_box_clear(&list->box[i]) ;
+  free(list->box) ;
+}
+
+
+/**
+ * cloog_loop_add_disjoint_boxed function:
+ * This function calls cloog_loop_add_disjoint and appends to (list) a copy of
+ * (box) for each of the loops this added to the list (start). Nothing is
+ * recorded when (list) is NULL.
+ */
+static void cloog_loop_add_disjoint_boxed(CloogLoop **start, CloogLoop **now,
+        CloogLoop *loop, struct cloog_loop_box_list *list,
+        struct cloog_loop_box *box)
+{ CloogLoop *last, *l ;
+
+  last = (*start == NULL) ? NULL : *now ;
+  cloog_loop_add_disjoint(start, now, loop) ;
+  if (list == NULL)
+  return ;
+  for (l = (last == NULL) ? *start : last->next; l; l = l->next)
+  cloog_loop_box_list_add(list, box) ;
+}
+
+
+/**
+ * Pieces of the separation of (loop) against the loops of some list (res),
+ * computed in advance by cloog_loop_separation_pieces. For the k-th loop Q of
+ * (res), inter[k] is (Q inter loop) and diff[k] is (Q - loop) if
+ * inter_empty[k] and diff_empty[k] are 0. They are 1 if the set is empty
+ * and -1 if cloog_loop_separate has to compute it itself.
+ */
+struct cloog_loop_pieces {
+  int size ;
+  CloogDomain **inter, **diff ;
+  int *inter_empty, *diff_empty ;
+} ;
+
+
+/**
+ * cloog_loop_separation_pieces function:
+ * This function computes, using (nb_threads) threads, (Q inter loop) and
+ * (Q - loop) for each Q in the list (res) that is neither trivially disjoint
+ * from nor equal to (loop), and stores them in (pieces), see
+ * cloog_domain_separation_pieces. If (boxes) is not NULL, it gives the boxes
+ * of the loops in (res) and (box) the one of (loop).
+ */
+static void cloog_loop_separation_pieces(CloogLoop *res, CloogLoop *loop,
+	int nb_threads, struct cloog_loop_box_list *boxes,
+	struct cloog_loop_box *box, struct cloog_loop_pieces *pieces)
+{ int k, n, nb_loops ;
+  int *pos, *inter_empty, *diff_empty ;
+  CloogDomain **doms, **inter, **diff ;
+  CloogLoop *Q ;
+
+  nb_loops = cloog_loop_count(res) ;
+  if (nb_loops > pieces->size)
+  { pieces->size = nb_loops ;
+    pieces->inter = (CloogDomain **)realloc(pieces->inter,
+                                      nb_loops*sizeof(CloogDomain *)) ;
+    pieces->diff = (CloogDomain **)realloc(pieces->diff,
+                                      nb_loops*sizeof(CloogDomain *)) ;
+    pieces->inter_empty = (int *)realloc(pieces->inter_empty,
+                                      nb_loops*sizeof(int)) ;
+    pieces->diff_empty = (int *)realloc(pieces->diff_empty,
+                                      nb_loops*sizeof(int)) ;
+    if (!pieces->inter || !pieces->diff ||
+        !pieces->inter_empty || !pieces->diff_empty)
+      cloog_die("memory overflow.\n");
+  }
+  doms  = (CloogDomain **)malloc(nb_loops*sizeof(CloogDomain *)) ;
+  inter = (CloogDomain **)malloc(nb_loops*sizeof(CloogDomain *)) ;
+  diff  = (CloogDomain **)malloc(nb_loops*sizeof(CloogDomain *)) ;
+  pos   = (int *)malloc(nb_loops*sizeof(int)) ;
+  inter_empty = (int *)malloc(nb_loops*sizeof(int)) ;
+  diff_empty  = (int *)malloc(nb_loops*sizeof(int)) ;
+  if (!doms || !inter || !diff || !pos || !inter_empty || !diff_empty)
+    cloog_die("memory overflow.\n");
+
+  n = 0 ;
+  for (Q = res, k = 0; Q; Q = Q->next, k++)
+  { pieces->inter[k] = NULL ;
+    pieces->diff[k] = NULL ;
+    pieces->inter_empty[k] = -1 ;
+    pieces->diff_empty[k] = -1 ;
+    if ((boxes && cloog_loop_box_disjoint(&boxes->box[k], box)) ||
+        cloog_domain_lazy_disjoint(Q->domain,loop->domain) ||
+        cloog_domain_lazy_equal(Q->domain,loop->domain))
+    continue ;
+    doms[n] = Q->domain ;
+    pos[n++] = k ;
+  }
+
+  cloog_domain_separation_pieces(loop->state, nb_threads, loop->domain,
+                                 n, doms, inter, inter_empty,
+                                 diff, diff_empty) ;
+  for (k = 0; k < n; k++)
+  { pieces->inter[pos[k]] = inter[k] ;
+    pieces->inter_empty[pos[k]] = inter_empty[k] ;
+    pieces->diff[pos[k]] = diff[k] ;
+    pieces->diff_empty[pos[k]] = diff_empty[k] ;
+  }
+
+  free(diff_empty) ;
+  free(inter_empty) ;
+  free(pos) ;
+  free(diff) ;
+  free(inter) ;
+  free(doms) ;
+}
+
+
 /**
  * cloog_loop_separate function:
  * This function implements the Quillere algorithm for separation of multiple
  * loops: for a given set of polyhedra (loop), it computes a set of disjoint
  * polyhedra such that the unions of these sets are equal, and returns this set.
+ * (level) is the level being separated, it is only used to skip the pairs of
+ * polyhedra whose values at that level cannot overlap (see cloog_loop_box).
  * - October   28th 2001: first version. 
  * - November  14th 2001: elimination of some unused blocks.
  * - August    13th 2002: (debug) in the case of union of polyhedra for one
@@ -920,12 +1166,23 @@ CloogLoop *cloog_loop_propagate_lower_bound(CloogLoop *loop, int level)
  *                        there is only one loop in the list (seems to work
  *                        without now, DomainSimplify may have been improved).
  *                        The problem was visible with test/iftest2.cloog.
+ * - October   17th 2026: the pieces may be computed in parallel
+ *                        (options->nb_threads), see
+ *                        cloog_loop_separation_pieces.
+ * - October   17th 2026: bounding boxes at the current level.
  */ 
-CloogLoop * cloog_loop_separate(CloogLoop * loop)
-{ int lazy_equal=0, disjoint = 0;
+CloogLoop *cloog_loop_separate(CloogLoop *loop, int level,
+                               CloogOptions *options)
+{ int lazy_equal=0, disjoint = 0, nonempty, bounded = 0, k ;
+  struct cloog_loop_pieces pieces = { 0, NULL, NULL, NULL, NULL } ;
+  struct cloog_loop_pieces *done = NULL ;
   CloogLoop * new_loop, * new_inner, * res, * now, * temp, * Q, 
             * inner, * old /*, * previous, * next*/  ;
   CloogDomain *UQ, *domain;
+  struct cloog_loop_box_list lists[3] = { { 0, 0, NULL }, { 0, 0, NULL },
+                                          { 0, 0, NULL } } ;
+  struct cloog_loop_box_list *res_boxes = NULL, *temp_boxes = NULL, *swap ;
+  struct cloog_loop_box *box = NULL, inter_box ;
   
   if (loop == NULL)
   return NULL ;
@@ -935,6 +1192,26 @@ CloogLoop * cloog_loop_separate(CloogLoop * loop)
   if (loop->next == NULL)
   return cloog_loop_disjoint(loop) ;
      
+  /* The box of each loop is computed once, in lists[2].  The boxes are only
+   * propagated if one of them has a constant bound.
+   */
+  cloog_loop_box_init(&inter_box) ;
+  if (level > 0)
+  { for (Q = loop; Q; Q = Q->next)
+    { box = cloog_loop_box_list_next(&lists[2]) ;
+      cloog_domain_level_bounds(Q->domain, level,
+                                &box->lower, &box->has_lower,
+                                &box->upper, &box->has_upper) ;
+      bounded |= box->has_lower || box->has_upper ;
+    }
+    box = bounded ? &lists[2].box[0] : NULL ;
+  }
+  if (bounded)
+  { res_boxes = &lists[0] ;
+    temp_boxes = &lists[1] ;
+    cloog_loop_box_list_add(res_boxes, box) ;
+  }
+
   UQ     = cloog_domain_copy(loop->domain) ;
   domain = cloog_domain_copy(loop->domain) ;
   res    = cloog_loop_alloc(loop->state, domain, 0, NULL,
@@ -944,25 +1221,54 @@ CloogLoop * cloog_loop_separate(CloogLoop * loop)
   while((loop = loop->next) != NULL)
   { temp = NULL ;
     
+    if (res_boxes)
+    { box++ ;
+      cloog_loop_box_list_clear(temp_boxes) ;
+    }
+
+    /* The pieces for all Q may be computed in advance, in parallel. */
+    if (options->nb_threads > 1)
+    { done = &pieces ;
+      cloog_loop_separation_pieces(res, loop, options->nb_threads,
+                                   res_boxes, box, done) ;
+    }
+
     /* For all Q, add Q-loop associated with the blocks of Q alone,
      * and Q inter loop associated with the blocks of Q and loop.
      */
-    for (Q = res; Q; Q = Q->next) {
+    for (Q = res, k = 0; Q; Q = Q->next, k++) {
         /* Add (Q inter loop). */
-        if ((disjoint = cloog_domain_lazy_disjoint(Q->domain,loop->domain)))
+        if (res_boxes && cloog_loop_box_disjoint(&res_boxes->box[k], box))
+	{ disjoint = 1 ;
+	  domain = NULL ;
+	}
+	else if ((disjoint = cloog_domain_lazy_disjoint(Q->domain,loop->domain)))
 	domain = NULL ;
+	else if (done && (done->inter_empty[k] == 1))
+	{ disjoint = 1 ;
+	  domain = NULL ;
+	}
 	else
-	{ if ((lazy_equal = cloog_domain_lazy_equal(Q->domain,loop->domain)))
+	{ nonempty = 0 ;
+	  if ((lazy_equal = cloog_domain_lazy_equal(Q->domain,loop->domain)))
 	  domain = cloog_domain_copy(Q->domain) ;
+	  else if (done && (done->inter_empty[k] == 0))
+	  { domain = done->inter[k] ;
+	    done->inter[k] = NULL ;
+	    nonempty = 1 ;
+	  }
           else
 	  domain = cloog_domain_intersection(Q->domain,loop->domain) ;
           
-	  if (!cloog_domain_isempty(domain))
+	  if (nonempty || !cloog_domain_isempty(domain))
           { new_inner = cloog_loop_concat(cloog_loop_copy(Q->inner),
                                           cloog_loop_copy(loop->inner)) ;
 	    new_loop = cloog_loop_alloc(loop->state, domain, 0, NULL,
 					NULL, new_inner, NULL);
-            cloog_loop_add_disjoint(&temp,&now,new_loop) ;
+	    if (res_boxes)
+	      cloog_loop_box_intersect(&inter_box, &res_boxes->box[k], box) ;
+            cloog_loop_add_disjoint_boxed(&temp, &now, new_loop,
+                                          temp_boxes, &inter_box) ;
           }
           else {
 	    disjoint = 1;
@@ -971,19 +1277,30 @@ CloogLoop * cloog_loop_separate(CloogLoop * loop)
         }
         
 	/* Add (Q - loop). */
+	nonempty = 0 ;
         if (disjoint)
 	domain = cloog_domain_copy(Q->domain) ;
 	else
-	{ if (lazy_equal)
+	{ if (lazy_equal || (done && (done->diff_empty[k] == 1)))
 	  domain = cloog_domain_empty(Q->domain);
+	  else if (done && (done->diff_empty[k] == 0))
+	  { domain = done->diff[k] ;
+	    done->diff[k] = NULL ;
+	    nonempty = 1 ;
+	  }
 	  else
 	  domain = cloog_domain_difference(Q->domain,loop->domain) ;
 	}
+	if (done)
+	{ cloog_domain_free(done->inter[k]) ;
+	  cloog_domain_free(done->diff[k]) ;
+	}
 	
-	if (!cloog_domain_isempty(domain)) {
+	if (nonempty || !cloog_domain_isempty(domain)) {
           new_loop = cloog_loop_alloc(loop->state, domain, 0, NULL,
 				      NULL, Q->inner, NULL);
-          cloog_loop_add_disjoint(&temp,&now,new_loop) ;
+          cloog_loop_add_disjoint_boxed(&temp, &now, new_loop, temp_boxes,
+                                 res_boxes ? &res_boxes->box[k] : NULL) ;
         }
         else
         { cloog_domain_free(domain) ;
@@ -1007,7 +1324,7 @@ CloogLoop * cloog_loop_separate(CloogLoop * loop)
     if (!cloog_domain_isempty(domain)) {
       new_loop = cloog_loop_alloc(loop->state, domain, 0, NULL,
 				  NULL, loop->inner, NULL);
-      cloog_loop_add_disjoint(&temp,&now,new_loop) ;
+      cloog_loop_add_disjoint_boxed(&temp, &now, new_loop, temp_boxes, box) ;
     }
     else
     { cloog_domain_free(domain) ;
@@ -1025,8 +1342,18 @@ CloogLoop * cloog_loop_separate(CloogLoop * loop)
     cloog_loop_free_parts(res,1,0,0,1) ;
 
     res = temp ;
+    swap = res_boxes ;
+    res_boxes = temp_boxes ;
+    temp_boxes = swap ;
   }  
   cloog_loop_free_parts(old,1,0,0,1) ;
+  free(pieces.inter) ;
+  free(pieces.diff) ;
+  free(pieces.inter_empty) ;
+  free(pieces.diff_empty) ;
+  for (k = 0; k < 3; k++)
+  cloog_loop_box_list_free(&lists[k]) ;
+  cloog_loop_box_clear(&inter_box) ;
 
   return(res) ;
 }
@@ -1052,7 +1379,7 @@ static CloogDomain *bounding_domain(CloogDomain *dom, CloogOptions *options)
  */ 
 CloogLoop *cloog_loop_merge(CloogLoop *loop, int level, CloogOptions *options)
 {
-    CloogLoop *res, *new_inner, *old;
+    CloogLoop *res, *new_inner, *old, **tail;
     CloogDomain *new_domain, *temp;
 
     if (loop == NULL)
@@ -1065,11 +1392,12 @@ CloogLoop *cloog_loop_merge(CloogLoop *loop, int level, CloogOptions *options)
     temp = loop->domain;
     loop->domain = NULL;
     new_inner = loop->inner;
+    tail = cloog_loop_append(&new_inner, new_inner);
 
     for (loop = loop->next; loop; loop = loop->next) {
 	temp = cloog_domain_union(temp, loop->domain);
 	loop->domain = NULL;
-	new_inner = cloog_loop_concat(new_inner, loop->inner);
+	tail = cloog_loop_append(tail, loop->inner);
     }
 
     new_domain = bounding_domain(temp, options);
@@ -1136,13 +1464,14 @@ static int cloog_loop_count(CloogLoop *loop)
 
 
 /**
- * cloog_loop_sort function:
+ * loop_sort function:
  * Adaptation from LoopGen 0.4 by F. Quillere. This function sorts a list of
  * parameterized disjoint polyhedra, in order to not have lexicographic order
- * violation (see Quillere paper).
+ * violation (see Quillere paper). If (options) asks for several threads, the
+ * comparisons of the domains are made in parallel.
  * - September 16th 2005: inclusion of cloog_loop_number (October 29th 2001).
  */ 
-CloogLoop *cloog_loop_sort(CloogLoop *loop, int level)
+static CloogLoop *loop_sort(CloogLoop *loop, int level, CloogOptions *options)
 {
   CloogLoop *res, *now, **loop_array;
   CloogDomain **doms;
@@ -1175,7 +1504,11 @@ CloogLoop *cloog_loop_sort(CloogLoop *loop, int level)
   }
   
   /* cloog_domain_sort will fill up permut. */
-  cloog_domain_sort(doms, nb_loops, level, permut);
+  if (options && (options->nb_threads > 1))
+    cloog_domain_sort_parallel(options->state, options->nb_threads,
+                               doms, nb_loops, level, permut);
+  else
+    cloog_domain_sort(doms, nb_loops, level, permut);
   
   /* With permut and loop_array we build the sorted list. */
   res = NULL ;
@@ -1192,6 +1525,202 @@ CloogLoop *cloog_loop_sort(CloogLoop *loop, int level)
   return res;
 }
 
+/**
+ * loop_split_minmax function:
+ * This function splits the range of the loop (loop) at (level) into pieces
+ * in which the loops at level+1 it encloses have a single lower and a single
+ * upper bound, such that they do not need a minimum or a maximum. The
+ * bounds are read from the convex hull of the projections of the inner
+ * domains onto the first level+1 dimensions and the pieces are ordered as
+ * separated loops are. The loop is returned unchanged if it would be split
+ * into more than options->split_minmax pieces.
+ */
+static CloogLoop *loop_split_minmax(CloogLoop *loop, int level,
+				    CloogOptions *options)
+{
+  CloogLoop *inner, *res = NULL;
+  CloogDomain *hull = NULL, *bound, *splitter, *first, *rest, *piece;
+
+  for (inner = loop->inner; inner; inner = inner->next)
+  { if (cloog_domain_dimension(inner->domain) <= level)
+      continue ;
+    bound = cloog_domain_project(inner->domain, level + 1) ;
+    hull = hull ? cloog_domain_union(hull, bound) : bound ;
+  }
+  if (!hull)
+    return loop ;
+
+  bound = cloog_domain_convex(hull) ;
+  cloog_domain_free(hull) ;
+  splitter = cloog_domain_minmax_splitter(bound, level + 1,
+					  options->split_minmax) ;
+  cloog_domain_free(bound) ;
+  if (!splitter)
+    return loop ;
+
+  for (;;)
+  { if (cloog_domain_isconvex(splitter))
+    { first = splitter ;
+      splitter = NULL ;
+    }
+    else
+    { first = cloog_domain_cut_first(splitter, &rest) ;
+      splitter = rest ;
+    }
+
+    piece = cloog_domain_intersection(first, loop->domain) ;
+    cloog_domain_free(first) ;
+    if (cloog_domain_isempty(piece))
+      cloog_domain_free(piece) ;
+    else
+      res = cloog_loop_alloc(loop->state, piece, loop->otl, NULL,
+			     cloog_block_copy(loop->block),
+			     cloog_loop_copy(loop->inner), res) ;
+
+    if (!splitter)
+      break ;
+  }
+
+  if (!res)
+    return loop ;
+
+  cloog_loop_free(loop) ;
+  return loop_sort(res, level, options) ;
+}
+
+
+/**
+ * cloog_loop_split_minmax function:
+ * This function applies loop_split_minmax to each loop of the list (loop)
+ * and returns the resulting list.
+ */
+static CloogLoop *cloog_loop_split_minmax(CloogLoop *loop, int level,
+					  CloogOptions *options)
+{
+  CloogLoop *res = NULL, **next_res = &res, *now, *next ;
+
+  for (now = loop; now; now = next)
+  { next = now->next ;
+    now->next = NULL ;
+    *next_res = loop_split_minmax(now, level, options) ;
+    while (*next_res)
+      next_res = &(*next_res)->next ;
+  }
+
+  return res ;
+}
+
+/**
+ * loop_separate_full_tiles function:
+ * This function splits the range of the loop (loop) at (level) into the
+ * values for which the loops it encloses scan some full tiles and the others.
+ * The tiles are defined by the values of the first (depth) iterators, see
+ * cloog_domain_full_tiles, with level <= depth. A value of these iterators
+ * is in the full-tile region when every inner domain that has points for it
+ * has a full tile for it (the domains that are not deeper than (depth) are
+ * not tiled and do not matter), and a value at (level) is in the region when it
+ * can be extended to a value of the region. Both parts get a copy of the
+ * inner loops, they are split into disjoint convex loops by
+ * cloog_loop_disjoint, as in cloog_loop_separate, and ordered as separated
+ * loops are. The loop is returned unchanged if it has no full tile or only
+ * full tiles.
+ */
+static CloogLoop *loop_separate_full_tiles(CloogLoop *loop, int level,
+					   int depth, CloogOptions *options)
+{
+  CloogLoop *inner, *res ;
+  CloogDomain *all = NULL, *full = NULL, *tiles, *proj, *temp, *partial ;
+
+  for (inner = loop->inner; inner; inner = inner->next)
+  { if (cloog_domain_dimension(inner->domain) <= depth)
+      continue ;
+    proj = cloog_domain_project(inner->domain, depth) ;
+    all = all ? cloog_domain_union(all, proj) : proj ;
+  }
+  if (!all)
+    return loop ;
+
+  for (inner = loop->inner; inner; inner = inner->next)
+  { if (cloog_domain_dimension(inner->domain) <= depth)
+      continue ;
+    /* The full tiles of this domain, and the values it has no point for. */
+    tiles = cloog_domain_full_tiles(inner->domain, depth + 1) ;
+    proj = cloog_domain_project(inner->domain, depth) ;
+    tiles = cloog_domain_union(tiles, cloog_domain_difference(all, proj)) ;
+    cloog_domain_free(proj) ;
+    if (full)
+    { temp = cloog_domain_intersection(full, tiles) ;
+      cloog_domain_free(full) ;
+      cloog_domain_free(tiles) ;
+      full = temp ;
+    }
+    else
+      full = tiles ;
+  }
+  cloog_domain_free(all) ;
+
+  proj = cloog_domain_project(full, level) ;
+  cloog_domain_free(full) ;
+  tiles = cloog_domain_intersection(proj, loop->domain) ;
+  cloog_domain_free(proj) ;
+  partial = cloog_domain_difference(loop->domain, tiles) ;
+  if (cloog_domain_isempty(tiles) || cloog_domain_isempty(partial))
+  { cloog_domain_free(tiles) ;
+    cloog_domain_free(partial) ;
+    return loop ;
+  }
+
+  res = cloog_loop_alloc(loop->state, partial, loop->otl, NULL,
+			 cloog_block_copy(loop->block),
+			 cloog_loop_copy(loop->inner), NULL) ;
+  res = cloog_loop_alloc(loop->state, tiles, loop->otl, NULL,
+			 cloog_block_copy(loop->block),
+			 cloog_loop_copy(loop->inner), res) ;
+  cloog_loop_free(loop) ;
+
+  return loop_sort(cloog_loop_disjoint(res), level, options) ;
+}
+
+
+/**
+ * cloog_loop_separate_full_tiles function:
+ * This function applies loop_separate_full_tiles to each loop of the list
+ * (loop) at (level) and returns the resulting list. The tiles are defined
+ * by the iterators up to the loop depth options->full_tiles, counted as
+ * the -f and -l depths are, i.e., with the scalar dimensions (scaldims).
+ */
+static CloogLoop *cloog_loop_separate_full_tiles(CloogLoop *loop, int level,
+	int scalar, int *scaldims, int nb_scattdims, CloogOptions *options)
+{
+  int d, depth = level ;
+  CloogLoop *res = NULL, **next_res = &res, *now, *next ;
+
+  /* Number of non-scalar dimensions up to options->full_tiles. */
+  for (d = level + scalar + 1; d <= options->full_tiles; d++)
+    if ((d > nb_scattdims) || !scaldims[d - 1])
+      depth++ ;
+
+  for (now = loop; now; now = next)
+  { next = now->next ;
+    now->next = NULL ;
+    *next_res = loop_separate_full_tiles(now, level, depth, options) ;
+    while (*next_res)
+      next_res = &(*next_res)->next ;
+  }
+
+  return res ;
+}
+
+
+/**
+ * cloog_loop_sort function:
+ * Sorts the list of loops (loop) at (level) sequentially, see loop_sort.
+ */
+CloogLoop *cloog_loop_sort(CloogLoop *loop, int level)
+{
+  return loop_sort(loop, level, NULL);
+}
+
 
 /**
  * cloog_loop_nest function:
@@ -1398,12 +1927,11 @@ void cloog_loop_otl(CloogLoop *loop, int level)
  * - January 11th 2005: first version.
  */
 CloogLoop * cloog_loop_stop(CloogLoop * loop, CloogDomain * context)
-{ if (loop == NULL)
-  return NULL ;
-  else
-  { cloog_domain_free(loop->domain) ;
-    loop->domain = cloog_domain_copy(context) ;
-    loop->next = cloog_loop_stop(loop->next, context) ;
+{ CloogLoop * temp ;
+
+  for (temp = loop; temp != NULL; temp = temp->next)
+  { cloog_domain_free(temp->domain) ;
+    temp->domain = cloog_domain_copy(context) ;
   }
   
   return loop ;
@@ -1558,7 +2086,6 @@ CloogLoop *cloog_loop_generate_backtrack(CloogLoop *loop,
   CloogLoop * now, * now2, * next, * next2, * end, * temp, * l, * inner,
             * new_loop ;
   
-  (void) options;
   temp = loop ;
   loop = NULL ;
 
@@ -1587,8 +2114,12 @@ CloogLoop *cloog_loop_generate_backtrack(CloogLoop *loop,
     temp->inner = NULL ;
       
     if (l != NULL)
-    { l = cloog_loop_separate(l) ;
-      l = cloog_loop_sort(l, level);
+    { cloog_state_phase_start(options->state, CLOOG_PHASE_SEPARATE);
+      l = cloog_loop_separate(l, level, options) ;
+      cloog_state_phase_end(options->state, CLOOG_PHASE_SEPARATE);
+      cloog_state_phase_start(options->state, CLOOG_PHASE_SORT);
+      l = loop_sort(l, level, options);
+      cloog_state_phase_end(options->state, CLOOG_PHASE_SORT);
       while (l != NULL) {
 	l->stride = cloog_stride_copy(l->stride);
         cloog_loop_add(&loop,&now,l) ;
@@ -1654,7 +2185,7 @@ int cloog_loop_is_constant(CloogLoop *loop, int level)
  */
 CloogLoop *cloog_loop_constant(CloogLoop *loop, int level)
 {
-    CloogLoop *res, *inner, *tmp;
+    CloogLoop *res, *inner, *tmp, **tail;
     CloogDomain *domain, *t;
     (void) level;
 
@@ -1662,9 +2193,10 @@ CloogLoop *cloog_loop_constant(CloogLoop *loop, int level)
 	return loop;
 
     inner = loop->inner;
+    tail = cloog_loop_append(&inner, inner);
     domain = loop->domain;
     for (tmp = loop->next; tmp; tmp = tmp->next) {
-	inner = cloog_loop_concat(inner, tmp->inner);
+	tail = cloog_loop_append(tail, tmp->inner);
 	domain = cloog_domain_union(domain, tmp->domain);
     }
 
@@ -1778,7 +2310,7 @@ static CloogLoop *loop_recurse(CloogLoop *loop,
     CloogLoop *inner, *into, *end, *next, *l, *now;
     CloogDomain *domain;
 
-    if (level && options->strides && !constant)
+    if (level && (options->strides || options->fold_guards) && !constant)
       cloog_loop_stride(loop, level);
 
     if (!constant &&
@@ -1836,6 +2368,15 @@ static CloogLoop *loop_recurse(CloogLoop *loop,
  * - nb_scattdims is the size of the scaldims array,
  * - constant is true if the loop is known to be executed at most once
  * - options are the general code generation options.
+ *
+ * The loops of the list are handled independently and their results are
+ * concatenated in order.  They are nevertheless not handled concurrently:
+ * all their domains live in the single isl_ctx of options->state, which
+ * may not be used from several threads, and the allocation counters of
+ * the state are updated without synchronization.  Running the siblings in
+ * the worker contexts of cloog_domain_separation_pieces would require
+ * moving every loop, with its blocks and statements, and not only
+ * a set, back to the main context.
  */
 CloogLoop *cloog_loop_recurse(CloogLoop *loop,
 	int level, int scalar, int *scaldims, int nb_scattdims,
@@ -1865,21 +2406,19 @@ CloogLoop *cloog_loop_recurse(CloogLoop *loop,
 void cloog_statement_get_fl(CloogStatement *s, int *f, int *l,
         CloogOptions *options)
 {
-    if (s == NULL) return;
-
     int fs, ls;
 
-    if (options->fs != NULL && options->ls != NULL) {
-        fs = options->fs[s->number-1];
-        ls = options->ls[s->number-1];
-        *f = (fs > *f)? fs: *f;
-        *l = (ls > *l)? ls: *l;
-    }else{
-        *f = -1;
-        *l = -1;
+    for (; s != NULL; s = s->next) {
+        if (options->fs != NULL && options->ls != NULL) {
+            fs = options->fs[s->number-1];
+            ls = options->ls[s->number-1];
+            *f = (fs > *f)? fs: *f;
+            *l = (ls > *l)? ls: *l;
+        }else{
+            *f = -1;
+            *l = -1;
+        }
     }
-
-    cloog_statement_get_fl(s->next, f, l, options);
 }
 
 /* Get the max across all 'first' depths for statements under
@@ -1887,18 +2426,54 @@ void cloog_statement_get_fl(CloogStatement *s, int *f, int *l,
 void cloog_loop_get_fl(CloogLoop *loop, int *f, int *l,
         CloogOptions *options)
 {
-    if (loop == NULL)   return;
+    for (; loop != NULL; loop = loop->next) {
+        CloogBlock *block = loop->block;
 
-    CloogBlock *block = loop->block;
+        if (block != NULL && block->statement != NULL) {
+            cloog_statement_get_fl(block->statement, f, l, options);
+        }
 
-    if (block != NULL && block->statement != NULL) {
-        cloog_statement_get_fl(block->statement, f, l, options);
+        cloog_loop_get_fl(loop->inner, f, l, options);
     }
+}
+
+/**
+ * cloog_loop_deadline_passed function:
+ * This function returns 1 if the time budget of options->deadline
+ * milliseconds, counted from options->deadline_start, is exhausted, and
+ * records the depth (depth) in the sorted options->degraded array in that
+ * case. It returns 0 if there is time left or no budget at all.
+ */
+static int cloog_loop_deadline_passed(CloogOptions *options, int depth)
+{
+  int i, j ;
+
+  if (options->deadline < 0)
+  return 0 ;
 
-    cloog_loop_get_fl(loop->inner, f, l, options);
-    cloog_loop_get_fl(loop->next, f, l, options);
+  if ((cloog_util_rtclock() - options->deadline_start) * 1000 <
+      options->deadline)
+  return 0 ;
+
+  for (i = 0; i < options->nb_degraded; i++)
+  if (options->degraded[i] >= depth)
+  break ;
+  if ((i < options->nb_degraded) && (options->degraded[i] == depth))
+  return 1 ;
+
+  options->degraded = (int *)realloc(options->degraded,
+                                 (options->nb_degraded + 1) * sizeof(int)) ;
+  if (!options->degraded)
+    cloog_die("memory overflow.\n");
+  for (j = options->nb_degraded; j > i; j--)
+  options->degraded[j] = options->degraded[j-1] ;
+  options->degraded[i] = depth ;
+  options->nb_degraded++ ;
+
+  return 1 ;
 }
 
+
 /**
  * cloog_loop_generate_general function:
  * Adaptation from LoopGen 0.4 by F. Quillere. This function implements the
@@ -1939,6 +2514,11 @@ CloogLoop *cloog_loop_generate_general(CloogLoop *loop,
 
     now = NULL;
 
+    if (options->state->trace)
+      cloog_state_trace_begin(options->state, "generate_general",
+			      "\"level\": %d, \"scalar\": %d, \"loops\": %d",
+			      level, scalar, cloog_loop_count(loop));
+
     /* Get the -f and -l for each statement */
     cloog_loop_get_fl(loop, &first, &last, options);
 
@@ -1948,24 +2528,57 @@ CloogLoop *cloog_loop_generate_general(CloogLoop *loop,
         last = options->l;
     }
 
+    /* Once the time budget is exhausted, merge instead of separating, as
+     * with a -f depth beyond the current one. As in cloog_program_generate,
+     * -l is then limited to the scattering dimension number to avoid
+     * iteration duplication.
+     */
+    if (level && (first > 0) && (first <= level+scalar) &&
+        cloog_loop_deadline_passed(options, level+scalar)) {
+        first = -1;
+        if ((last < 0) || (last > nb_scattdims))
+            last = nb_scattdims;
+    }
+
   /* 3. Separate all projections into disjoint polyhedra. */
   if (level > 0 && cloog_loop_is_constant(loop, level)) {
     res = cloog_loop_constant(loop, level);
     constant = 1;
     }else if ((first > level+scalar) || (first < 0)) {
+    cloog_state_phase_start(options->state, CLOOG_PHASE_MERGE);
     res = cloog_loop_merge(loop, level, options);
+    cloog_state_phase_end(options->state, CLOOG_PHASE_MERGE);
     }else{
-    res = cloog_loop_separate(loop);
+    cloog_state_phase_start(options->state, CLOOG_PHASE_SEPARATE);
+    res = cloog_loop_separate(loop, level, options);
+    cloog_state_phase_end(options->state, CLOOG_PHASE_SEPARATE);
     separate = 1;
   }
     
   /* 3b. -correction- sort the loops to determine their textual order. */
-  res = cloog_loop_sort(res, level);
+  cloog_state_phase_start(options->state, CLOOG_PHASE_SORT);
+  res = loop_sort(res, level, options);
+  cloog_state_phase_end(options->state, CLOOG_PHASE_SORT);
 
   res = cloog_loop_restrict_inner(res);
 
   if (separate)
     res = cloog_loop_specialize(res, level, scalar, scaldims, nb_scattdims);
+
+  /* 3c. split the loops whose inner loops would need a minimum or
+   *     a maximum in their bounds.
+   */
+  if (separate && level && options->split_minmax > 1 &&
+      ((level+scalar < last) || (last < 0)))
+    res = cloog_loop_split_minmax(res, level, options);
+
+  /* 3d. separate the full tiles from the partial ones up to the depth
+   *     chosen by the user.
+   */
+  if (level && !constant && level+scalar <= options->full_tiles &&
+      ((level+scalar < last) || (last < 0)))
+    res = cloog_loop_separate_full_tiles(res, level, scalar, scaldims,
+					 nb_scattdims, options);
   
   /* 4. Recurse for each loop with the current domain as context. */
   temp = res ;
@@ -2008,6 +2621,8 @@ CloogLoop *cloog_loop_generate_general(CloogLoop *loop,
    */
   /* res = cloog_loop_unisolate(res,level) ;*/
 
+  cloog_state_trace_end(options->state, "generate_general");
+
   return(res) ;
 }
 
@@ -2168,6 +2783,7 @@ static int cloog_loop_equal_prefix(CloogLoop *a, CloogLoop *b,
 CloogLoop *cloog_loop_block(CloogLoop *loop, int *scaldims, int nb_scattdims)
 {
     CloogLoop *begin, *end, *l;
+    CloogStatement **tail;
     int begin_after_previous;
     int end_after_previous;
 
@@ -2196,8 +2812,18 @@ CloogLoop *cloog_loop_block(CloogLoop *loop, int *scaldims, int nb_scattdims)
 	    end_after_previous = cloog_loop_next_scal_cmp(end) < 0;
 	}
 	if (end != begin->next && end_after_previous) {
+	    /* Append the statements at the end of the list directly, as
+	     * cloog_block_merge would walk the whole list for each loop.
+	     */
+	    for (tail = &begin->block->statement; *tail; tail = &(*tail)->next)
+		;
 	    for (l = begin->next; l != end; l = begin->next) {
-		cloog_block_merge(begin->block, l->block);
+		*tail = l->block->statement;
+		l->block->statement = NULL;
+		cloog_block_free(l->block);
+		l->block = NULL;
+		for (; *tail; tail = &(*tail)->next)
+		    ;
 		begin->next = l->next;
 		cloog_loop_free_parts(l, 1, 0, 1, 0);
 	    }
@@ -2352,17 +2978,111 @@ static int inner_loop_follows(CloogLoop *loop1, CloogLoop *loop2,
 }
 
 
+/* Structure for representing the edges of the graph traversed by Tarjan's
+ * algorithm.
+ * len is the number of nodes
+ * follows is the function deciding whether there is an edge
+ * box, if not NULL, contains for each node the constant bounds of the
+ * domain of its first inner loop at the current level
+ * state collects the statistics
+ */
+struct cloog_loop_graph {
+    int len;
+    int (*follows)(CloogLoop *loop1, CloogLoop *loop2,
+	int level, int scalar, int *scaldims, int nb_scattdims, int def);
+    struct cloog_loop_box *box;
+    CloogState *state;
+};
+
+static void cloog_loop_graph_init(struct cloog_loop_graph *g, int len,
+	int (*follows)(CloogLoop *loop1, CloogLoop *loop2,
+	    int level, int scalar, int *scaldims, int nb_scattdims, int def),
+	CloogState *state)
+{
+    g->len = len;
+    g->follows = follows;
+    g->box = NULL;
+    g->state = state;
+}
+
+/* Compute the constant bounds at "level" of the domain of the first inner
+ * loop of each loop of "loop_array".  They allow cloog_loop_graph_edge
+ * to drop the edges between loops whose iterations are all ordered at
+ * that level without calling isl.  The bounds are only computed once per
+ * loop, while Tarjan's algorithm may look at every pair of loops.
+ */
+static void cloog_loop_graph_prefilter(struct cloog_loop_graph *g,
+	CloogLoop **loop_array, int level)
+{
+    int i;
+
+    g->box = (struct cloog_loop_box *)
+			malloc(g->len * sizeof(struct cloog_loop_box));
+    assert(g->box);
+    for (i = 0; i < g->len; ++i) {
+	CloogDomain *domain = loop_array[i]->inner->domain;
+
+	cloog_loop_box_init(&g->box[i]);
+	if (level <= cloog_domain_dimension(domain))
+	    cloog_domain_level_bounds(domain, level,
+			&g->box[i].lower, &g->box[i].has_lower,
+			&g->box[i].upper, &g->box[i].has_upper);
+    }
+}
+
+static void cloog_loop_graph_clear(struct cloog_loop_graph *g)
+{
+    int i;
+
+    if (!g->box)
+	return;
+    for (i = 0; i < g->len; ++i)
+	cloog_loop_box_clear(&g->box[i]);
+    free(g->box);
+}
+
+/* Is there an edge from node i to node j, i.e., does loop_array[i]
+ * follow loop_array[j]?  If all the values of loop_array[i] at the
+ * current level are smaller than those of loop_array[j], then their
+ * domains differ and cloog_domain_follows would return -1, so there
+ * is no edge.
+ */
+static int cloog_loop_graph_edge(struct cloog_loop_graph *g,
+	CloogLoop **loop_array, int i, int j, int level, int scalar,
+	int *scaldims, int nb_scattdims)
+{
+    int f;
+    struct cloog_loop_box *b1, *b2;
+
+    if (g->box) {
+	b1 = &g->box[i];
+	b2 = &g->box[j];
+	if (b1->has_upper && b2->has_lower &&
+	    cloog_int_lt(b1->upper, b2->lower)) {
+	    g->state->components_avoided++;
+	    return 0;
+	}
+    }
+
+    f = g->follows(loop_array[i], loop_array[j],
+		   level, scalar, scaldims, nb_scattdims, i > j);
+    g->state->components_tests++;
+    if (f)
+	g->state->components_edges++;
+
+    return f;
+}
+
+
 /* Perform Tarjan's algorithm for computing the strongly connected components
  * in the graph with the individual CloogLoops as vertices.
  * Two CloopLoops appear in the same component if they both (indirectly)
- * "follow" each other, where the following relation is determined
- * by the follows function.
+ * "follow" each other, where the following relation is given
+ * by the graph g.
  */
 static void cloog_loop_components_tarjan(struct cloog_loop_sort *s,
 	CloogLoop **loop_array, int i, int level, int scalar, int *scaldims,
-	int nb_scattdims,
-	int (*follows)(CloogLoop *loop1, CloogLoop *loop2,
-	    int level, int scalar, int *scaldims, int nb_scattdims, int def))
+	int nb_scattdims, struct cloog_loop_graph *g)
 {
     int j;
 
@@ -2382,14 +3102,14 @@ static void cloog_loop_components_tarjan(struct cloog_loop_sort *s,
 		 s->node[j].index > s->node[i].min_index))
 	    continue;
 
-	f = follows(loop_array[i], loop_array[j],
-				level, scalar, scaldims, nb_scattdims, i > j);
+	f = cloog_loop_graph_edge(g, loop_array, i, j,
+				  level, scalar, scaldims, nb_scattdims);
 	if (!f)
 	    continue;
 
 	if (s->node[j].index < 0) {
 	    cloog_loop_components_tarjan(s, loop_array, j, level, scalar,
-					 scaldims, nb_scattdims, follows);
+					 scaldims, nb_scattdims, g);
 	    if (s->node[j].min_index < s->node[i].min_index)
 		s->node[i].min_index = s->node[j].min_index;
 	} else if (s->node[j].index < s->node[i].min_index)
@@ -2454,6 +3174,9 @@ static int extract_component(CloogLoop **loop_array, int *list, CloogLoop **res)
  *
  * We use Tarjan's algorithm to find the strongly connected components.
  * Note that this algorithm also topologically sorts the components.
+ * With more than two loops, the pairs of loops that are ordered by the
+ * constant bounds of their domains at the current level are not handed
+ * to isl, see cloog_loop_graph_edge.
  *
  * The components are treated separately to avoid spurious separations.
  * The concatentation of the results may contain successive loops
@@ -2468,6 +3191,7 @@ CloogLoop *cloog_loop_generate_components(CloogLoop *loop,
     CloogLoop *res, **res_next;
     CloogLoop **loop_array;
     struct cloog_loop_sort *s;
+    struct cloog_loop_graph g;
 
     if (level == 0 || !loop->next)
 	return cloog_loop_generate_general(loop, level, scalar,
@@ -2481,13 +3205,21 @@ CloogLoop *cloog_loop_generate_components(CloogLoop *loop,
     for (i = 0, tmp = loop; i < nb_loops; i++, tmp = tmp->next)
 	loop_array[i] = tmp;
 
+    cloog_state_phase_start(options->state, CLOOG_PHASE_COMPONENTS);
+    cloog_loop_graph_init(&g, nb_loops, &inner_loop_follows, options->state);
+    if (nb_loops > 2 &&
+	!level_is_constant(level, scalar, scaldims, nb_scattdims))
+	cloog_loop_graph_prefilter(&g, loop_array, level);
+
     s = cloog_loop_sort_alloc(nb_loops);
     for (i = nb_loops - 1; i >= 0; --i) {
 	if (s->node[i].index >= 0)
 	    continue;
 	cloog_loop_components_tarjan(s, loop_array, i, level, scalar, scaldims,
-					nb_scattdims, &inner_loop_follows);
+					nb_scattdims, &g);
     }
+    cloog_loop_graph_clear(&g);
+    cloog_state_phase_end(options->state, CLOOG_PHASE_COMPONENTS);
 
     i = 0;
     res = NULL;
@@ -2523,6 +3255,7 @@ CloogLoop *cloog_loop_decompose_inner(CloogLoop *loop,
     CloogLoop **loop_array;
     int i, n_loops, max_loops = 0;
     struct cloog_loop_sort *s;
+    struct cloog_loop_graph g;
 
     for (l = loop; l; l = l->next) {
 	n_loops = cloog_loop_count(l->inner);
@@ -2545,13 +3278,15 @@ CloogLoop *cloog_loop_decompose_inner(CloogLoop *loop,
 	if (n_loops <= 1)
 	    continue;
 
+	cloog_loop_graph_init(&g, n_loops, &cloog_loop_follows, l->state);
 	s = cloog_loop_sort_alloc(n_loops);
 	for (i = n_loops - 1; i >= 0; --i) {
 	    if (s->node[i].index >= 0)
 		continue;
 	    cloog_loop_components_tarjan(s, loop_array, i, level, scalar,
-				scaldims, nb_scattdims, &cloog_loop_follows);
+				scaldims, nb_scattdims, &g);
 	}
+	cloog_loop_graph_clear(&g);
 
 	n = extract_component(loop_array, s->order, &l->inner);
 	n_loops -= n;
@@ -2740,6 +3475,11 @@ CloogLoop *cloog_loop_simplify(CloogLoop *loop, CloogDomain *context, int level,
   CloogLoop **next = &res;
   int need_split = 0;
 
+  if (options->state->trace)
+    cloog_state_trace_begin(options->state, "loop_simplify",
+			    "\"level\": %d, \"loops\": %d",
+			    level, cloog_loop_count(loop));
+
   for (now = loop; now; now = now->next)
     if (!cloog_domain_isconvex(now->domain)) {
       now->domain = cloog_domain_simplify_union(now->domain);
@@ -2766,6 +3506,8 @@ CloogLoop *cloog_loop_simplify(CloogLoop *loop, CloogDomain *context, int level,
   }
   cloog_loop_free(loop);
 
+  cloog_state_trace_end(options->state, "loop_simplify");
+
   return res;
 }
 
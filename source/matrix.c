@@ -34,12 +34,43 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "../include/cloog/cloog.h"
 
+/**
+ * Number of elements between the starts of two consecutive rows of a matrix
+ * with NbColumns columns: the rows are padded up to a multiple of
+ * CLOOG_MATRIX_ALIGN bytes when the buffer itself can be aligned.
+ */
+static unsigned cloog_matrix_stride(unsigned NbColumns)
+{
+#ifdef CLOOG_MEMALIGN
+  if (CLOOG_MATRIX_ALIGN % sizeof(cloog_int_t) == 0) {
+    unsigned n = CLOOG_MATRIX_ALIGN / sizeof(cloog_int_t);
+    return (NbColumns + n - 1) / n * n;
+  }
+#endif
+  return NbColumns;
+}
+
+static cloog_int_t *cloog_matrix_buffer(size_t size)
+{
+#ifdef CLOOG_MEMALIGN
+  void *q;
+
+  if (posix_memalign(&q, CLOOG_MATRIX_ALIGN, size * sizeof(cloog_int_t)))
+    return NULL;
+  return (cloog_int_t *)q;
+#else
+  return (cloog_int_t *)malloc(size * sizeof(cloog_int_t));
+#endif
+}
+
 /**
  * cloog_matrix_alloc:
  * Allocate a CloogMatrix data structure with NbRows rows and NbColumns columns.
- * All values are initialized to 0.
+ * All values are initialized to 0, including the padding at the end
+ * of each row.
  * This method returns a pointer to the data structure if successful or a NULL
  * pointer otherwise.
  */
@@ -47,7 +78,7 @@ CloogMatrix *cloog_matrix_alloc(unsigned NbRows, unsigned NbColumns)
 {
   CloogMatrix *matrix;
   cloog_int_t **p, *q;
-  unsigned int i, j;
+  unsigned int i, size;
 
   matrix = (CloogMatrix *)malloc(sizeof(CloogMatrix));
 
@@ -56,6 +87,7 @@ CloogMatrix *cloog_matrix_alloc(unsigned NbRows, unsigned NbColumns)
 
   matrix->NbRows = NbRows;
   matrix->NbColumns = NbColumns;
+  matrix->Stride = cloog_matrix_stride(NbColumns);
 
   if (!NbRows || !NbColumns) {
     matrix->p = NULL;
@@ -70,7 +102,8 @@ CloogMatrix *cloog_matrix_alloc(unsigned NbRows, unsigned NbColumns)
     return NULL;
   }
 
-  q = (cloog_int_t *)malloc(NbRows * NbColumns * sizeof(cloog_int_t));
+  size = NbRows * matrix->Stride;
+  q = cloog_matrix_buffer(size);
 
   if (q == NULL) {
     free (matrix);
@@ -81,14 +114,10 @@ CloogMatrix *cloog_matrix_alloc(unsigned NbRows, unsigned NbColumns)
   matrix->p = p;
   matrix->p_Init = q;
 
-  for (i = 0; i < NbRows; i++) {
-    *p++ = q;
-    for (j = 0; j < NbColumns; j++) {
-      cloog_int_init(*(q+j));
-      cloog_int_set_si(*(q+j), 0);
-    }
-    q += NbColumns;
-  }
+  for (i = 0; i < size; i++)
+    cloog_int_init(q[i]);
+  for (i = 0; i < NbRows; i++)
+    p[i] = q + i * matrix->Stride;
 
   return matrix;
 }
@@ -99,20 +128,85 @@ CloogMatrix *cloog_matrix_alloc(unsigned NbRows, unsigned NbColumns)
  */
 void cloog_matrix_free(CloogMatrix * matrix)
 {
-  int i;
-  cloog_int_t *p;
-  int size = matrix->NbRows * matrix->NbColumns;
+  unsigned i;
+  unsigned size;
+
+  if (!matrix)
+    return;
 
-  p = matrix->p_Init;
+  size = matrix->NbRows * matrix->Stride;
 
   for (i = 0; i < size; i++)
-    cloog_int_clear(*p++);
+    cloog_int_clear(matrix->p_Init[i]);
 
-  if (matrix) {
-    free(matrix->p_Init);
-    free(matrix->p);
-    free(matrix);
-  }
+  free(matrix->p_Init);
+  free(matrix->p);
+  free(matrix);
+}
+
+
+/**
+ * Return a view of row i of M: its NbColumns elements start at the returned
+ * address and must not be freed separately.
+ */
+cloog_int_t *cloog_matrix_row(CloogMatrix *M, unsigned i)
+{
+  return M->p_Init + i * M->Stride;
+}
+
+
+/**
+ * Copy the first dst->NbColumns elements of row j of src to row i of dst.
+ * With machine integers, this is a plain memory copy.
+ */
+void cloog_matrix_row_cpy(CloogMatrix *dst, unsigned i,
+		CloogMatrix *src, unsigned j)
+{
+  cloog_int_t *d = cloog_matrix_row(dst, i);
+  cloog_int_t *s = cloog_matrix_row(src, j);
+
+  if (d == s)
+    return;
+#if defined(CLOOG_INT_GMP)
+  cloog_seq_cpy(d, s, dst->NbColumns);
+#else
+  memcpy(d, s, dst->NbColumns * sizeof(cloog_int_t));
+#endif
+}
+
+
+/**
+ * Exchange the contents of rows i and j of M.  The row pointers in M->p
+ * are left untouched, so that M->p[i] keeps pointing to row i.
+ */
+void cloog_matrix_row_swap(CloogMatrix *M, unsigned i, unsigned j)
+{
+  unsigned k;
+  cloog_int_t *a = cloog_matrix_row(M, i);
+  cloog_int_t *b = cloog_matrix_row(M, j);
+
+  if (a == b)
+    return;
+  for (k = 0; k < M->NbColumns; k++)
+    cloog_int_swap(a[k], b[k]);
+}
+
+
+/**
+ * Copy all elements of src to dst, which has the same dimensions.
+ * Both buffers have the same layout, so the copy runs over whole buffers.
+ */
+void cloog_matrix_cpy(CloogMatrix *dst, CloogMatrix *src)
+{
+  unsigned size = src->NbRows * src->Stride;
+
+  if (!size)
+    return;
+#if defined(CLOOG_INT_GMP)
+  cloog_seq_cpy(dst->p_Init, src->p_Init, size);
+#else
+  memcpy(dst->p_Init, src->p_Init, size * sizeof(cloog_int_t));
+#endif
 }
 
 
@@ -86,7 +86,7 @@ CloogConstraint *cloog_constraint_set_defining_equality(CloogConstraintSet *cons
 	for (i = 0; i < constraints->M.NbRows; i++)
 		if (cloog_int_is_zero(constraints->M.p[i][0]) &&
 		    !cloog_int_is_zero(constraints->M.p[i][level])) {
-			constraint->line = &constraints->M.p[i];
+			constraint->line = cloog_matrix_row(&constraints->M, i);
 			return constraint;
 		    }
 	free(constraint);
@@ -162,11 +162,11 @@ CloogConstraint *cloog_constraint_set_defining_inequalities(CloogConstraintSet *
 			(*lower)->set = constraints;
 			constraint->set = constraints;
 			if (cloog_int_is_pos(matrix->p[i][level])) {
-				(*lower)->line = &matrix->p[i];
-				constraint->line = &matrix->p[j];
+				(*lower)->line = cloog_matrix_row(matrix, i);
+				constraint->line = cloog_matrix_row(matrix, j);
 			} else {
-				(*lower)->line = &matrix->p[j];
-				constraint->line = &matrix->p[i];
+				(*lower)->line = cloog_matrix_row(matrix, j);
+				constraint->line = cloog_matrix_row(matrix, i);
 			}
 			return constraint;
 		}
@@ -273,7 +273,7 @@ static int cloog_constraint_equal_type(CloogConstraint *constraint, int level)
   int i, one=0 ;
   cloog_int_t *expr;
     
-  expr = *constraint->line;
+  expr = constraint->line;
   
   if (!cloog_int_is_one(expr[level]) && !cloog_int_is_neg_one(expr[level]))
     return EQTYPE_EXAFFINE;
@@ -322,6 +322,8 @@ int cloog_equal_type(CloogEqualities *equal, int level)
 static void cloog_equal_update(CloogEqualities *equal, int level, int nb_par)
 { int i, j ;
   cloog_int_t gcd, factor_level, factor_outer, temp_level, temp_outer;
+  CloogMatrix *M = &equal->constraints->M;
+  cloog_int_t *row = cloog_matrix_row(M, level-1), *outer;
   
   cloog_int_init(gcd);
   cloog_int_init(temp_level);
@@ -334,43 +336,37 @@ static void cloog_equal_update(CloogEqualities *equal, int level, int nb_par)
   { /* if the corresponding iterator is inside the current equality and is equal
      * to something,
      */
-    if (!cloog_int_is_zero(equal->constraints->M.p[level-1][i+1]) && equal->types[i])
-    { /* Compute the Greatest Common Divisor. */ 
-      cloog_int_gcd(gcd, equal->constraints->M.p[level-1][i+1],
-			 equal->constraints->M.p[i][i+1]);
+    if (!cloog_int_is_zero(row[i+1]) && equal->types[i])
+    { outer = cloog_matrix_row(M, i);
+
+      /* Compute the Greatest Common Divisor. */ 
+      cloog_int_gcd(gcd, row[i+1], outer[i+1]);
       
       /* Compute the factors to apply to each row vector element. */
-      cloog_int_divexact(factor_level, equal->constraints->M.p[i][i+1], gcd);
-      cloog_int_divexact(factor_outer, equal->constraints->M.p[level-1][i+1], gcd);
+      cloog_int_divexact(factor_level, outer[i+1], gcd);
+      cloog_int_divexact(factor_outer, row[i+1], gcd);
             
       /* Now update the row 'level'. */
       /* - the iterators, up to level, */
       for (j = 1; j <= level; j++) {
-        cloog_int_mul(temp_level, factor_level,
-			equal->constraints->M.p[level-1][j]);
-        cloog_int_mul(temp_outer, factor_outer, equal->constraints->M.p[i][j]);
-        cloog_int_sub(equal->constraints->M.p[level-1][j], temp_level, temp_outer);
+        cloog_int_mul(temp_level, factor_level, row[j]);
+        cloog_int_mul(temp_outer, factor_outer, outer[j]);
+        cloog_int_sub(row[j], temp_level, temp_outer);
       }
       /* - between last useful iterator (level) and the first parameter, the
        *   matrix is sparse (full of zeroes), we just do nothing there. 
        * - the parameters and the scalar.
        */
-      for (j = 0; j < nb_par + 1; j++) {
-        cloog_int_mul(temp_level,factor_level,
-                       equal->constraints->M.p[level-1]
-					[equal->constraints->M.NbColumns-j-1]);
-        cloog_int_mul(temp_outer,factor_outer,
-                       equal->constraints->M.p[i][equal->constraints->M.NbColumns-j-1]);
-        cloog_int_sub(equal->constraints->M.p[level-1]
-					 [equal->constraints->M.NbColumns-j-1],
-	               temp_level,temp_outer) ;
+      for (j = M->NbColumns-nb_par-1; j < M->NbColumns; j++) {
+        cloog_int_mul(temp_level, factor_level, row[j]);
+        cloog_int_mul(temp_outer, factor_outer, outer[j]);
+        cloog_int_sub(row[j], temp_level, temp_outer);
       }
     }
   }
   
   /* Normalize (divide by GCD of all elements) the updated equality. */
-  cloog_seq_normalize(&(equal->constraints->M.p[level-1][1]),
-			equal->constraints->M.NbColumns-1);
+  cloog_seq_normalize(row + 1, M->NbColumns - 1);
 
   cloog_int_clear(gcd);
   cloog_int_clear(temp_level);
@@ -396,7 +392,7 @@ static void cloog_equal_update(CloogEqualities *equal, int level, int nb_par)
 void cloog_equal_add(CloogEqualities *equal, CloogConstraintSet *constraints,
 			int level, CloogConstraint *line, int nb_par)
 { 
-  int j;
+  cloog_int_t *row;
   CloogConstraint *i = cloog_constraint_invalid();
   CloogMatrix *matrix = &constraints->M;
 
@@ -406,7 +402,7 @@ void cloog_equal_add(CloogEqualities *equal, CloogConstraintSet *constraints,
   if (!cloog_constraint_is_valid(line))
   { for (i = cloog_constraint_first(constraints);
 	 cloog_constraint_is_valid(i); i = cloog_constraint_next(i))
-    if ((!cloog_int_is_zero(i->line[0][0]))&& (!cloog_int_is_zero(i->line[0][level])))
+    if ((!cloog_int_is_zero(i->line[0]))&& (!cloog_int_is_zero(i->line[level])))
     { line = i ;
       
       /* Since in once-time-loops, equalities derive from inequalities, we
@@ -417,16 +413,16 @@ void cloog_equal_add(CloogEqualities *equal, CloogConstraintSet *constraints,
        * parameters) the once time loop would not have been detected
        * because of floord and ceild functions.
        */
-      if (cloog_int_ne_si(i->line[0][level],1) &&
-          cloog_int_ne_si(i->line[0][level],-1) &&
-	  !cloog_int_is_zero(i->line[0][matrix->NbColumns-1])) {
+      if (cloog_int_ne_si(i->line[level],1) &&
+          cloog_int_ne_si(i->line[level],-1) &&
+	  !cloog_int_is_zero(i->line[matrix->NbColumns-1])) {
 	cloog_int_t denominator;
         
 	cloog_int_init(denominator);
-	cloog_int_abs(denominator, i->line[0][level]);
-	cloog_int_fdiv_q(i->line[0][matrix->NbColumns-1],
-			 i->line[0][matrix->NbColumns-1], denominator);
-	cloog_int_set_si(i->line[0][level], cloog_int_sgn(i->line[0][level]));
+	cloog_int_abs(denominator, i->line[level]);
+	cloog_int_fdiv_q(i->line[matrix->NbColumns-1],
+			 i->line[matrix->NbColumns-1], denominator);
+	cloog_int_set_si(i->line[level], cloog_int_sgn(i->line[level]));
 	cloog_int_clear(denominator);
       }
             
@@ -442,11 +438,10 @@ void cloog_equal_add(CloogEqualities *equal, CloogConstraintSet *constraints,
   /* - the other elements corresponding to the equality itself
    *   (the iterators up to level, then the parameters and the scalar).
    */
-  for (j=1;j<=level;j++)
-      cloog_int_set(equal->constraints->M.p[level-1][j], line->line[0][j]);
-  for (j = 0; j < nb_par + 1; j++)
-      cloog_int_set(equal->constraints->M.p[level-1][equal->constraints->M.NbColumns-j-1],
-		   line->line[0][line->set->M.NbColumns-j-1]);
+  row = cloog_matrix_row(&equal->constraints->M, level-1);
+  cloog_seq_cpy(row + 1, line->line + 1, level);
+  cloog_seq_cpy(row + equal->constraints->M.NbColumns - nb_par - 1,
+		line->line + line->set->M.NbColumns - nb_par - 1, nb_par + 1);
   
   if (cloog_constraint_is_valid(i))
     cloog_constraint_release(line);
@@ -494,6 +489,7 @@ void cloog_equal_del(CloogEqualities *equal, int level)
 void cloog_constraint_set_normalize(CloogConstraintSet *constraints, int level)
 { int ref, i, j ;
   cloog_int_t factor_i, factor_ref, temp_i, temp_ref, gcd;
+  cloog_int_t *ref_row, *row;
   CloogMatrix *matrix = &constraints->M;
     
   if (matrix == NULL)
@@ -506,6 +502,7 @@ void cloog_constraint_set_normalize(CloogConstraintSet *constraints, int level)
   /* Let us find an equality for the current level that can be propagated. */
   for (ref=0;ref<matrix->NbRows;ref++)
   if (cloog_int_is_zero(matrix->p[ref][0]) && !cloog_int_is_zero(matrix->p[ref][level])) {
+    ref_row = cloog_matrix_row(matrix, ref);
     cloog_int_init(gcd);
     cloog_int_init(temp_i);
     cloog_int_init(temp_ref);
@@ -515,12 +512,14 @@ void cloog_constraint_set_normalize(CloogConstraintSet *constraints, int level)
     /* Row "ref" is the reference equality, now let us find a row to simplify.*/
     for (i=ref+1;i<matrix->NbRows;i++)
     if (!cloog_int_is_zero(matrix->p[i][level])) {
+      row = cloog_matrix_row(matrix, i);
+
       /* Now let us set to 0 the "level" coefficient of row "j" using "ref".
        * First we compute the factors to apply to each row vector element.
        */
-      cloog_int_gcd(gcd, matrix->p[ref][level], matrix->p[i][level]);
-      cloog_int_divexact(factor_i, matrix->p[ref][level], gcd);
-      cloog_int_divexact(factor_ref, matrix->p[i][level], gcd);
+      cloog_int_gcd(gcd, ref_row[level], row[level]);
+      cloog_int_divexact(factor_i, ref_row[level], gcd);
+      cloog_int_divexact(factor_ref, row[level], gcd);
       
       /* Maybe we are simplifying an inequality: factor_i must not be <0. */
       if (cloog_int_is_neg(factor_i)) {
@@ -530,13 +529,13 @@ void cloog_constraint_set_normalize(CloogConstraintSet *constraints, int level)
       
       /* Now update the vector. */
       for (j=1;j<matrix->NbColumns;j++) {
-        cloog_int_mul(temp_i, factor_i, matrix->p[i][j]);
-        cloog_int_mul(temp_ref, factor_ref, matrix->p[ref][j]);
-        cloog_int_sub(matrix->p[i][j], temp_i, temp_ref);
+        cloog_int_mul(temp_i, factor_i, row[j]);
+        cloog_int_mul(temp_ref, factor_ref, ref_row[j]);
+        cloog_int_sub(row[j], temp_i, temp_ref);
       }
     
       /* Normalize (divide by GCD of all elements) the updated vector. */
-      cloog_seq_normalize(&(matrix->p[i][1]), matrix->NbColumns-1);
+      cloog_seq_normalize(row + 1, matrix->NbColumns-1);
     }
     
     cloog_int_clear(gcd);
@@ -557,15 +556,11 @@ void cloog_constraint_set_normalize(CloogConstraintSet *constraints, int level)
  * - October 26th 2005: first version.
  */
 CloogConstraintSet *cloog_constraint_set_copy(CloogConstraintSet *constraints)
-{ int i, j ;
-  CloogMatrix *copy;
+{ CloogMatrix *copy;
   CloogMatrix *matrix = &constraints->M;
 
   copy = cloog_matrix_alloc(matrix->NbRows, matrix->NbColumns);
-  
-  for (i=0;i<matrix->NbRows;i++)
-  for (j=0;j<matrix->NbColumns;j++)
-      cloog_int_set(copy->p[i][j], matrix->p[i][j]);
+  cloog_matrix_cpy(copy, matrix);
   
   return cloog_constraint_set_from_cloog_matrix(copy);
 }
@@ -595,7 +590,9 @@ struct cloog_vec *cloog_equal_vector_simplify(CloogEqualities *equal, cloog_int_
 				    int length, int level, int nb_par)
 { int i, j ;
   cloog_int_t gcd, factor_vector, factor_equal, temp_vector, temp_equal;
+  cloog_int_t *row;
 	struct cloog_vec *simplified;
+  CloogMatrix *M = &equal->constraints->M;
   
 	simplified = cloog_vec_alloc(length);
 	cloog_seq_cpy(simplified->p, vector, length);
@@ -611,11 +608,13 @@ struct cloog_vec *cloog_equal_vector_simplify(CloogEqualities *equal, cloog_int_
   if (i != level)
   { /* if the coefficient in not null, and there exists a useful equality */
     if ((!cloog_int_is_zero(simplified->p[i])) && equal->types[i-1])
-    { /* Compute the Greatest Common Divisor. */ 
-      cloog_int_gcd(gcd, simplified->p[i], equal->constraints->M.p[i-1][i]);
+    { row = cloog_matrix_row(M, i-1);
+
+      /* Compute the Greatest Common Divisor. */ 
+      cloog_int_gcd(gcd, simplified->p[i], row[i]);
       
       /* Compute the factors to apply to each row vector element. */
-      cloog_int_divexact(factor_vector, equal->constraints->M.p[i-1][i], gcd);
+      cloog_int_divexact(factor_vector, row[i], gcd);
       cloog_int_divexact(factor_equal, simplified->p[i], gcd);
       
       /* We are simplifying an inequality: factor_vector must not be <0. */
@@ -628,7 +627,7 @@ struct cloog_vec *cloog_equal_vector_simplify(CloogEqualities *equal, cloog_int_
       /* - the iterators, up to the current level, */
       for (j=1;j<=length-nb_par-2;j++) {
         cloog_int_mul(temp_vector, factor_vector, simplified->p[j]);
-        cloog_int_mul(temp_equal, factor_equal, equal->constraints->M.p[i-1][j]);
+        cloog_int_mul(temp_equal, factor_equal, row[j]);
         cloog_int_sub(simplified->p[j], temp_vector, temp_equal);
       }
       /* - between last useful iterator (i) and the first parameter, the equal
@@ -637,8 +636,7 @@ struct cloog_vec *cloog_equal_vector_simplify(CloogEqualities *equal, cloog_int_
        */
       for (j = 0; j < nb_par + 1; j++) {
         cloog_int_mul(temp_vector, factor_vector, simplified->p[length-1-j]);
-        cloog_int_mul(temp_equal,factor_equal,
-	     equal->constraints->M.p[i-1][equal->constraints->M.NbColumns-j-1]);
+        cloog_int_mul(temp_equal, factor_equal, row[M->NbColumns-j-1]);
         cloog_int_sub(simplified->p[length-1-j],temp_vector,temp_equal) ;
       }
     }
@@ -689,10 +687,10 @@ CloogConstraintSet *cloog_constraint_set_simplify(CloogConstraintSet *constraint
    */
   simplified = cloog_matrix_alloc(matrix->NbRows, matrix->NbColumns);
   for (i=0;i<matrix->NbRows;i++)
-  { vector = cloog_equal_vector_simplify(equal, matrix->p[i],
+  { vector = cloog_equal_vector_simplify(equal, cloog_matrix_row(matrix, i),
 					  matrix->NbColumns, level, nb_par);
-    for (j=0;j<matrix->NbColumns;j++)
-    cloog_int_set(simplified->p[i][j], vector->p[j]);
+    cloog_seq_cpy(cloog_matrix_row(simplified, i), vector->p,
+		  matrix->NbColumns);
     
     cloog_vec_free(vector);
   }
@@ -743,22 +741,22 @@ struct clast_expr *cloog_constraint_variable_expr(CloogConstraint *constraint,
  */
 int cloog_constraint_involves(CloogConstraint *constraint, int v)
 {
-	return !cloog_int_is_zero(constraint->line[0][1+v]);
+	return !cloog_int_is_zero(constraint->line[1+v]);
 }
 
 int cloog_constraint_is_lower_bound(CloogConstraint *constraint, int v)
 {
-	return cloog_int_is_pos(constraint->line[0][1+v]);
+	return cloog_int_is_pos(constraint->line[1+v]);
 }
 
 int cloog_constraint_is_upper_bound(CloogConstraint *constraint, int v)
 {
-	return cloog_int_is_neg(constraint->line[0][1+v]);
+	return cloog_int_is_neg(constraint->line[1+v]);
 }
 
 int cloog_constraint_is_equality(CloogConstraint *constraint)
 {
-	return cloog_int_is_zero(constraint->line[0][0]);
+	return cloog_int_is_zero(constraint->line[0]);
 }
 
 void cloog_constraint_clear(CloogConstraint *constraint)
@@ -766,7 +764,7 @@ void cloog_constraint_clear(CloogConstraint *constraint)
 	int k;
 
 	for (k = 1; k <= constraint->set->M.NbColumns - 2; k++)
-		cloog_int_set_si(constraint->line[0][k], 0);
+		cloog_int_set_si(constraint->line[k], 0);
 }
 
 CloogConstraintSet *cloog_constraint_set_drop_constraint(
@@ -779,18 +777,18 @@ CloogConstraintSet *cloog_constraint_set_drop_constraint(
 void cloog_constraint_coefficient_get(CloogConstraint *constraint,
 			int var, cloog_int_t *val)
 {
-	cloog_int_set(*val, constraint->line[0][1+var]);
+	cloog_int_set(*val, constraint->line[1+var]);
 }
 
 void cloog_constraint_coefficient_set(CloogConstraint *constraint,
 			int var, cloog_int_t val)
 {
-	cloog_int_set(constraint->line[0][1+var], val);
+	cloog_int_set(constraint->line[1+var], val);
 }
 
 void cloog_constraint_constant_get(CloogConstraint *constraint, cloog_int_t *val)
 {
-	cloog_int_set(*val, constraint->line[0][constraint->set->M.NbColumns-1]);
+	cloog_int_set(*val, constraint->line[constraint->set->M.NbColumns-1]);
 }
 
 /**
@@ -801,7 +799,7 @@ void cloog_constraint_constant_get(CloogConstraint *constraint, cloog_int_t *val
 void cloog_constraint_copy_coefficients(CloogConstraint *constraint,
 					cloog_int_t *dst)
 {
-	cloog_seq_cpy(dst, constraint->line[0]+1, constraint->set->M.NbColumns-1);
+	cloog_seq_cpy(dst, constraint->line+1, constraint->set->M.NbColumns-1);
 }
 
 CloogConstraint *cloog_constraint_invalid(void)
@@ -842,7 +840,7 @@ CloogConstraintSet *cloog_constraint_set_for_reduction(CloogConstraint *upper,
 
 	set = cloog_constraint_set_from_cloog_matrix(
 		cloog_matrix_alloc(1, upper->set->M.NbColumns));
-	cloog_seq_cpy(set->M.p[0], upper->line[0], set->M.NbColumns);
+	cloog_seq_cpy(cloog_matrix_row(&set->M, 0), upper->line, set->M.NbColumns);
 	return set;
 }
 
@@ -920,7 +918,7 @@ CloogConstraintSet *cloog_constraint_set_reduce(CloogConstraintSet *constraints,
   line_vector2 = cloog_vec_alloc(len2);
   line2 = line_vector2->p;
 
-  line = constraints->M.p[0];
+  line = cloog_matrix_row(&constraints->M, 0);
   if (cloog_int_is_pos(line[level]))
     cloog_seq_neg(line+1, line+1, len-1);
   cloog_int_neg(line[level], line[level]);
@@ -1005,14 +1003,16 @@ CloogConstraint *cloog_constraint_first(CloogConstraintSet *constraints)
 		return cloog_constraint_invalid();
 	c = ALLOC(CloogConstraint);
 	c->set = constraints;
-	c->line = &constraints->M.p[0];
+	c->line = cloog_matrix_row(&constraints->M, 0);
 	return c;
 }
 
 CloogConstraint *cloog_constraint_next(CloogConstraint *constraint)
 {
-	constraint->line++;
-	if (constraint->line == constraint->set->M.p + constraint->set->M.NbRows) {
+	CloogMatrix *M = &constraint->set->M;
+
+	constraint->line += M->Stride;
+	if (constraint->line == cloog_matrix_row(M, M->NbRows)) {
 		cloog_constraint_release(constraint);
 		return NULL;
 	}
@@ -1027,6 +1027,14 @@ CloogConstraint *cloog_constraint_copy(CloogConstraint *constraint)
 	return c;
 }
 
+/* Constraint sets are hard copies in the matrix backend, so the constraint
+ * may be modified in place as long as its set is a private copy.
+ */
+CloogConstraint *cloog_constraint_dup(CloogConstraint *constraint)
+{
+	return cloog_constraint_copy(constraint);
+}
+
 void cloog_constraint_release(CloogConstraint *constraint)
 {
 	free(constraint);
@@ -1047,10 +1055,29 @@ int cloog_constraint_set_foreach_constraint(CloogConstraintSet *constraints,
 	return 0;
 }
 
+int cloog_constraint_set_foreach_constraint_involving(
+	CloogConstraintSet *constraints, int level,
+	int (*fn)(CloogConstraint *constraint, void *user), void *user)
+{
+	CloogConstraint *c;
+
+	for (c = cloog_constraint_first(constraints);
+	     cloog_constraint_is_valid(c); c = cloog_constraint_next(c)) {
+		if (!cloog_constraint_involves(c, level - 1))
+			continue;
+		if (fn(c, user) < 0) {
+			cloog_constraint_release(c);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 CloogConstraint *cloog_equal_constraint(CloogEqualities *equal, int j)
 {
 	CloogConstraint *c = ALLOC(CloogConstraint);
 	c->set = equal->constraints;
-	c->line = &equal->constraints->M.p[j];
+	c->line = cloog_matrix_row(&equal->constraints->M, j);
 	return c;
 }
@@ -143,6 +143,17 @@ void cloog_options_print(FILE * foo, CloogOptions * options)
   fprintf(foo,"stop        = %3d,\n",options->stop) ;
   fprintf(foo,"strides     = %3d,\n",options->strides) ;
   fprintf(foo,"sh          = %3d,\n",options->sh);
+  fprintf(foo,"threads     = %3d,\n",options->nb_threads);
+  fprintf(foo,"domain_cache= %3d,\n",options->domain_cache);
+  fprintf(foo,"deadline    = %3d,\n",options->deadline);
+  fprintf(foo,"node_pool   = %3d,\n",options->node_pool);
+  fprintf(foo,"clast_arena = %3d,\n",options->clast_arena);
+  fprintf(foo,"clast_intern= %3d,\n",options->clast_intern);
+  fprintf(foo,"hoist       = %3d,\n",options->hoist);
+  fprintf(foo,"split_minmax= %3d,\n",options->split_minmax);
+  fprintf(foo,"report_guards=%3d,\n",options->report_guards);
+  fprintf(foo,"fold_guards = %3d,\n",options->fold_guards);
+  fprintf(foo,"full_tiles  = %3d,\n",options->full_tiles);
   fprintf(foo,"OPTIONS FOR PRETTY PRINTING\n") ;
   fprintf(foo,"esp         = %3d,\n",options->esp) ;
   fprintf(foo,"fsp         = %3d,\n",options->fsp) ;
@@ -150,6 +161,11 @@ void cloog_options_print(FILE * foo, CloogOptions * options)
   fprintf(foo,"block       = %3d.\n",options->block) ;
   fprintf(foo,"compilable  = %3d.\n",options->compilable) ;
   fprintf(foo,"callable    = %3d.\n",options->callable) ;
+  fprintf(foo,"omp_collapse= %3d.\n",options->omp_collapse);
+  fprintf(foo,"omp_schedule= %3d.\n",options->omp_schedule);
+  fprintf(foo,"omp_simd    = %3d.\n",options->omp_simd);
+  fprintf(foo,"unroll_jam  = %3d.\n",options->unroll_jam);
+  fprintf(foo,"iterator_type=%3d.\n",options->iterator_type);
   fprintf(foo,"MISC OPTIONS\n") ;
   fprintf(foo,"name        = %3s.\n", options->name ? options->name : "");
   fprintf(foo,"openscop    = %3d.\n", options->openscop);
@@ -157,6 +173,7 @@ void cloog_options_print(FILE * foo, CloogOptions * options)
     fprintf(foo,"scop        = (present but not printed).\n");
   else
     fprintf(foo,"scop        = NULL.\n");
+  fprintf(foo,"stats       = %3d.\n",options->stats);
   fprintf(foo,"UNDOCUMENTED OPTIONS FOR THE AUTHOR ONLY\n") ;
   fprintf(foo,"leaks       = %3d.\n",options->leaks) ;
   fprintf(foo,"backtrack   = %3d.\n",options->backtrack);
@@ -187,6 +204,7 @@ void cloog_options_free(CloogOptions *options)
 #endif
   free(options->fs);
   free(options->ls);
+  free(options->degraded);
   free(options);
 }
 
@@ -216,7 +234,29 @@ void cloog_options_help()
   "\n                        (default setting: -1).\n"
   "  -strides <boolean>    Handle non-unit strides (1) or not (0)\n"
   "                        (default setting:  0).\n"
-  "  -first-unroll <depth> First loop dimension to unroll (-1: no unrolling)\n");
+  "  -first-unroll <depth> First loop dimension to unroll (-1: no unrolling)\n"
+  "  -threads <number>     Number of threads used for loop separation\n"
+  "                        (default setting:  1).\n"
+  "  -domain-cache <size>  Number of memoized domain operations, 0 for none\n"
+  "                        (default setting:  0).\n"
+  "  -deadline <ms>        Time budget after which loops are merged instead\n"
+  "                        of separated (default setting: -1, no budget).\n"
+  "  -node-pool <boolean>  Allocate loops, blocks and statements from pools\n"
+  "                        (1) or with malloc (0) (default setting:  0).\n"
+  "  -clast-arena <boolean> Allocate the clast in a single region (1) or\n"
+  "                        node by node (0) (default setting:  0).\n"
+  "  -clast-intern <boolean> Share equal clast expressions (1) or not (0)\n"
+  "                        (default setting:  0).\n"
+  "  -hoist <boolean>      Hoist loop-invariant bounds into temporaries (1)\n"
+  "                        or not (0) (default setting:  0).\n"
+  "  -split-minmax <n>     Split loops into at most n pieces to avoid min/max\n"
+  "                        in inner loop bounds (default setting:  0, none).\n"
+  "  -report-guards <boolean> Report the modulo guards that are not turned\n"
+  "                        into strides (1) or not (0) (default setting:  0).\n"
+  "  -fold-guards <boolean> Fold modulo guards into loop strides (1) or not\n"
+  "                        (0) (default setting:  0).\n"
+  "  -full-tiles <depth>   Separate full tiles from partial ones at loop depth\n"
+  "                        <depth> (default setting:  0, no separation).\n");
   printf(
   "\nOptions for pretty printing:\n"
   "  -otl <boolean>        Simplify loops running one time (1) or not (0)\n"
@@ -236,6 +276,19 @@ void cloog_options_help()
   "  -callable <boolean>   Testable code by using preprocessor (not 0) or" 
   "\n                        not (0) (default setting:  0).\n");
   printf(
+  "  -omp-collapse <n>     Collapse up to n nested OpenMP parallel loops\n"
+  "                        (default setting:  0, no collapse).\n"
+  "  -omp-schedule <k>     Dynamic schedule with chunk k (k > 0), guided\n"
+  "                        schedule (-1) or default schedule (0) for OpenMP\n"
+  "                        loops with unbalanced iterations (default: 0).\n"
+  "  -omp-simd <n>         Use omp simd for vector loops (1), with safelen(n)\n"
+  "                        (n > 1), or ivdep (0) (default setting:  0).\n"
+  "  -unroll-jam <n>       Unroll-and-jam factor of the loops marked in the\n"
+  "                        OpenScop loop extension (default setting:  2).\n"
+  "  -iterator-type <type> Declare iterators int, long (long long) or auto\n"
+  "                        (long long unless provably in the range of int)\n"
+  "                        (default setting: int).\n");
+  printf(
   "\nGeneral options:\n"
   "  -o <output>           Name of the output file; 'stdout' is a special\n"
   "                        value: when used, output is standard output\n"
@@ -245,6 +298,10 @@ void cloog_options_help()
 #endif
   "  -v, --version         Display the version information (and more).\n"
   "  -q, --quiet           Don't print any informational messages.\n"
+  "  -stats json           Print per-phase timings and domain operation\n"
+  "                        counts as JSON on the standard error.\n"
+  "  -trace <file>         Write Chrome trace events of code generation\n"
+  "                        to file.\n"
   "  -h, --help            Display this information.\n\n") ;
   printf(
   "The special value 'stdin' for 'file' makes CLooG to read data on\n"
@@ -346,7 +403,21 @@ CloogOptions *cloog_options_malloc(CloogState *state)
   options->strides     =  0 ;  /* Generate a code with unit strides. */
   options->sh	       =  0;   /* Compute actual convex hull. */
   options->first_unroll = -1;  /* First level to unroll: none. */
+  options->nb_threads  =  1 ;  /* Separate loops sequentially. */
+  options->domain_cache =  0;  /* Do not memoize domain operations. */
+  options->deadline    = -1 ;  /* No time budget. */
+  options->node_pool   =  0 ;  /* Allocate nodes with malloc. */
+  options->clast_arena =  0 ;  /* Allocate clast nodes with malloc. */
+  options->clast_intern = 0 ;  /* Do not share clast expressions. */
+  options->hoist       =  0 ;  /* Do not hoist loop bounds. */
+  options->split_minmax = 0 ;  /* Do not split loops at min/max crossovers. */
+  options->report_guards = 0 ; /* Do not report modulo guards. */
+  options->fold_guards =  0 ;  /* Keep modulo guards as guards. */
+  options->full_tiles  =  0 ;  /* Do not separate full tiles. */
   options->name	       = NULL;
+  options->deadline_start = 0;
+  options->degraded    = NULL;
+  options->nb_degraded = 0;
   /* OPTIONS FOR PRETTY PRINTING */
   options->esp         =  1 ;  /* We want Equality SPreading.*/
   options->fsp         =  1 ;  /* The First level to SPread is the first. */
@@ -354,7 +425,13 @@ CloogOptions *cloog_options_malloc(CloogState *state)
   options->block       =  0 ;  /* We don't want to force statement blocks. */
   options->compilable  =  0 ;  /* No compilable code. */
   options->callable    =  0 ;  /* No callable code. */
+  options->omp_collapse = 0 ;  /* Do not collapse OpenMP loops. */
+  options->omp_schedule = 0 ;  /* Default OpenMP schedule. */
+  options->omp_simd    =  0 ;  /* Vector loops use ivdep. */
+  options->unroll_jam  =  2 ;  /* Marked loops are unroll-and-jammed by 2. */
+  options->iterator_type = CLOOG_ITERATOR_INT; /* Iterators are int. */
   options->quiet       =  0;   /* Do print informational messages. */
+  options->stats       =  0;   /* Do not print statistics. */
   options->save_domains = 0;   /* Don't save domains. */
   /* MISC OPTIONS */
   options->language    = CLOOG_LANGUAGE_C; /* The default output language is C. */
@@ -409,6 +486,37 @@ void cloog_options_read(CloogState *state, int argc, char **argv,
       cloog_options_set(&(*options)->sh,argc,argv,&i) ;
     else if (!strcmp(argv[i], "-first-unroll"))
       cloog_options_set(&(*options)->first_unroll, argc, argv, &i);
+    else if (!strcmp(argv[i], "-threads")) {
+      cloog_options_set(&(*options)->nb_threads, argc, argv, &i);
+#ifndef CLOOG_THREADS
+      if ((*options)->nb_threads > 1) {
+        cloog_msg(*options, CLOOG_WARNING,
+                  "CLooG has not been compiled with thread support, "
+                  "-threads ignored.\n");
+        (*options)->nb_threads = 1;
+      }
+#endif
+    }
+    else if (!strcmp(argv[i], "-domain-cache"))
+      cloog_options_set(&(*options)->domain_cache, argc, argv, &i);
+    else if (!strcmp(argv[i], "-deadline"))
+      cloog_options_set(&(*options)->deadline, argc, argv, &i);
+    else if (!strcmp(argv[i], "-node-pool"))
+      cloog_options_set(&(*options)->node_pool, argc, argv, &i);
+    else if (!strcmp(argv[i], "-clast-arena"))
+      cloog_options_set(&(*options)->clast_arena, argc, argv, &i);
+    else if (!strcmp(argv[i], "-clast-intern"))
+      cloog_options_set(&(*options)->clast_intern, argc, argv, &i);
+    else if (!strcmp(argv[i], "-hoist"))
+      cloog_options_set(&(*options)->hoist, argc, argv, &i);
+    else if (!strcmp(argv[i], "-split-minmax"))
+      cloog_options_set(&(*options)->split_minmax, argc, argv, &i);
+    else if (!strcmp(argv[i], "-report-guards"))
+      cloog_options_set(&(*options)->report_guards, argc, argv, &i);
+    else if (!strcmp(argv[i], "-fold-guards"))
+      cloog_options_set(&(*options)->fold_guards, argc, argv, &i);
+    else if (!strcmp(argv[i], "-full-tiles"))
+      cloog_options_set(&(*options)->full_tiles, argc, argv, &i);
     else
     if (strcmp(argv[i],"-otl") == 0)
     cloog_options_set(&(*options)->otl,argc,argv,&i) ;
@@ -434,6 +542,27 @@ void cloog_options_read(CloogState *state, int argc, char **argv,
       cloog_options_set(&(*options)->compilable, argc, argv, &i);
     else if (strcmp(argv[i], "-callable") == 0)
       cloog_options_set(&(*options)->callable, argc, argv, &i);
+    else if (!strcmp(argv[i], "-omp-collapse"))
+      cloog_options_set(&(*options)->omp_collapse, argc, argv, &i);
+    else if (!strcmp(argv[i], "-omp-schedule"))
+      cloog_options_set(&(*options)->omp_schedule, argc, argv, &i);
+    else if (!strcmp(argv[i], "-omp-simd"))
+      cloog_options_set(&(*options)->omp_simd, argc, argv, &i);
+    else if (!strcmp(argv[i], "-unroll-jam"))
+      cloog_options_set(&(*options)->unroll_jam, argc, argv, &i);
+    else if (strcmp(argv[i], "-iterator-type") == 0) {
+      if (i+1 >= argc)
+        cloog_die("no type for -iterator-type option.\n");
+      if (strcmp(argv[i+1], "int") == 0)
+        (*options)->iterator_type = CLOOG_ITERATOR_INT;
+      else if (strcmp(argv[i+1], "long") == 0)
+        (*options)->iterator_type = CLOOG_ITERATOR_LONG;
+      else if (strcmp(argv[i+1], "auto") == 0)
+        (*options)->iterator_type = CLOOG_ITERATOR_AUTO;
+      else
+        cloog_die("unknown type %s for -iterator-type option.\n", argv[i+1]);
+      i++;
+    }
     else
     if (strcmp(argv[i],"-loopo") == 0) /* Special option for the LooPo team ! */
     { (*options)->esp   = 0 ;
@@ -476,6 +605,24 @@ void cloog_options_read(CloogState *state, int argc, char **argv,
       infos = 1 ;
     } else if ((strcmp(argv[i],"--quiet") == 0) || (strcmp(argv[i],"-q") == 0))
       (*options)->quiet = 1;
+    else if (strcmp(argv[i], "-stats") == 0) {
+      if (i+1 >= argc)
+        cloog_die("no format for -stats option.\n");
+      if (strcmp(argv[i+1], "json") != 0)
+        cloog_die("unknown format %s for -stats option.\n", argv[i+1]);
+      (*options)->stats = 1;
+      i++;
+    }
+    else if (strcmp(argv[i], "-trace") == 0) {
+      FILE *trace;
+      if (i+1 >= argc)
+        cloog_die("no file name for -trace option.\n");
+      trace = fopen(argv[i+1], "w");
+      if (trace == NULL)
+        cloog_die("can't create trace file %s.\n", argv[i+1]);
+      cloog_state_set_trace(state, trace);
+      i++;
+    }
     else
     if (strcmp(argv[i],"-o") == 0)
     { if (i+1 >= argc)
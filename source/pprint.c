@@ -290,7 +290,8 @@ void pprint_assignment(struct cloogoptions *i, FILE *dst,
  * pprint_osl_body function:
  * this function pretty-prints the OpenScop body of a given statement.
  * It returns 1 if it succeeds to find an OpenScop body to print for
- * that statement, 0 otherwise.
+ * that statement, 0 otherwise. The callable and compilable codes use the
+ * statement macros instead.
  * \param[in] options CLooG Options.
  * \param[in] dst     Output stream.
  * \param[in] u       Statement to print the OpenScop body.
@@ -307,7 +308,7 @@ int pprint_osl_body(struct cloogoptions *options, FILE *dst,
   osl_body_p body;
   osl_annotation_t* annotations;
 
-  if ((scop != NULL) &&
+  if ((scop != NULL) && !options->callable && !options->compilable &&
       (osl_statement_number(scop->statement) >= u->statement->number)) {
     stmt = scop->statement;
 
@@ -475,9 +476,192 @@ void pprint_guard(struct cloogoptions *options, FILE *dst, int indent,
 	fprintf(dst,"}\n"); 
 }
 
+/* Returns 1 if the expression e refers to the variable "name". */
+static int pprint_expr_uses(struct clast_expr *e, const char *name)
+{
+    struct clast_reduction *r;
+    int i;
+
+    if (!e)
+	return 0;
+    switch (e->type) {
+    case clast_expr_name:
+	return !strcmp(((struct clast_name *)e)->name, name);
+    case clast_expr_term:
+	return pprint_expr_uses(((struct clast_term *)e)->var, name);
+    case clast_expr_bin:
+	return pprint_expr_uses(((struct clast_binary *)e)->LHS, name);
+    case clast_expr_red:
+	r = (struct clast_reduction *)e;
+	for (i = 0; i < r->n; ++i)
+	    if (pprint_expr_uses(r->elts[i], name))
+		return 1;
+	return 0;
+    }
+    return 0;
+}
+
+/* Returns 1 if the bounds of some loop in the statements s refer to one of
+ * the iterators of the n first loops of the perfect nest rooted at f.
+ */
+static int pprint_bounds_use_nest(struct clast_stmt *s, struct clast_for *f,
+				  int n)
+{
+    struct clast_for *g, *l;
+    int k;
+
+    for (; s; s = s->next) {
+	if (CLAST_STMT_IS_A(s, stmt_for)) {
+	    l = (struct clast_for *)s;
+	    for (g = f, k = 0; k < n; g = (struct clast_for *)g->body, ++k)
+		if (pprint_expr_uses(l->LB, g->iterator) ||
+		    pprint_expr_uses(l->UB, g->iterator))
+		    return 1;
+	    if (pprint_bounds_use_nest(l->body, f, n))
+		return 1;
+	} else if (CLAST_STMT_IS_A(s, stmt_guard)) {
+	    if (pprint_bounds_use_nest(((struct clast_guard *)s)->then, f, n))
+		return 1;
+	}
+    }
+    return 0;
+}
+
+/* Returns the number of loops of the perfect nest of OpenMP parallel loops
+ * rooted at f that can be collapsed with it, including f: the loops must not
+ * have their own clauses and their bounds must not depend on the iterators
+ * of the enclosing loops of the nest. The nest stops at a vector loop, which
+ * needs its own simd or ivdep pragma and cannot have one inside a collapsed
+ * nest. The nest is collapsed when the -omp-collapse option or the
+ * CLAST_PARALLEL_COLLAPSE mark of f asks for it, in the first case up to
+ * options->omp_collapse loops.
+ */
+static int pprint_omp_collapse(struct cloogoptions *options,
+			       struct clast_for *f)
+{
+    struct clast_for *g, *h;
+    int k, n, max;
+
+    if (f->parallel & CLAST_PARALLEL_VEC)
+	return 1;
+    if (f->parallel & CLAST_PARALLEL_COLLAPSE)
+	max = options->omp_collapse > 1 ? options->omp_collapse : -1;
+    else if (options->omp_collapse > 1)
+	max = options->omp_collapse;
+    else
+	return 1;
+
+    for (n = 1, h = f; max < 0 || n < max; ++n) {
+	if (!h->body || h->body->next || !CLAST_STMT_IS_A(h->body, stmt_for))
+	    break;
+	h = (struct clast_for *)h->body;
+	if (!(h->parallel & CLAST_PARALLEL_OMP) ||
+	    (h->parallel & (CLAST_PARALLEL_MPI | CLAST_PARALLEL_USER |
+			    CLAST_PARALLEL_VEC)) ||
+	    !h->LB || !h->UB || h->private_vars || h->reduction_vars ||
+	    h->time_var_name)
+	    break;
+	for (g = f, k = 0; k < n; g = (struct clast_for *)g->body, ++k)
+	    if (pprint_expr_uses(h->LB, g->iterator) ||
+		pprint_expr_uses(h->UB, g->iterator))
+		break;
+	if (k < n)
+	    break;
+    }
+    return n;
+}
+
+/* Prints the clauses of the "omp parallel for" directive of the loop f,
+ * whose perfect nest of n loops is collapsed: "collapse" if n > 1 and
+ * "schedule" if the -omp-schedule option or the CLAST_PARALLEL_DYNAMIC mark
+ * asks for it and the bounds of an inner loop depend on the iterators of the
+ * nest, i.e., when the iterations of the nest have unequal costs.
+ */
+static void pprint_omp_clauses(struct cloogoptions *options, FILE *dst,
+			       struct clast_for *f, int n)
+{
+    struct clast_stmt *body;
+    int k;
+
+    if (n > 1)
+	fprintf(dst, " collapse(%d)", n);
+    if (options->omp_schedule || (f->parallel & CLAST_PARALLEL_DYNAMIC)) {
+	for (body = &f->stmt, k = 0; k < n; ++k)
+	    body = ((struct clast_for *)body)->body;
+	if (pprint_bounds_use_nest(body, f, n)) {
+	    if (options->omp_schedule < 0)
+		fprintf(dst, " schedule(guided)");
+	    else
+		fprintf(dst, " schedule(dynamic,%d)",
+			options->omp_schedule > 0 ? options->omp_schedule : 1);
+	}
+    }
+    fprintf(dst, "%s%s%s%s%s%s\n",
+	    (f->private_vars)? " private(":"",
+	    (f->private_vars)? f->private_vars: "",
+	    (f->private_vars)? ")":"",
+	    (f->reduction_vars)? " reduction(": "",
+	    (f->reduction_vars)? f->reduction_vars: "",
+	    (f->reduction_vars)? ")": "");
+}
+
+/* Prints the header "for (...) {" of the loop f, using the variables lb
+ * and ub for its bounds if they are not NULL.
+ */
+static void pprint_for_header(struct cloogoptions *options, FILE *dst,
+			      struct clast_for *f, const char *lb,
+			      const char *ub)
+{
+    if (options->language == CLOOG_LANGUAGE_FORTRAN)
+	fprintf(dst, "DO ");
+    else
+	fprintf(dst, "for (");
+
+    if (f->LB) {
+	fprintf(dst, "%s=", f->iterator);
+	if (lb)
+	    fprintf(dst, "%s", lb);
+	else
+	    pprint_expr(options, dst, f->LB);
+    } else if (options->language == CLOOG_LANGUAGE_FORTRAN)
+	cloog_die("unbounded loops not allowed in FORTRAN.\n");
+
+    if (options->language == CLOOG_LANGUAGE_FORTRAN)
+	fprintf(dst,", ");
+    else
+	fprintf(dst,";");
+
+    if (f->UB) { 
+	if (options->language != CLOOG_LANGUAGE_FORTRAN)
+	    fprintf(dst,"%s<=", f->iterator);
+	if (ub)
+	    fprintf(dst, "%s", ub);
+	else
+	    pprint_expr(options, dst, f->UB);
+    }else if (options->language == CLOOG_LANGUAGE_FORTRAN)
+	cloog_die("unbounded loops not allowed in FORTRAN.\n");
+
+    if (options->language == CLOOG_LANGUAGE_FORTRAN) {
+	if (cloog_int_gt_si(f->stride, 1))
+	    cloog_int_print(dst, f->stride);
+	fprintf(dst,"\n");
+    }
+    else {
+	if (cloog_int_gt_si(f->stride, 1)) {
+	    fprintf(dst,";%s+=", f->iterator);
+	    cloog_int_print(dst, f->stride);
+	    fprintf(dst, ") {\n");
+      } else
+	fprintf(dst, ";%s++) {\n", f->iterator);
+    }
+}
+
 void pprint_for(struct cloogoptions *options, FILE *dst, int indent,
 		 struct clast_for *f)
 {
+    struct clast_for *g = f;
+    int k, collapse = 1;
+
     if (options->language == CLOOG_LANGUAGE_C) {
         if (f->time_var_name) {
             fprintf(dst, "IF_TIME(%s_start = cloog_util_rtclock());\n",
@@ -520,13 +704,14 @@ void pprint_for(struct cloogoptions *options, FILE *dst, int indent,
                 pprint_expr(options, dst, f->UB);
                 fprintf(dst, ";\n");
             }
-            fprintf(dst, "#pragma omp parallel for%s%s%s%s%s%s\n",
-                    (f->private_vars)? " private(":"",
-                    (f->private_vars)? f->private_vars: "",
-                    (f->private_vars)? ")":"",
-                    (f->reduction_vars)? " reduction(": "",
-                    (f->reduction_vars)? f->reduction_vars: "",
-                    (f->reduction_vars)? ")": "");
+            collapse = pprint_omp_collapse(options, f);
+            fprintf(dst, "#pragma omp parallel for");
+            /* A vector loop that is also parallel gets the combined
+             * construct, since ivdep would not apply to it. */
+            if ((f->parallel & CLAST_PARALLEL_VEC) &&
+                (options->omp_simd || (f->parallel & CLAST_PARALLEL_SIMD)))
+                fprintf(dst, " simd");
+            pprint_omp_clauses(options, dst, f, collapse);
             fprintf(dst, "%*s", indent, "");
         }
         if ((f->parallel & CLAST_PARALLEL_VEC) && !(f->parallel & CLAST_PARALLEL_OMP)
@@ -542,8 +727,15 @@ void pprint_for(struct cloogoptions *options, FILE *dst, int indent,
                 pprint_expr(options, dst, f->UB);
                 fprintf(dst, ";\n");
             }
-            fprintf(dst, "%*s#pragma ivdep\n", indent, "");
-            fprintf(dst, "%*s#pragma vector always\n", indent, "");
+            if (options->omp_simd || (f->parallel & CLAST_PARALLEL_SIMD)) {
+                fprintf(dst, "%*s#pragma omp simd", indent, "");
+                if (options->omp_simd > 1 && cloog_int_is_one(f->stride))
+                    fprintf(dst, " safelen(%d)", options->omp_simd);
+                fprintf(dst, "\n");
+            } else {
+                fprintf(dst, "%*s#pragma ivdep\n", indent, "");
+                fprintf(dst, "%*s#pragma vector always\n", indent, "");
+            }
             fprintf(dst, "%*s", indent, "");
         }
         if (f->parallel & CLAST_PARALLEL_MPI) {
@@ -574,58 +766,24 @@ void pprint_for(struct cloogoptions *options, FILE *dst, int indent,
 
     }
 
-    if (options->language == CLOOG_LANGUAGE_FORTRAN)
-	fprintf(dst, "DO ");
-    else
-	fprintf(dst, "for (");
-
-    if (f->LB) {
-	fprintf(dst, "%s=", f->iterator);
-        if (f->parallel & (CLAST_PARALLEL_OMP | CLAST_PARALLEL_MPI)) {
-            fprintf(dst, "lbp");
-        }else if (f->parallel & CLAST_PARALLEL_VEC){
-            fprintf(dst, "lbv");
-        }else{
-	pprint_expr(options, dst, f->LB);
-        }
-    } else if (options->language == CLOOG_LANGUAGE_FORTRAN)
-	cloog_die("unbounded loops not allowed in FORTRAN.\n");
-
-    if (options->language == CLOOG_LANGUAGE_FORTRAN)
-	fprintf(dst,", ");
+    if (f->parallel & (CLAST_PARALLEL_OMP | CLAST_PARALLEL_MPI))
+        pprint_for_header(options, dst, f, "lbp", "ubp");
+    else if (f->parallel & CLAST_PARALLEL_VEC)
+        pprint_for_header(options, dst, f, "lbv", "ubv");
     else
-	fprintf(dst,";");
-
-    if (f->UB) { 
-	if (options->language != CLOOG_LANGUAGE_FORTRAN)
-	    fprintf(dst,"%s<=", f->iterator);
+        pprint_for_header(options, dst, f, NULL, NULL);
 
-        if (f->parallel & (CLAST_PARALLEL_OMP | CLAST_PARALLEL_MPI)) {
-            fprintf(dst, "ubp");
-        }else if (f->parallel & CLAST_PARALLEL_VEC){
-            fprintf(dst, "ubv");
-        }else{
-            pprint_expr(options, dst, f->UB);
-        }
-    }else if (options->language == CLOOG_LANGUAGE_FORTRAN)
-	cloog_die("unbounded loops not allowed in FORTRAN.\n");
-
-    if (options->language == CLOOG_LANGUAGE_FORTRAN) {
-	if (cloog_int_gt_si(f->stride, 1))
-	    cloog_int_print(dst, f->stride);
-	fprintf(dst,"\n");
-    }
-    else {
-	if (cloog_int_gt_si(f->stride, 1)) {
-	    fprintf(dst,";%s+=", f->iterator);
-	    cloog_int_print(dst, f->stride);
-	    fprintf(dst, ") {\n");
-      } else
-	fprintf(dst, ";%s++) {\n", f->iterator);
+    /* The inner loops of a collapsed nest keep their bounds. */
+    for (g = f, k = 1; k < collapse; ++k) {
+        g = (struct clast_for *)g->body;
+        fprintf(dst, "%*s", indent + k * INDENT_STEP, "");
+        pprint_for_header(options, dst, g, NULL, NULL);
     }
 
-    pprint_stmt_list(options, dst, indent + INDENT_STEP, f->body);
+    pprint_stmt_list(options, dst, indent + collapse * INDENT_STEP, g->body);
 
+    for (k = collapse - 1; k >= 1; --k)
+        fprintf(dst, "%*s}\n", indent + k * INDENT_STEP, "");
     fprintf(dst, "%*s", indent, "");
     if (options->language == CLOOG_LANGUAGE_FORTRAN)
 	fprintf(dst,"END DO\n") ; 
@@ -679,7 +837,9 @@ void pprint_stmt_list(struct cloogoptions *options, FILE *dst, int indent,
 void clast_pprint(FILE *foo, struct clast_stmt *root,
 		  int indent, CloogOptions *options)
 {
+    cloog_state_phase_start(options->state, CLOOG_PHASE_PPRINT);
     pprint_stmt_list(options, foo, indent, root);
+    cloog_state_phase_end(options->state, CLOOG_PHASE_PPRINT);
 }
 
 
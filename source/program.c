@@ -45,6 +45,7 @@
 # include <stdio.h>
 # include <string.h>
 # include <ctype.h>
+# include <limits.h>
 # include <unistd.h>
 # include "../include/cloog/cloog.h"
 #ifdef CLOOG_RUSAGE
@@ -298,16 +299,65 @@ static void print_macros(FILE *file)
                   "#else\n#define IF_TIME(foo)\n#endif\n\n");
 }
 
-static void print_declarations(FILE *file, int n, char **names, int indentation)
+/* Declare the n names, those whose is_long entry is set (or all of them if
+ * all_long is set) as long long and the others as int.
+ */
+static void print_declarations(FILE *file, int n, char **names, int *is_long,
+	int all_long, int indentation)
+{
+    int i, j, type, first;
+
+    for (type = 0; type < 2; type++) {
+	first = 1;
+	for (i = 0; i < n; i++) {
+	    if ((all_long || (is_long && is_long[i])) != type)
+		continue;
+	    if (first) {
+		for (j = 0; j < indentation; j++)
+		  fprintf(file, " ");
+		fprintf(file, "%s %s", type ? "long long" : "int", names[i]);
+		first = 0;
+	    } else
+		fprintf(file, ", %s", names[i]);
+	}
+	if (!first)
+	    fprintf(file, ";\n");
+    }
+}
+
+/* Return 1 if any scattering dimension, iterator or parameter needs a long
+ * long type, in which case the loop bound temporaries need one too.
+ */
+static int program_has_long_dims(CloogProgram *program)
 {
     int i;
 
-    for (i = 0; i < indentation; i++)
-      fprintf(file, " ");
-    fprintf(file, "int %s", names[0]);
-    for (i = 1; i < n; i++)
-	fprintf(file, ", %s", names[i]);
-    fprintf(file, ";\n");
+    if (!program->long_dims)
+	return 0;
+    for (i = 0; i < program->names->nb_scattering +
+		    program->names->nb_iterators +
+		    program->names->nb_parameters; i++)
+	if (program->long_dims[i])
+	    return 1;
+    return 0;
+}
+
+/* Return 1 if the parameter at position "i" needs a long long type. */
+static int program_long_parameter(CloogProgram *program, int i)
+{
+    CloogNames *names = program->names;
+
+    if (!program->long_dims)
+	return 0;
+    return program->long_dims[names->nb_scattering + names->nb_iterators + i];
+}
+
+/* Return 1 if the original iterator at position "i" needs a long long type. */
+static int program_long_iterator(CloogProgram *program, int i)
+{
+    if (!program->long_dims)
+	return 0;
+    return program->long_dims[program->names->nb_scattering + i];
 }
 
 static void print_scattering_declarations(FILE *file, CloogProgram *program,
@@ -320,6 +370,7 @@ static void print_scattering_declarations(FILE *file, CloogProgram *program,
     // Copy pointer only to those scatering names that do not duplicate
     // iterator names.
     char **scatnames = (char **) malloc(sizeof(char *) * names->nb_scattering);
+    int *scatlong = (int *) malloc(sizeof(int) * names->nb_scattering);
     for (i = 0; i < names->nb_scattering; ++i) {
       for (j = 0; j < names->nb_iterators; ++j) {
         found = 0;
@@ -329,6 +380,7 @@ static void print_scattering_declarations(FILE *file, CloogProgram *program,
       }
       if (!found) {
         // Save a pointer (intentional!) to the names in the new array.
+        scatlong[nb_scatnames] = program->long_dims && program->long_dims[i];
         scatnames[nb_scatnames++] = names->scattering[i];
       }
     }
@@ -337,13 +389,43 @@ static void print_scattering_declarations(FILE *file, CloogProgram *program,
         for (i = 0; i < indentation; i++)
             fprintf(file, " ");
         fprintf(file, "/* Scattering iterators. */\n");
-        print_declarations(file, nb_scatnames, scatnames, indentation);
+        print_declarations(file, nb_scatnames, scatnames, scatlong, 0,
+                           indentation);
     }
     free(scatnames);
+    free(scatlong);
 }
 
+/* Declare the original iterators, with the type chosen for each of them. */
+static void print_original_declarations(FILE *file, CloogProgram *program,
+	int indentation)
+{
+    CloogNames *names = program->names;
+    int *is_long = NULL;
+
+    if (program->long_dims)
+	is_long = program->long_dims + names->nb_scattering;
+    print_declarations(file, names->nb_iterators, names->iterators, is_long, 0,
+			indentation);
+}
+
+/* Declare the temporaries introduced by clast_hoist_bounds, if any. */
+static void print_temporary_declarations(FILE *file, CloogProgram *program,
+	struct clast_stmt *root, int indentation)
+{
+    struct clast_root *r = (struct clast_root *) root;
+    int i;
+
+    if (!r->nb_temporaries)
+	return;
+    for (i = 0; i < indentation; i++)
+      fprintf(file, " ");
+    fprintf(file, "/* Loop bounds. */\n");
+    print_declarations(file, r->nb_temporaries, r->temporaries, NULL,
+			program_has_long_dims(program), indentation);
+}
 static void print_iterator_declarations(FILE *file, CloogProgram *program,
-	CloogOptions *options)
+	struct clast_stmt *root, CloogOptions *options)
 {
     (void) options;
     CloogNames *names = program->names;
@@ -351,12 +433,13 @@ static void print_iterator_declarations(FILE *file, CloogProgram *program,
     print_scattering_declarations(file, program, 2);
     if (names->nb_iterators) {
 	fprintf(file, "  /* Original iterators. */\n");
-	print_declarations(file, names->nb_iterators, names->iterators, 2);
+	print_original_declarations(file, program, 2);
     }
+    print_temporary_declarations(file, program, root, 2);
 }
 
 static void print_callable_preamble(FILE *file, CloogProgram *program,
-	CloogOptions *options)
+	struct clast_stmt *root, CloogOptions *options)
 {
     int j;
     CloogBlockList *blocklist;
@@ -377,19 +460,22 @@ static void print_callable_preamble(FILE *file, CloogProgram *program,
 		    fprintf(file, ",%s", program->names->iterators[j]);
 	    }
 	    fprintf(file,") { hash(%d);", statement->number);
-	    for(j = 0; j < block->depth; j++)
+	    for(j = 0; j < block->depth; j++) {
 		fprintf(file, " hash(%s);", program->names->iterators[j]);
+		if (program_long_iterator(program, j))
+		    fprintf(file, " hash(%s >> 32);",
+			    program->names->iterators[j]);
+	    }
 	    fprintf(file, " }\n");
 	}
     }
     fprintf(file, "\nvoid test("); 
-    if (program->names->nb_parameters > 0) {
-	fprintf(file, "int %s", program->names->parameters[0]);
-	for(j = 1; j < program->names->nb_parameters; j++)
-	    fprintf(file, ", int %s", program->names->parameters[j]);
-    }
+    for (j = 0; j < program->names->nb_parameters; j++)
+	fprintf(file, "%s%s %s", j ? ", " : "",
+		program_long_parameter(program, j) ? "long long" : "int",
+		program->names->parameters[j]);
     fprintf(file, ")\n{\n"); 
-    print_iterator_declarations(file, program, options);
+    print_iterator_declarations(file, program, root, options);
 }
 
 static void print_callable_postamble(FILE *file, CloogProgram *program)
@@ -411,7 +497,7 @@ static int get_osl_loop_flags (osl_scop_p scop) {
 }
 
 static void print_iterator_declarations_osl(FILE *file, CloogProgram *program,
-    int indent, CloogOptions *options)
+    struct clast_stmt *root, int indent, CloogOptions *options)
 {
   osl_coordinates_p co = NULL;
   int i;
@@ -428,8 +514,9 @@ static void print_iterator_declarations_osl(FILE *file, CloogProgram *program,
     for (i = 0; i < indent; i++)
       fprintf(file, " ");
     fprintf(file, "/* Original iterators. */\n");
-    print_declarations(file, names->nb_iterators, names->iterators, indent);
+    print_original_declarations(file, program, indent);
   }
+  print_temporary_declarations(file, program, root, indent);
 
   /*
    * Assigning string literals as follows is illegal in pedantic C:
@@ -443,7 +530,8 @@ static void print_iterator_declarations_osl(FILE *file, CloogProgram *program,
     snprintf(parvar_1, sizeof parvar_1 / sizeof *parvar_1, "ubp");
 
     char* parvar[2] = { parvar_0, parvar_1, };
-    print_declarations(file, 2, (char**) parvar, indent);
+    print_declarations(file, 2, (char**) parvar, NULL,
+                       program_has_long_dims(program), indent);
   }
   if(loopflags & CLAST_PARALLEL_VEC) {
     char vecvar_0[4], vecvar_1[4];
@@ -451,7 +539,8 @@ static void print_iterator_declarations_osl(FILE *file, CloogProgram *program,
     snprintf(vecvar_1, sizeof vecvar_1 / sizeof *vecvar_1, "ubv");
 
     char* vecvar[2] = { vecvar_0, vecvar_1, };
-    print_declarations(file, 2, (char**) vecvar, indent);
+    print_declarations(file, 2, (char**) vecvar, NULL,
+                       program_has_long_dims(program), indent);
   }
   
   fprintf(file, "\n");
@@ -507,6 +596,10 @@ static int annotate_loops(osl_scop_p program, struct clast_stmt *root){
         }
       }
 
+      /* The clauses may be asked for loop by loop. */
+      clastloops[j]->parallel |= loop->directive &
+        (CLAST_PARALLEL_COLLAPSE | CLAST_PARALLEL_DYNAMIC | CLAST_PARALLEL_SIMD);
+
       if (loop->directive & CLAST_PARALLEL_USER) {
         clastloops[j]->parallel |= CLAST_PARALLEL_USER;
         ret |= CLAST_PARALLEL_USER;
@@ -524,6 +617,43 @@ static int annotate_loops(osl_scop_p program, struct clast_stmt *root){
 
   return ret;
 }
+
+/*
+* unroll-and-jam the loops with the CLAST_UNROLL_JAM directive in scop's
+* osl_loop extension by options->unroll_jam. Unlike the parallel marks, this
+* changes the loops themselves, so it is also done for callable code.
+*/
+static void unroll_jam_loops(CloogOptions *options, struct clast_stmt *root)
+{
+  int j, nclastloops, nclaststmts, found = 0;
+  struct clast_for **clastloops = NULL;
+  int *claststmts = NULL;
+  osl_loop_p ll;
+
+  if (options->scop == NULL || options->unroll_jam < 2)
+    return;
+
+  ll = osl_generic_lookup(options->scop->extension, OSL_URI_LOOP);
+  for (; ll; ll = ll->next) {
+    if (!(ll->directive & CLAST_UNROLL_JAM))
+      continue;
+
+    ClastFilter filter = { ll->iter, ll->stmt_ids, ll->nb_stmts, subset};
+    clast_filter(root, filter, &clastloops, &nclastloops,
+                 &claststmts, &nclaststmts);
+    if (claststmts) { free(claststmts); claststmts=NULL;}
+
+    for (j = 0; j < nclastloops; j++) {
+      clastloops[j]->unroll_type = clast_unroll_and_jam;
+      clastloops[j]->ufactor = options->unroll_jam;
+      found = 1;
+    }
+    if (clastloops) { free(clastloops); clastloops=NULL;}
+  }
+
+  if (found)
+    clast_unroll_jam(root);
+}
 #endif
 
 #if OSL_SUPPORT
@@ -631,7 +761,10 @@ int cloog_program_osl_pprint(FILE * file, CloogProgram * program,
     /* Generate the clast from the pseudo-AST then pretty-print it. */
     root = cloog_clast_create(program, options);
     annotate_loops(options->scop, root);
-    print_iterator_declarations_osl(file, program, indentation, options);
+    unroll_jam_loops(options, root);
+    if (options->hoist)
+      clast_hoist_bounds(root);
+    print_iterator_declarations_osl(file, program, root, indentation, options);
     clast_pprint(file, root, indentation, options);
     cloog_clast_free(root);
 
@@ -682,7 +815,7 @@ FILE * file ;
 CloogProgram * program ;
 CloogOptions * options ;
 {
-  int i, j, indentation = 0;
+  int i, j, type, first, indentation = 0;
   CloogStatement * statement ;
   CloogBlockList * blocklist ;
   CloogBlock * block ;
@@ -709,6 +842,16 @@ CloogOptions * options ;
 	  options->time,options->memory);
 #endif
   
+  /* The clast is built first, such that the temporaries of the loop bounds
+   * are known when the variables are declared.
+   */
+  root = cloog_clast_create(program, options);
+#ifdef OSL_SUPPORT
+  unroll_jam_loops(options, root);
+#endif
+  if (options->hoist)
+    clast_hoist_bounds(root);
+
   /* If the option "compilable" is set, we provide the whole stuff to generate
    * a compilable code. This code just do nothing, but now the user can edit
    * the source and set the statement macros and parameters values.
@@ -762,14 +905,24 @@ CloogOptions * options ;
     
     /* The iterator and parameter declaration. */
     fprintf(file,"\nint main() {\n") ; 
-    print_iterator_declarations(file, program, options);
+    print_iterator_declarations(file, program, root, options);
     if (program->names->nb_parameters > 0)
     { fprintf(file,"  /* Parameters. */\n") ;
-      fprintf(file, "  int %s=PARVAL1",program->names->parameters[0]);
-      for(i=2;i<=program->names->nb_parameters;i++)
-        fprintf(file, ", %s=PARVAL%d", program->names->parameters[i-1], i);
-      
-      fprintf(file,";\n");
+      for (type = 0; type < 2; type++)
+      { first = 1;
+        for (i = 1; i <= program->names->nb_parameters; i++)
+        { if (program_long_parameter(program, i-1) != type)
+            continue;
+          if (first)
+            fprintf(file, "  %s %s=PARVAL%d", type ? "long long" : "int",
+                    program->names->parameters[i-1], i);
+          else
+            fprintf(file, ", %s=PARVAL%d", program->names->parameters[i-1], i);
+          first = 0;
+        }
+        if (!first)
+          fprintf(file, ";\n");
+      }
     }
     fprintf(file,"  int total=0;\n");
     fprintf(file,"\n") ;
@@ -777,11 +930,10 @@ CloogOptions * options ;
     /* And we adapt the identation. */
     indentation += 2 ;
   } else if (options->callable && program->language == 'c') {
-    print_callable_preamble(file, program, options);
+    print_callable_preamble(file, program, root, options);
     indentation += 2;
   }
   
-  root = cloog_clast_create(program, options);
   clast_pprint(file, root, indentation, options);
   cloog_clast_free(root);
   
@@ -805,14 +957,24 @@ CloogOptions * options ;
  * This function frees the allocated memory for a CloogProgram structure.
  */
 void cloog_program_free(CloogProgram * program)
-{ cloog_names_free(program->names) ;
+{ CloogState *state = NULL;
+
+  if (program->blocklist != NULL && program->blocklist->block != NULL)
+    state = program->blocklist->block->state;
+
+  cloog_names_free(program->names) ;
   cloog_loop_free(program->loop) ;
   cloog_domain_free(program->context) ;
   cloog_block_list_free(program->blocklist) ;
   if (program->scaldims != NULL)
   free(program->scaldims) ;
+  free(program->long_dims);
   
   free(program) ;
+
+  /* Give the node pool back to the system if nothing is left in it. */
+  if (state != NULL)
+    cloog_state_node_pool_release(state);
 }
 
 
@@ -845,6 +1007,13 @@ CloogProgram *cloog_program_alloc(CloogDomain *context, CloogUnionDomain *ud,
   CloogScatteringList * scatteringl;
   CloogNames *n;
   CloogProgram * p ;
+
+  if (options->stats)
+    cloog_state_set_stats(options->state, 1);
+  if (options->node_pool &&
+      cloog_state_set_node_pool(options->state, 1) < 0)
+    cloog_msg(options, CLOOG_WARNING,
+              "nodes alive in the state, -node-pool ignored.\n");
       
   /* Memory allocation for the CloogProgram structure. */
   p = cloog_program_malloc() ;
@@ -919,16 +1088,23 @@ CloogProgram *cloog_program_alloc(CloogDomain *context, CloogUnionDomain *ud,
       p->scaldims[i] = 0 ;
       
       /* We try to find blocks in the input problem to reduce complexity. */
+      cloog_state_phase_start(options->state, CLOOG_PHASE_BLOCK);
       if (!options->noblocks)
 	cloog_program_block(p, scatteringl, options);
       if (!options->noscalars)
 	cloog_program_extract_scalars(p, scatteringl, options);
+      cloog_state_phase_end(options->state, CLOOG_PHASE_BLOCK);
       
+      cloog_state_phase_start(options->state, CLOOG_PHASE_SCATTER);
       cloog_program_scatter(p, scatteringl, options);
+      cloog_state_phase_end(options->state, CLOOG_PHASE_SCATTER);
       cloog_scattering_list_free(scatteringl);
 
       if (!options->noblocks)
+      { cloog_state_phase_start(options->state, CLOOG_PHASE_BLOCK);
 	p->loop = cloog_loop_block(p->loop, p->scaldims, p->nb_scattdims);
+	cloog_state_phase_end(options->state, CLOOG_PHASE_BLOCK);
+      }
     }
     else
     { p->nb_scattdims = 0 ;
@@ -966,7 +1142,12 @@ CloogProgram *cloog_program_read(FILE *file, CloogOptions *options)
   CloogInput *input;
   CloogProgram *p;
 
+  /* Enable the statistics before the first phase, such that it is counted. */
+  if (options->stats)
+    cloog_state_set_stats(options->state, 1);
+  cloog_state_phase_start(options->state, CLOOG_PHASE_READ);
   input = cloog_input_read(file, options);
+  cloog_state_phase_end(options->state, CLOOG_PHASE_READ);
   p = cloog_program_alloc(input->context, input->ud, options);
   free(input);
 
@@ -1002,12 +1183,83 @@ CloogProgram * cloog_program_malloc()
   program->names        = NULL ;
   program->blocklist    = NULL ;
   program->scaldims     = NULL ;
+  program->long_dims    = NULL ;
   program->usr          = NULL;
   
   return program ;
 }  
 
 
+/**
+ * cloog_program_long_dims function:
+ * This function fills the long_dims array of (program) according to the
+ * -iterator-type option. In auto mode, a dimension gets a long long type
+ * unless its constant bounds in the domains of all the statements, restricted
+ * to the context, lie within the range of int; in particular, a dimension
+ * bounded by parameters the context does not bound is long long. The input
+ * domains are used since those of the generated loops are simplified.
+ * A parameter gets a long long type unless the context bounds it within
+ * the range of int. The expressions of the generated code may still widen
+ * some of these types, see cloog_clast_create.
+ */
+static void cloog_program_long_dims(CloogProgram *program,
+				    CloogOptions *options)
+{
+  int i, n, nb_par, dim, has_lower, has_upper;
+  cloog_int_t lower, upper;
+  CloogLoop *loop;
+  CloogDomain *context, *domain;
+
+  free(program->long_dims);
+  program->long_dims = NULL;
+  if ((options->iterator_type == CLOOG_ITERATOR_INT) || !program->names)
+    return;
+
+  n = program->names->nb_scattering + program->names->nb_iterators;
+  nb_par = program->names->nb_parameters;
+  program->long_dims = (int *)malloc((n + nb_par + 1) * sizeof(int));
+  if (program->long_dims == NULL)
+    cloog_die("memory overflow.\n");
+  for (i = 0; i < n + nb_par; i++)
+    program->long_dims[i] = (options->iterator_type == CLOOG_ITERATOR_LONG);
+  if (options->iterator_type == CLOOG_ITERATOR_LONG)
+    return;
+
+  cloog_int_init(lower);
+  cloog_int_init(upper);
+  for (loop = program->loop; loop != NULL; loop = loop->next)
+  { dim = cloog_domain_dimension(loop->domain);
+    context = cloog_domain_extend(program->context, dim);
+    domain = cloog_domain_intersection(loop->domain, context);
+    cloog_domain_free(context);
+    for (i = 0; (i < dim) && (i < n); i++)
+    { if (program->long_dims[i])
+        continue;
+      cloog_domain_level_bounds(domain, i + 1,
+                                &lower, &has_lower, &upper, &has_upper);
+      if (!has_lower || !has_upper ||
+          (cloog_int_cmp_si(lower, INT_MIN) < 0) ||
+          (cloog_int_cmp_si(upper, INT_MAX) > 0))
+        program->long_dims[i] = 1;
+    }
+    cloog_domain_free(domain);
+  }
+
+  context = cloog_domain_from_context(cloog_domain_copy(program->context));
+  for (i = 0; i < nb_par; i++)
+  { cloog_domain_level_bounds(context, i + 1,
+                              &lower, &has_lower, &upper, &has_upper);
+    if (!has_lower || !has_upper ||
+        (cloog_int_cmp_si(lower, INT_MIN) < 0) ||
+        (cloog_int_cmp_si(upper, INT_MAX) > 0))
+      program->long_dims[n + i] = 1;
+  }
+  cloog_domain_free(context);
+  cloog_int_clear(upper);
+  cloog_int_clear(lower);
+}
+
+
 /**
  * cloog_program_generate function:
  * This function calls the Quillere algorithm for loop scanning. (see the
@@ -1078,17 +1330,39 @@ CloogOptions * options ;
     }
   }
   
+  if (options->domain_cache > 0)
+    cloog_state_set_domain_cache(options->state, options->domain_cache);
+
+  if (options->deadline >= 0)
+    options->deadline_start = cloog_util_rtclock() ;
+
 #ifdef CLOOG_RUSAGE
   getrusage(RUSAGE_SELF, &start) ;
 #endif
   if (program->loop != NULL)
   { loop = program->loop ;
+
+    cloog_program_long_dims(program, options);
     
     /* Here we go ! */
     loop = cloog_loop_generate(loop, program->context, 0, 0,
                                program->scaldims,
 			       program->nb_scattdims,
 			       options);
+
+    if (options->nb_degraded > 0)
+    { char depths[MAX_STRING] ;
+      int i, len = 0 ;
+
+      depths[0] = '\0' ;
+      for (i = 0; (i < options->nb_degraded) && (len < MAX_STRING - 16); i++)
+      len += sprintf(depths + len, "%s%d", i ? ", " : "",
+                     options->degraded[i]) ;
+      cloog_msg(options, CLOOG_WARNING,
+      "the deadline of %d ms has been exceeded, loops have been merged\n"
+      "                instead of separated at depth(s) %s.\n",
+      options->deadline, depths) ;
+    }
 			          
 #ifdef CLOOG_MEMORY
     /* We read into the status file of the process how many memory it uses. */
@@ -1100,8 +1374,11 @@ CloogOptions * options ;
 #endif
     
     if ((!options->nosimplify) && (program->loop != NULL))
+    { cloog_state_phase_start(options->state, CLOOG_PHASE_SIMPLIFY);
       loop = cloog_loop_simplify(loop, program->context, 0,
                                  program->nb_scattdims, options);
+      cloog_state_phase_end(options->state, CLOOG_PHASE_SIMPLIFY);
+    }
    
     program->loop = loop ;
   }
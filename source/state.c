@@ -1,12 +1,61 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
 #include "../include/cloog/cloog.h"
 
+static const char *phase_name[CLOOG_NB_PHASES] = {
+  "read", "scatter", "block", "separate", "merge", "sort", "components",
+  "simplify", "clast", "pprint"
+};
+
+static const char *primitive_name[CLOOG_NB_PRIMITIVES] = {
+  "convex", "simple_convex", "simplify", "union", "intersection",
+  "difference", "sort", "follows", "is_bounded", "level_bounds", "isempty",
+  "project", "extend", "never_integral", "is_otl", "stride", "can_stride",
+  "stride_lower_bound", "add_stride_constraint", "lazy_equal",
+  "bound_splitter", "lazy_disjoint", "simplify_union", "lazy_isconstant",
+  "scatter", "can_unroll", "fixed_offset", "minmax_splitter",
+  "full_tiles"
+};
+
+/* Number of nodes allocated at once by a pool. */
+#define CLOOG_POOL_CHUNK 256
+
+/* Nodes and chunks are sized in multiples of this union
+ * such that the nodes are suitably aligned.
+ */
+union cloog_pool_align {
+  void *p;
+  double d;
+  long l;
+};
+
+/* Header of a block of CLOOG_POOL_CHUNK nodes, which follow it. */
+union cloog_pool_chunk {
+  union cloog_pool_chunk *next;
+  union cloog_pool_align align;
+};
+
+/* Pool of nodes of a given size.
+ * "free" is the list of available nodes, linked through their first word.
+ * "live" is the number of nodes handed out and not given back yet.
+ */
+struct cloog_pool {
+  size_t size;
+  void *free;
+  union cloog_pool_chunk *chunks;
+  int live;
+};
+
+static void cloog_pool_free(CloogState *state);
+
 /**
  * Allocate state and initialize backend independent part.
  */
 CloogState *cloog_core_state_malloc(void)
 {
   CloogState *state;
+  int i;
 
   state = (CloogState *)malloc(sizeof(CloogState));
   if (!state) 
@@ -37,6 +86,29 @@ CloogState *cloog_core_state_malloc(void)
   state->statement_freed = 0;
   state->statement_max = 0;
 
+  state->domain_cache_hits = 0;
+  state->domain_cache_misses = 0;
+
+  state->components_edges = 0;
+  state->components_tests = 0;
+  state->components_avoided = 0;
+
+  for (i = 0; i < CLOOG_NB_PHASES; i++) {
+    state->stats.phase_calls[i] = 0;
+    state->stats.phase_time[i] = 0;
+    state->phase_depth[i] = 0;
+    state->phase_start[i] = 0;
+  }
+  for (i = 0; i < CLOOG_NB_PRIMITIVES; i++)
+    state->stats.primitive_calls[i] = 0;
+  state->stats_enabled = 0;
+
+  state->trace = NULL;
+  state->trace_events = 0;
+  state->trace_start = 0;
+
+  state->pool = NULL;
+
   return state;
 }
 
@@ -45,8 +117,323 @@ CloogState *cloog_core_state_malloc(void)
  */
 void cloog_core_state_free(CloogState *state)
 {
+  cloog_state_set_trace(state, NULL);
+  cloog_pool_free(state);
   cloog_int_clear(state->zero);
   cloog_int_clear(state->one);
   cloog_int_clear(state->negone);
   free(state);
 }
+
+
+/**
+ * Record the entry into phase "phase".  Only the outermost of nested
+ * entries into the same phase is timed.  Nothing is recorded, and the
+ * clock is not read, unless the statistics are enabled or a trace is
+ * written.
+ */
+void cloog_state_phase_start(CloogState *state, enum cloog_phase phase)
+{
+  if (!state->stats_enabled && !state->trace)
+    return;
+  state->stats.phase_calls[phase]++;
+  if (state->phase_depth[phase]++ == 0)
+    state->phase_start[phase] = cloog_util_rtclock();
+  cloog_state_trace_begin(state, phase_name[phase], NULL);
+}
+
+/**
+ * Record the exit from phase "phase", unless its entry was not recorded.
+ */
+void cloog_state_phase_end(CloogState *state, enum cloog_phase phase)
+{
+  if (!state->phase_depth[phase])
+    return;
+  cloog_state_trace_end(state, phase_name[phase]);
+  if (--state->phase_depth[phase] == 0)
+    state->stats.phase_time[phase] += cloog_util_rtclock() -
+				      state->phase_start[phase];
+}
+
+/**
+ * Make "state" count the calls to the domain primitives in its statistics
+ * if "enable" is set, see cloog_state_get_stats.  The calls are not
+ * counted by default.
+ */
+void cloog_state_set_stats(CloogState *state, int enable)
+{
+  state->stats_enabled = enable;
+}
+
+/**
+ * Return the statistics collected so far in "state".
+ */
+const CloogStats *cloog_state_get_stats(CloogState *state)
+{
+  return &state->stats;
+}
+
+const char *cloog_phase_name(enum cloog_phase phase)
+{
+  return phase_name[phase];
+}
+
+const char *cloog_primitive_name(enum cloog_primitive primitive)
+{
+  return primitive_name[primitive];
+}
+
+/**
+ * Print the statistics collected in "state" to "file" as a JSON object.
+ */
+void cloog_state_print_stats_json(FILE *file, CloogState *state)
+{
+  int i;
+
+  fprintf(file, "{\n  \"phases\": {");
+  for (i = 0; i < CLOOG_NB_PHASES; i++)
+    fprintf(file, "%s\n    \"%s\": { \"calls\": %d, \"time\": %.6f }",
+	    i ? "," : "", phase_name[i], state->stats.phase_calls[i],
+	    state->stats.phase_time[i]);
+  fprintf(file, "\n  },\n  \"primitives\": {");
+  for (i = 0; i < CLOOG_NB_PRIMITIVES; i++)
+    fprintf(file, "%s\n    \"%s\": %d", i ? "," : "", primitive_name[i],
+	    state->stats.primitive_calls[i]);
+  fprintf(file, "\n  },\n");
+  fprintf(file, "  \"domain_cache\": { \"hits\": %d, \"misses\": %d },\n",
+	  state->domain_cache_hits, state->domain_cache_misses);
+  fprintf(file, "  \"components\": { \"edges\": %d, \"tests\": %d, "
+	  "\"avoided\": %d },\n", state->components_edges,
+	  state->components_tests, state->components_avoided);
+  fprintf(file, "  \"allocations\": { \"domains\": %d, \"loops\": %d, "
+	  "\"statements\": %d, \"blocks\": %d }\n}\n",
+	  state->domain_allocated, state->loop_allocated,
+	  state->statement_allocated, state->block_allocated);
+}
+
+
+/**
+ * Write the events of the phases and of the generation recursion to "file"
+ * in the Chrome trace event format, such that they can be inspected in
+ * chrome://tracing or Perfetto.  The state takes ownership of "file"
+ * and closes it when it is freed or when another file (or NULL) is set.
+ */
+void cloog_state_set_trace(CloogState *state, FILE *file)
+{
+  if (state->trace) {
+    fprintf(state->trace, "\n]\n");
+    fclose(state->trace);
+  }
+
+  state->trace = file;
+  state->trace_events = 0;
+  state->trace_start = cloog_util_rtclock();
+  if (file)
+    fprintf(file, "[");
+}
+
+static void cloog_state_trace_event(CloogState *state, const char *name,
+				    char ph)
+{
+  fprintf(state->trace, "%s\n{ \"name\": \"%s\", \"ph\": \"%c\", "
+	  "\"ts\": %.0f, \"pid\": 1, \"tid\": 1",
+	  state->trace_events++ ? "," : "", name, ph,
+	  (cloog_util_rtclock() - state->trace_start) * 1e6);
+}
+
+/**
+ * Open a span called "name" in the trace of "state", if any.
+ * If "format" is not NULL, it is a printf format of the members
+ * of the JSON object given as arguments of the span,
+ * e.g., "\"level\": %d".
+ */
+void cloog_state_trace_begin(CloogState *state, const char *name,
+			     const char *format, ...)
+{
+  va_list args;
+
+  if (!state->trace)
+    return;
+
+  cloog_state_trace_event(state, name, 'B');
+  if (format) {
+    fprintf(state->trace, ", \"args\": { ");
+    va_start(args, format);
+    vfprintf(state->trace, format, args);
+    va_end(args);
+    fprintf(state->trace, " }");
+  }
+  fprintf(state->trace, " }");
+}
+
+/**
+ * Close the innermost open span, called "name", in the trace of "state".
+ */
+void cloog_state_trace_end(CloogState *state, const char *name)
+{
+  if (!state->trace)
+    return;
+
+  cloog_state_trace_event(state, name, 'E');
+  fprintf(state->trace, " }");
+}
+
+
+/**
+ * Return the memory of the chunks of the pools of "state" to the system
+ * and disable the pools.
+ */
+static void cloog_pool_free(CloogState *state)
+{
+  int i;
+  union cloog_pool_chunk *chunk, *next;
+
+  if (!state->pool)
+    return;
+
+  for (i = 0; i < CLOOG_NB_NODES; i++)
+    for (chunk = state->pool[i].chunks; chunk; chunk = next) {
+      next = chunk->next;
+      free(chunk);
+    }
+  free(state->pool);
+  state->pool = NULL;
+}
+
+/**
+ * Allocate the CloogLoop, CloogBlock and CloogStatement structures of
+ * "state" from freelists of fixed-size nodes, carved out of large chunks,
+ * if "use" is set, or with malloc otherwise.  The pools are not thread-safe.
+ * This choice can only be changed while no such structure is alive:
+ * return -1 and leave the allocation unchanged otherwise, 0 on success.
+ */
+int cloog_state_set_node_pool(CloogState *state, int use)
+{
+  int i;
+
+  if ((use != 0) == (state->pool != NULL))
+    return 0;
+
+  if ((state->loop_allocated != state->loop_freed) ||
+      (state->block_allocated != state->block_freed) ||
+      (state->statement_allocated != state->statement_freed))
+    return -1;
+
+  if (!use) {
+    cloog_pool_free(state);
+    return 0;
+  }
+
+  state->pool = (struct cloog_pool *)malloc(CLOOG_NB_NODES *
+					    sizeof(struct cloog_pool));
+  if (!state->pool)
+    cloog_die("memory overflow.\n");
+  for (i = 0; i < CLOOG_NB_NODES; i++) {
+    state->pool[i].size = 0;
+    state->pool[i].free = NULL;
+    state->pool[i].chunks = NULL;
+    state->pool[i].live = 0;
+  }
+  return 0;
+}
+
+/**
+ * Add a chunk of CLOOG_POOL_CHUNK nodes of "size" bytes to the free list
+ * of "pool".
+ */
+static void cloog_pool_grow(struct cloog_pool *pool, size_t size)
+{
+  int i;
+  char *node;
+  union cloog_pool_chunk *chunk;
+
+  if (!pool->size) {
+    size_t align = sizeof(union cloog_pool_align);
+    pool->size = (size + align - 1) / align * align;
+  }
+
+  chunk = (union cloog_pool_chunk *)malloc(sizeof(union cloog_pool_chunk) +
+					   CLOOG_POOL_CHUNK * pool->size);
+  if (!chunk)
+    cloog_die("memory overflow.\n");
+  chunk->next = pool->chunks;
+  pool->chunks = chunk;
+
+  node = (char *)(chunk + 1);
+  for (i = 0; i < CLOOG_POOL_CHUNK; i++, node += pool->size) {
+    *(void **)node = pool->free;
+    pool->free = node;
+  }
+}
+
+/**
+ * Allocate a structure of kind "kind" and of "size" bytes in "state".
+ */
+void *cloog_state_node_alloc(CloogState *state, enum cloog_node kind,
+			     size_t size)
+{
+  struct cloog_pool *pool;
+  void *node;
+
+  if (!state->pool) {
+    node = malloc(size);
+    if (!node)
+      cloog_die("memory overflow.\n");
+    return node;
+  }
+
+  pool = &state->pool[kind];
+  if (!pool->free)
+    cloog_pool_grow(pool, size);
+  node = pool->free;
+  pool->free = *(void **)node;
+  pool->live++;
+
+  return node;
+}
+
+/**
+ * Give back structure "node" of kind "kind", allocated by
+ * cloog_state_node_alloc in "state".
+ */
+void cloog_state_node_free(CloogState *state, enum cloog_node kind,
+			   void *node)
+{
+  struct cloog_pool *pool;
+
+  if (!state->pool) {
+    free(node);
+    return;
+  }
+
+  pool = &state->pool[kind];
+  *(void **)node = pool->free;
+  pool->free = node;
+  pool->live--;
+}
+
+/**
+ * Return the chunks of the pools of "state" to the system in one go if
+ * none of their nodes is alive anymore.  The pools stay enabled.
+ */
+void cloog_state_node_pool_release(CloogState *state)
+{
+  int i;
+  union cloog_pool_chunk *chunk, *next;
+
+  if (!state->pool)
+    return;
+
+  for (i = 0; i < CLOOG_NB_NODES; i++)
+    if (state->pool[i].live)
+      return;
+
+  for (i = 0; i < CLOOG_NB_NODES; i++) {
+    for (chunk = state->pool[i].chunks; chunk; chunk = next) {
+      next = chunk->next;
+      free(chunk);
+    }
+    state->pool[i].chunks = NULL;
+    state->pool[i].free = NULL;
+  }
+}
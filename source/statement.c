@@ -153,7 +153,7 @@ void cloog_statement_free(CloogStatement * statement)
     next = statement->next ;
     /* free(statement->usr) ; Actually, this is user's job ! */
     free(statement->name);
-    free(statement) ;
+    cloog_state_node_free(statement->state, CLOOG_NODE_STATEMENT, statement);
     statement = next ;
   }
 }
@@ -175,9 +175,8 @@ CloogStatement *cloog_statement_malloc(CloogState *state)
 { CloogStatement * statement ;
   
   /* Memory allocation for the CloogStatement structure. */
-  statement = (CloogStatement *)malloc(sizeof(CloogStatement)) ;
-  if (statement == NULL) 
-    cloog_die("memory overflow.\n");
+  statement = (CloogStatement *)cloog_state_node_alloc(state,
+				CLOOG_NODE_STATEMENT, sizeof(CloogStatement));
   cloog_statement_leak_up(state);
   
   /* We set the various fields with default values. */
@@ -233,9 +232,8 @@ CloogStatement * cloog_statement_copy(CloogStatement * source)
   while (source != NULL) {
     cloog_statement_leak_up(source->state);
 
-    temp = (CloogStatement *)malloc(sizeof(CloogStatement)) ;
-    if (temp == NULL)
-      cloog_die("memory overflow.\n");
+    temp = (CloogStatement *)cloog_state_node_alloc(source->state,
+				CLOOG_NODE_STATEMENT, sizeof(CloogStatement));
     
     temp->state  = source->state;
     temp->number = source->number ;
@@ -0,0 +1,71 @@
+#!/bin/sh
+#
+#   /**-------------------------------------------------------------------**
+#    **                              CLooG                                **
+#    **-------------------------------------------------------------------**
+#    **                        check_clean.sh                             **
+#    **-------------------------------------------------------------------**
+#    **                 First version: October 17th 2026                  **
+#    **-------------------------------------------------------------------**/
+#
+
+#/*****************************************************************************
+# *               CLooG : the Chunky Loop Generator (experimental)            *
+# *****************************************************************************
+# *                                                                           *
+# * Copyright (C) 2003 Cedric Bastoul                                         *
+# *                                                                           *
+# * This library is free software; you can redistribute it and/or             *
+# * modify it under the terms of the GNU Lesser General Public                *
+# * License as published by the Free Software Foundation; either              *
+# * version 2.1 of the License, or (at your option) any later version.        *
+# *                                                                           *
+# * This library is distributed in the hope that it will be useful,           *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+# * Lesser General Public License for more details.                           *
+# *                                                                           *
+# * You should have received a copy of the GNU Lesser General Public          *
+# * License along with this library; if not, write to the Free Software       *
+# * Foundation, Inc., 51 Franklin Street, Fifth Floor,                        *
+# * Boston, MA  02110-1301  USA                                               *
+# *                                                                           *
+# * CLooG, the Chunky Loop Generator                                          *
+# * Written by Cedric Bastoul, Cedric.Bastoul@inria.fr                        *
+# *                                                                           *
+# *****************************************************************************/
+
+
+# Clean exit test: cloog is run quietly on each input of CLEAN_OPTIONS
+# (a list of 'input options' entries, like SPECIAL_OPTIONS) and must not
+# write anything on the standard error.  In particular, isl reports the
+# objects still referenced when the context is freed, so this catches the
+# sets leaked on the paths that only some options take.
+
+# The list is refactored as in check_special.sh.
+clean_refactored=`echo "$CLEAN_OPTIONS" | \
+                  sed "s/'  *'/#/g"     | \
+                  sed 's/ /%/g'         | \
+                  sed "s/#/ /g"         | \
+                  sed "s/'//g"`
+
+cloog="${top_builddir}/cloog${EXEXT}"
+errors="cloog_clean_$$.err"
+failed=0
+
+for x in $clean_refactored; do
+  name=`echo $x | sed 's/%/ /g' | cut -d\  -f1`
+  options=`echo $x | sed 's/%/ /g' | cut -s -d\  -f2-`
+  "${cloog}" -q $options "${srcdir}/${name}.cloog" > /dev/null 2> "${errors}"
+  status=$?
+  if [ $status -ne 0 ] || [ -s "${errors}" ]; then
+    echo "FAIL: ${name} ($options) exited with status $status:"
+    cat "${errors}"
+    failed=1
+  else
+    echo "PASS: ${name} ($options)"
+  fi
+done
+rm -f "${errors}"
+
+exit $failed
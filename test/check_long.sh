@@ -0,0 +1,82 @@
+#!/bin/sh
+#
+#   /**-------------------------------------------------------------------**
+#    **                              CLooG                                **
+#    **-------------------------------------------------------------------**
+#    **                        check_long.sh                              **
+#    **-------------------------------------------------------------------**
+#    **                 First version: October 17th 2026                  **
+#    **-------------------------------------------------------------------**/
+#
+
+#/*****************************************************************************
+# *               CLooG : the Chunky Loop Generator (experimental)            *
+# *****************************************************************************
+# *                                                                           *
+# * Copyright (C) 2003 Cedric Bastoul                                         *
+# *                                                                           *
+# * This library is free software; you can redistribute it and/or             *
+# * modify it under the terms of the GNU Lesser General Public                *
+# * License as published by the Free Software Foundation; either              *
+# * version 2.1 of the License, or (at your option) any later version.        *
+# *                                                                           *
+# * This library is distributed in the hope that it will be useful,           *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+# * Lesser General Public License for more details.                           *
+# *                                                                           *
+# * You should have received a copy of the GNU Lesser General Public          *
+# * License along with this library; if not, write to the Free Software       *
+# * Foundation, Inc., 51 Franklin Street, Fifth Floor,                        *
+# * Boston, MA  02110-1301  USA                                               *
+# *                                                                           *
+# * CLooG, the Chunky Loop Generator                                          *
+# * Written by Cedric Bastoul, Cedric.Bastoul@inria.fr                        *
+# *                                                                           *
+# *****************************************************************************/
+
+# Stress test for very long statement lists: the input has 100000
+# statements, each one on its own value of a single scattering dimension,
+# such that code generation has to handle 100000 sibling loops. It runs
+# with a small stack, which only suffices if the sibling lists are walked
+# iteratively, and checks that every statement is generated.  Blocking is
+# disabled since each pair of consecutive statements would then be checked
+# against the whole scattering for injectivity, which is quadratic.
+
+readonly LONG_STATEMENTS=100000
+readonly LONG_STACK=1024
+
+cloog="${top_builddir}/cloog${EXEXT}"
+input="cloog_long_$$.cloog"
+output="cloog_long_$$.c"
+
+awk -v n="${LONG_STATEMENTS}" 'BEGIN {
+  print "c\n\n0 2\n0\n\n" n;
+  for (i = 1; i <= n; i++)
+    print "1\n0 2\n0 0 0\n";
+  print "0\n\n" n;
+  for (i = 1; i <= n; i++)
+    print "1 3\n0 -1 " i "\n";
+  print "0";
+}' > "${input}"
+
+(ulimit -s "${LONG_STACK}" 2>/dev/null;
+ "${cloog}" -q -noblocks "${input}" -o "${output}")
+status=$?
+
+generated=0
+if [ $status -eq 0 ]; then
+  generated=`grep -c 'S[0-9]*()' "${output}"`
+fi
+rm -f "${input}" "${output}"
+
+if [ $status -ne 0 ]; then
+  echo "FAIL: cloog exited with status $status on $LONG_STATEMENTS statements"
+  exit 1
+fi
+if [ "$generated" -ne "$LONG_STATEMENTS" ]; then
+  echo "FAIL: $generated statements generated instead of $LONG_STATEMENTS"
+  exit 1
+fi
+echo "PASS: $LONG_STATEMENTS statements"
+exit 0
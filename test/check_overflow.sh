@@ -0,0 +1,95 @@
+#!/bin/sh
+#
+#   /**-------------------------------------------------------------------**
+#    **                              CLooG                                **
+#    **-------------------------------------------------------------------**
+#    **                        check_overflow.sh                          **
+#    **-------------------------------------------------------------------**
+#    **                 First version: October 17th 2026                  **
+#    **-------------------------------------------------------------------**/
+#
+
+#/*****************************************************************************
+# *               CLooG : the Chunky Loop Generator (experimental)            *
+# *****************************************************************************
+# *                                                                           *
+# * Copyright (C) 2003 Cedric Bastoul                                         *
+# *                                                                           *
+# * This library is free software; you can redistribute it and/or             *
+# * modify it under the terms of the GNU Lesser General Public                *
+# * License as published by the Free Software Foundation; either              *
+# * version 2.1 of the License, or (at your option) any later version.        *
+# *                                                                           *
+# * This library is distributed in the hope that it will be useful,           *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+# * Lesser General Public License for more details.                           *
+# *                                                                           *
+# * You should have received a copy of the GNU Lesser General Public          *
+# * License along with this library; if not, write to the Free Software       *
+# * Foundation, Inc., 51 Franklin Street, Fifth Floor,                        *
+# * Boston, MA  02110-1301  USA                                               *
+# *                                                                           *
+# * CLooG, the Chunky Loop Generator                                          *
+# * Written by Cedric Bastoul, Cedric.Bastoul@inria.fr                        *
+# *                                                                           *
+# *****************************************************************************/
+
+# Overflow test: the scattering of test/overflow.cloog takes values that
+# do not fit in 64 bits.  With --with-cloog-int=checked, cloog must stop
+# with the exit status reserved for overflows (CLOOG_INT_OVERFLOW_STATUS).
+# The input is then processed again by the cloog given in CLOOG_GMP, if
+# any, as a driver would do.  With GMP, the output must match
+# test/overflow.c.  The other integer types do not detect overflows.
+
+readonly OVERFLOW_STATUS=3
+
+cloog="${top_builddir}/cloog${EXEXT}"
+input="${srcdir}/test/overflow.cloog"
+expected="${srcdir}/test/overflow.c"
+output="cloog_overflow_$$.c"
+
+bits=`"${cloog}" -v 2>&1 | sed -n 's/.* \([a-z]*\) bits.*/\1/p'`
+
+case "$bits" in
+checked)
+  "${cloog}" -q "${input}" -o "${output}" 2>/dev/null
+  status=$?
+  if [ $status -ne $OVERFLOW_STATUS ]; then
+    rm -f "${output}"
+    echo "FAIL: cloog exited with status $status instead of $OVERFLOW_STATUS"
+    exit 1
+  fi
+  if [ -z "${CLOOG_GMP}" ]; then
+    rm -f "${output}"
+    echo "PASS: overflow detected"
+    exit 0
+  fi
+  "${CLOOG_GMP}" -q "${input}" -o "${output}"
+  status=$?
+  ;;
+gmp)
+  "${cloog}" -q "${input}" -o "${output}"
+  status=$?
+  ;;
+*)
+  echo "SKIP: $bits integers do not detect overflows"
+  exit 77
+  ;;
+esac
+
+if [ $status -ne 0 ]; then
+  rm -f "${output}"
+  echo "FAIL: cloog exited with status $status"
+  exit 1
+fi
+grep -v "Generated from" "${output}" > "${output}.out"
+grep -v "Generated from" "${expected}" | diff - "${output}.out"
+status=$?
+rm -f "${output}" "${output}.out"
+if [ $status -ne 0 ]; then
+  echo "FAIL: output differs from ${expected}"
+  exit 1
+fi
+echo "PASS: overflow"
+exit 0
@@ -0,0 +1,79 @@
+#!/bin/sh
+#
+#   /**-------------------------------------------------------------------**
+#    **                              CLooG                                **
+#    **-------------------------------------------------------------------**
+#    **                        check_same.sh                              **
+#    **-------------------------------------------------------------------**
+#    **                 First version: October 17th 2026                  **
+#    **-------------------------------------------------------------------**/
+#
+
+#/*****************************************************************************
+# *               CLooG : the Chunky Loop Generator (experimental)            *
+# *****************************************************************************
+# *                                                                           *
+# * Copyright (C) 2003 Cedric Bastoul                                         *
+# *                                                                           *
+# * This library is free software; you can redistribute it and/or             *
+# * modify it under the terms of the GNU Lesser General Public                *
+# * License as published by the Free Software Foundation; either              *
+# * version 2.1 of the License, or (at your option) any later version.        *
+# *                                                                           *
+# * This library is distributed in the hope that it will be useful,           *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+# * Lesser General Public License for more details.                           *
+# *                                                                           *
+# * You should have received a copy of the GNU Lesser General Public          *
+# * License along with this library; if not, write to the Free Software       *
+# * Foundation, Inc., 51 Franklin Street, Fifth Floor,                        *
+# * Boston, MA  02110-1301  USA                                               *
+# *                                                                           *
+# * CLooG, the Chunky Loop Generator                                          *
+# * Written by Cedric Bastoul, Cedric.Bastoul@inria.fr                        *
+# *                                                                           *
+# *****************************************************************************/
+
+
+
+# Same output test: cloog is run on each input of SAME_OPTIONS (a list of
+# 'input options' entries, like SPECIAL_OPTIONS) with and without the
+# options, which must not change the generated code.  This checks the
+# options that only change how the code is generated, such as caches or
+# allocators.  The first line, with the generation time, is ignored.
+
+# The list is refactored as in check_special.sh.
+same_refactored=`echo "$SAME_OPTIONS" | \
+                 sed "s/'  *'/#/g"    | \
+                 sed 's/ /%/g'        | \
+                 sed "s/#/ /g"        | \
+                 sed "s/'//g"`
+
+cloog="${top_builddir}/cloog${EXEXT}"
+plain="cloog_same_$$.c"
+optioned="cloog_same_$$.opt.c"
+failed=0
+
+for x in $same_refactored; do
+  name=`echo $x | sed 's/%/ /g' | cut -d\  -f1`
+  options=`echo $x | sed 's/%/ /g' | cut -s -d\  -f2-`
+  "${cloog}" "${srcdir}/${name}.cloog" > "${plain}" && \
+  "${cloog}" $options "${srcdir}/${name}.cloog" > "${optioned}"
+  status=$?
+  if [ $status -ne 0 ]; then
+    echo "FAIL: ${name} ($options) exited with status $status"
+    failed=1
+  elif sed 1d "${plain}" > "${plain}.body" && \
+       sed 1d "${optioned}" > "${optioned}.body" && \
+       cmp -s "${plain}.body" "${optioned}.body"; then
+    echo "PASS: ${name} ($options)"
+  else
+    echo "FAIL: ${name} ($options) changes the generated code:"
+    diff "${plain}.body" "${optioned}.body"
+    failed=1
+  fi
+done
+rm -f "${plain}" "${optioned}" "${plain}.body" "${optioned}.body"
+
+exit $failed
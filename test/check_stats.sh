@@ -0,0 +1,85 @@
+#!/bin/sh
+#
+#   /**-------------------------------------------------------------------**
+#    **                              CLooG                                **
+#    **-------------------------------------------------------------------**
+#    **                        check_stats.sh                             **
+#    **-------------------------------------------------------------------**
+#    **                 First version: October 17th 2026                  **
+#    **-------------------------------------------------------------------**/
+#
+
+#/*****************************************************************************
+# *               CLooG : the Chunky Loop Generator (experimental)            *
+# *****************************************************************************
+# *                                                                           *
+# * Copyright (C) 2003 Cedric Bastoul                                         *
+# *                                                                           *
+# * This library is free software; you can redistribute it and/or             *
+# * modify it under the terms of the GNU Lesser General Public                *
+# * License as published by the Free Software Foundation; either              *
+# * version 2.1 of the License, or (at your option) any later version.        *
+# *                                                                           *
+# * This library is distributed in the hope that it will be useful,           *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+# * Lesser General Public License for more details.                           *
+# *                                                                           *
+# * You should have received a copy of the GNU Lesser General Public          *
+# * License along with this library; if not, write to the Free Software       *
+# * Foundation, Inc., 51 Franklin Street, Fifth Floor,                        *
+# * Boston, MA  02110-1301  USA                                               *
+# *                                                                           *
+# * CLooG, the Chunky Loop Generator                                          *
+# * Written by Cedric Bastoul, Cedric.Bastoul@inria.fr                        *
+# *                                                                           *
+# *****************************************************************************/
+
+
+# Statistics test: cloog is run with -stats json and -trace on each input
+# of STATS_TESTS.  The statistics, printed on stderr, must be a JSON object
+# with the phases and the primitives, and the trace a JSON array of events
+# in which every phase that begins ends, in order.  The check needs
+# python3, the test is skipped without it.
+
+if ! command -v python3 >/dev/null 2>&1; then
+  echo "SKIP: python3 is needed to parse the statistics"
+  exit 77
+fi
+
+cloog="${top_builddir}/cloog${EXEXT}"
+stats="cloog_stats_$$.json"
+trace="cloog_trace_$$.json"
+failed=0
+
+for name in $STATS_TESTS; do
+  "${cloog}" -q -stats json -trace "${trace}" "${srcdir}/${name}.cloog" \
+    2> "${stats}" > /dev/null
+  status=$?
+  if [ $status -ne 0 ]; then
+    echo "FAIL: ${name} exited with status $status"
+    failed=1
+  elif python3 - "${stats}" "${trace}" <<'PYTHON'
+import json, sys
+stats = json.load(open(sys.argv[1]))
+assert "phases" in stats and "primitives" in stats
+for phase in stats["phases"].values():
+    assert phase["calls"] >= 0 and phase["time"] >= 0
+open_events = []
+for event in json.load(open(sys.argv[2])):
+    if event["ph"] == "B":
+        open_events.append(event["name"])
+    elif event["ph"] == "E":
+        assert open_events.pop() == event["name"]
+assert not open_events
+PYTHON
+  then
+    echo "PASS: ${name}"
+  else
+    echo "FAIL: ${name} prints statistics or a trace that do not parse"
+    failed=1
+  fi
+done
+rm -f "${stats}" "${trace}"
+
+exit $failed
@@ -0,0 +1,17 @@
+/* Generated from ./deadline.cloog by CLooG 0.20.0-390b8b9 gmp bits in 0.00s. */
+if (n >= 2) {
+  for (c1=1;c1<=n;c1++) {
+    if (c1 >= 2) {
+      for (c2=2;c2<=n;c2++) {
+        for (i=1;i<=min(c1-1,c2-1);i++) {
+          S2(i,c2,c1);
+        }
+      }
+    }
+    if (c1 <= n-1) {
+      for (j=c1+1;j<=n;j++) {
+        S1(c1,j);
+      }
+    }
+  }
+}
@@ -0,0 +1,12 @@
+/* Generated from ../test/full-tiles.cloog by CLooG 0.20.0-4cd9074 gmp bits in 0.00s. */
+for (ii=0;ii<=floord(n-9,10);ii++) {
+  for (i=10*ii;i<=10*ii+9;i++) {
+    S1(ii,i);
+  }
+}
+if (n%10 <= 8) {
+  ii = floord(n,10);
+  for (i=10*ii;i<=n;i++) {
+    S1(ii,i);
+  }
+}
@@ -0,0 +1,16 @@
+/* Generated from test/full-tiles2.cloog by CLooG 0.20.0-9b66e41 gmp bits in 0.00s. */
+for (ii=0;ii<=floord(n-9,10);ii++) {
+  for (i=10*ii;i<=10*ii+9;i++) {
+    for (k=0;k<=m;k++) {
+      S1(ii,i,k);
+    }
+  }
+}
+if (n%10 <= 8) {
+  ii = floord(n,10);
+  for (i=10*ii;i<=n;i++) {
+    for (k=0;k<=m;k++) {
+      S1(ii,i,k);
+    }
+  }
+}
@@ -0,0 +1,37 @@
+/* Generated from test/full-tiles2.cloog by CLooG 0.20.0-9b66e41 gmp bits in 0.00s. */
+extern void hash(int);
+
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+#define S1(ii,i,k) { hash(1); hash(ii); hash(i); hash(k); }
+
+void test(int n, int m)
+{
+  /* Original iterators. */
+  int ii, i, k;
+  for (ii=0;ii<=floord(n-9,10);ii++) {
+    for (i=10*ii;i<=10*ii+9;i++) {
+      for (k=0;k<=m;k++) {
+        S1(ii,i,k);
+      }
+    }
+  }
+  if (n%10 <= 8) {
+    ii = floord(n,10);
+    for (i=10*ii;i<=n;i++) {
+      for (k=0;k<=m;k++) {
+        S1(ii,i,k);
+      }
+    }
+  }
+}
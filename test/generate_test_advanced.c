@@ -806,39 +806,51 @@ static void print_statement_macro(FILE *out, struct bounds *bounds){
   for (i = 0; i < bounds->names.nb_names; ++i) {
     if(i != 0)
       fprintf(out, ", ");
-    fprintf(out, "%%d");
+    fprintf(out, "%%lld");
   }
   fprintf(out, ")\\n\"");
   for (i = 0; i < bounds->names.nb_names; ++i) {
     fprintf(out, ", ");
-    fprintf(out, "p%u", i);
+    fprintf(out, "(long long) p%u", i);
   }
   fprintf(out, ");\\\n");
   fprintf(out, "exit(2);\\\n} } while(0)\n");
 }
 
-static void print_good_test_declaration(FILE *out, struct bounds *bounds){
+/* Type of the parameter "i" in the code generated for "program". */
+static const char *parameter_type(CloogProgram *program, unsigned i){
+  CloogNames *names = program->names;
+  if (program->long_dims &&
+      program->long_dims[names->nb_scattering + names->nb_iterators + i])
+    return "long long";
+  return "int";
+}
+
+static void print_good_test_declaration(FILE *out, struct bounds *bounds,
+    CloogProgram *program){
   unsigned int i;
   fprintf(out, "void test(");
   for (i = 0; i < bounds->names.nb_names; ++i) {
     if(i)
       fprintf(out, ", ");
-    fprintf(out, "int p%u", i);
+    fprintf(out, "%s p%u", parameter_type(program, i), i);
   }
   fprintf(out, ");\n");
   fprintf(out, "void good(");
   for (i = 0; i < bounds->names.nb_names; ++i) {
     if(i)
       fprintf(out, ", ");
-    fprintf(out, "int p%u", i);
+    fprintf(out, "%s p%u", parameter_type(program, i), i);
   }
   fprintf(out, ");\n\n");
 }
 
-static void fprint_cloog_program_parameters_decl(FILE *out, CloogProgram *p){
+static void fprint_cloog_program_parameters_decl(FILE *out, CloogProgram *p,
+    CloogProgram *program){
   int i;
   for (i = 0; i < p->names->nb_iterators; ++i){
-    fprintf(out, "int %s;\n", p->names->iterators[i]);
+    fprintf(out, "%s %s;\n", parameter_type(program, i),
+        p->names->iterators[i]);
   }
 }
 
@@ -1083,13 +1095,13 @@ int main(int argc, char **argv) {
   p = cloog_program_generate(p, new_options);
 
   fprintf(output_file, "%s", preamble1);
-  print_good_test_declaration(output_file, param_bounds);
+  print_good_test_declaration(output_file, param_bounds, program);
   fprintf(output_file, "%s", preamble2);
   print_statement_macro(output_file, param_bounds);
   fprintf(output_file, "h_good = %s;\n", initial_hash_value);
   fprintf(output_file, "h_test = %s;\n", initial_hash_value);
   print_macros(output_file);
-  fprint_cloog_program_parameters_decl(output_file, p);
+  fprint_cloog_program_parameters_decl(output_file, p, program);
   cloog_program_pprint(output_file, p, new_options);
   fprintf(output_file, "if (h_good == %s) {\n", initial_hash_value);
   fprintf(output_file, "%s", postamble);
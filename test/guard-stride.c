@@ -0,0 +1,9 @@
+/* Generated from ../test/guard-stride.cloog by CLooG 0.20.0-2c8b0ac gmp bits in 0.00s. */
+S2(2,0);
+for (i=5;i<=3*n+2;i+=3) {
+  S1(i,((i-2)/3));
+  S2(i,((i-2)/3));
+}
+for (i=3*n+5;i<=6*n+2;i+=3) {
+  S2(i,((i-2)/3));
+}
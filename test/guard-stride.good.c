@@ -0,0 +1,31 @@
+/* Generated from ../test/guard-stride.cloog by CLooG 0.20.0-2c8b0ac gmp bits in 0.00s. */
+extern void hash(int);
+
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+#define S1(i,j) { hash(1); hash(i); hash(j); }
+#define S2(i,j) { hash(2); hash(i); hash(j); }
+
+void test(int n)
+{
+  /* Original iterators. */
+  int i, j;
+  S2(2,0);
+  for (i=5;i<=3*n+2;i+=3) {
+    S1(i,((i-2)/3));
+    S2(i,((i-2)/3));
+  }
+  for (i=3*n+5;i<=6*n+2;i+=3) {
+    S2(i,((i-2)/3));
+  }
+}
@@ -0,0 +1,6 @@
+/* Generated from ../test/iterator-type.cloog by CLooG 0.20.0-965fcd7 gmp bits in 0.00s. */
+for (ii=0;ii<=floord(n,10);ii++) {
+  for (i=10*ii;i<=min(n,10*ii+9);i++) {
+    S1(ii,i);
+  }
+}
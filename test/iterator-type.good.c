@@ -0,0 +1,27 @@
+/* Generated from ../test/iterator-type.cloog by CLooG 0.20.0-965fcd7 gmp bits in 0.00s. */
+extern void hash(int);
+
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+#define S1(ii,i) { hash(1); hash(ii); hash(ii >> 32); hash(i); hash(i >> 32); }
+
+void test(long long n)
+{
+  /* Original iterators. */
+  long long ii, i;
+  for (ii=0;ii<=floord(n,10);ii++) {
+    for (i=10*ii;i<=min(n,10*ii+9);i++) {
+      S1(ii,i);
+    }
+  }
+}
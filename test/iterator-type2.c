@@ -0,0 +1,6 @@
+/* Generated from ../test/iterator-type2.cloog by CLooG 0.20.0-965fcd7 gmp bits in 0.00s. */
+for (ii=214748363;ii<=214748365;ii++) {
+  for (i=10*ii;i<=10*ii+9;i++) {
+    S1(ii,i);
+  }
+}
@@ -0,0 +1,28 @@
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+/* Scattering iterators. */
+int t1, t2;
+/* Original iterators. */
+int i, j;
+int lbp, ubp;
+
+if (N >= 1) {
+  lbp=0;
+  ubp=N-1;
+#pragma omp parallel for schedule(dynamic,1)
+  for (t1=lbp;t1<=ubp;t1++) {
+    for (t2=0;t2<=t1;t2++) {
+      L[t1][t2] = L[t1][t2] / L[t2][t2];
+    }
+  }
+}
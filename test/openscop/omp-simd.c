@@ -0,0 +1,40 @@
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+/* Scattering iterators. */
+int t2, t3, t4;
+/* Original iterators. */
+int i, j, k;
+int lbp, ubp;
+int lbv, ubv;
+
+if (N >= 1) {
+  lbp=0;
+  ubp=N-1;
+#pragma omp parallel for collapse(2) private(lbv,ubv)
+  for (t2=lbp;t2<=ubp;t2++) {
+    for (t3=0;t3<=N-1;t3++) {
+      lbv=0;
+      ubv=N-1;
+      #pragma omp simd
+      for (t4=lbv;t4<=ubv;t4++) {
+        C[t2][t3][t4] = A[t2][t3][t4] + B[t2][t3][t4];
+      }
+    }
+  }
+  lbp=0;
+  ubp=N-1;
+#pragma omp parallel for simd
+  for (t2=lbp;t2<=ubp;t2++) {
+    D[t2] = 2.0 * D[t2];
+  }
+}
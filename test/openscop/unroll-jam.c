@@ -0,0 +1,74 @@
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+/* Scattering iterators. */
+int t1, t3, t5;
+/* Original iterators. */
+int i, j, k;
+
+if (N >= 1) {
+  if (N >= 2) {
+    A[0][0] = sqrt(A[0][0]);
+    for (t3=1;t3<=N-1;t3++) {
+      A[t3][0] = A[t3][0] / A[0][0];
+    }
+  }
+  if (N == 1) {
+    A[0][0] = sqrt(A[0][0]);
+  }
+  for (t1=1;t1<=N-3;t1+=2) {
+    for (t3=0;t3<=t1-1;t3++) {
+      A[t1][t1] = A[t1][t1] - A[t1][t3] * A[t1][t3];
+      A[t1+1][t1+1] = A[t1+1][t1+1] - A[t1+1][t3] * A[t1+1][t3];
+    }
+    for (t3=max(0,t1);t3<=t1;t3++) {
+      A[t1+1][t1+1] = A[t1+1][t1+1] - A[t1+1][t3] * A[t1+1][t3];
+    }
+    A[t1][t1] = sqrt(A[t1][t1]);
+    A[t1+1][t1+1] = sqrt(A[t1+1][t1+1]);
+    for (t3=t1+1;t3<=min(N-1,t1+1);t3++) {
+      for (t5=0;t5<=t1-1;t5++) {
+        A[t3][t1] = A[t3][t1] - A[t3][t5] * A[t1][t5];
+      }
+      A[t3][t1] = A[t3][t1] / A[t1][t1];
+    }
+    for (t3=t1+2;t3<=N-1;t3++) {
+      for (t5=0;t5<=t1-1;t5++) {
+        A[t3][t1] = A[t3][t1] - A[t3][t5] * A[t1][t5];
+        A[t3][t1+1] = A[t3][t1+1] - A[t3][t5] * A[t1+1][t5];
+      }
+      for (t5=max(0,t1);t5<=t1;t5++) {
+        A[t3][t1+1] = A[t3][t1+1] - A[t3][t5] * A[t1+1][t5];
+      }
+      A[t3][t1] = A[t3][t1] / A[t1][t1];
+      A[t3][t1+1] = A[t3][t1+1] / A[t1+1][t1+1];
+    }
+  }
+  for (;t1<=N-2;t1++) {
+    for (t3=0;t3<=t1-1;t3++) {
+      A[t1][t1] = A[t1][t1] - A[t1][t3] * A[t1][t3];
+    }
+    A[t1][t1] = sqrt(A[t1][t1]);
+    for (t3=t1+1;t3<=N-1;t3++) {
+      for (t5=0;t5<=t1-1;t5++) {
+        A[t3][t1] = A[t3][t1] - A[t3][t5] * A[t1][t5];
+      }
+      A[t3][t1] = A[t3][t1] / A[t1][t1];
+    }
+  }
+  if (N >= 2) {
+    for (t3=0;t3<=N-2;t3++) {
+      A[N-1][N-1] = A[N-1][N-1] - A[N-1][t3] * A[N-1][t3];
+    }
+    A[N-1][N-1] = sqrt(A[N-1][N-1]);
+  }
+}
@@ -0,0 +1,77 @@
+/* Hand-written reference for ./openscop/unroll-jam.scop. */
+extern void hash(int);
+
+/* Useful macros. */
+#define floord(n,d) (((n)<0) ? -((-(n)+(d)-1)/(d)) : (n)/(d))
+#define ceild(n,d)  (((n)<0) ? -((-(n))/(d)) : ((n)+(d)-1)/(d))
+#define max(x,y)    ((x) > (y) ? (x) : (y))
+#define min(x,y)    ((x) < (y) ? (x) : (y))
+
+#ifdef TIME 
+#define IF_TIME(foo) foo; 
+#else
+#define IF_TIME(foo)
+#endif
+
+#define S1(i,j) { hash(1); hash(i); hash(j); }
+#define S2(i) { hash(2); hash(i); }
+#define S3(i,j,k) { hash(3); hash(i); hash(j); hash(k); }
+#define S4(i,j) { hash(4); hash(i); hash(j); }
+
+/* The iterations of the outer loop but the first and the last one are
+ * unroll-and-jammed by 2: each inner loop scans the ranges of both copies
+ * and guards the iterations of each copy.
+ */
+#define ITER(t1) { \
+  for (t3=0;t3<=(t1)-1;t3++) { \
+    S1((t1),t3); \
+  } \
+  S2((t1)); \
+  for (t3=(t1)+1;t3<=N-1;t3++) { \
+    for (t5=0;t5<=(t1)-1;t5++) { \
+      S3((t1),t3,t5); \
+    } \
+    S4((t1),t3); \
+  } \
+}
+
+void test(int N)
+{
+  /* Scattering iterators. */
+  int t1, t3, t5;
+  /* Original iterators. */
+  int i, j, k;
+  if (N >= 1) {
+    ITER(0);
+    for (t1=1;t1<=N-3;t1+=2) {
+      for (t3=0;t3<=t1;t3++) {
+        if (t3 <= t1-1) {
+          S1(t1,t3);
+        }
+        S1((t1+1),t3);
+      }
+      S2(t1);
+      S2((t1+1));
+      for (t3=t1+1;t3<=N-1;t3++) {
+        for (t5=0;t5<=t1;t5++) {
+          if (t5 <= t1-1) {
+            S3(t1,t3,t5);
+          }
+          if (t3 >= t1+2) {
+            S3((t1+1),t3,t5);
+          }
+        }
+        S4(t1,t3);
+        if (t3 >= t1+2) {
+          S4((t1+1),t3);
+        }
+      }
+    }
+    for (;t1<=N-2;t1++) {
+      ITER(t1);
+    }
+    if (N >= 2) {
+      ITER(N-1);
+    }
+  }
+}
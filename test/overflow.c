@@ -0,0 +1,6 @@
+/* Generated from test/overflow.cloog by CLooG 0.20.0-2346c7c gmp bits in 0.00s. */
+for (c1=0;c1<=13835058055282163712;c1++) {
+  if (c1%3 == 0) {
+    S1((c1/3));
+  }
+}
@@ -0,0 +1,184 @@
+/*
+ * This program times the cloog_seq_* row operations of source/int.c
+ * against plain loops over cloog_int_t, on rows of 8 to 64 elements
+ * that look like constraint rows.  It is not built by default; use
+ * "make test/seq_bench" and run it without arguments.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <cloog/cloog.h>
+
+#define NB_ROWS		4096
+#define NB_ROUNDS	200
+
+static void scalar_neg(cloog_int_t *dst, cloog_int_t *src, unsigned len)
+{
+	unsigned i;
+
+	for (i = 0; i < len; ++i)
+		cloog_int_neg(dst[i], src[i]);
+}
+
+static void scalar_combine(cloog_int_t *dst, cloog_int_t m1,
+	cloog_int_t *src1, cloog_int_t m2, cloog_int_t *src2, unsigned len)
+{
+	unsigned i;
+	cloog_int_t tmp;
+
+	cloog_int_init(tmp);
+	for (i = 0; i < len; ++i) {
+		cloog_int_mul(tmp, m1, src1[i]);
+		cloog_int_addmul(tmp, m2, src2[i]);
+		cloog_int_set(dst[i], tmp);
+	}
+	cloog_int_clear(tmp);
+}
+
+static void scalar_gcd(cloog_int_t *p, unsigned len, cloog_int_t *gcd)
+{
+	unsigned i;
+
+	cloog_int_set_si(*gcd, 0);
+	for (i = 0; i < len && !cloog_int_is_one(*gcd); ++i)
+		if (!cloog_int_is_zero(p[i]))
+			cloog_int_gcd(*gcd, *gcd, p[i]);
+}
+
+static void scalar_normalize(cloog_int_t *p, unsigned len)
+{
+	unsigned i;
+	cloog_int_t gcd;
+
+	cloog_int_init(gcd);
+	scalar_gcd(p, len, &gcd);
+	if (cloog_int_gt_si(gcd, 1))
+		for (i = 0; i < len; ++i)
+			cloog_int_divexact(p[i], p[i], gcd);
+	cloog_int_clear(gcd);
+}
+
+/* Small coefficients with a common factor in every other row,
+ * so that normalization has something to divide.
+ */
+static void fill(cloog_int_t *row, unsigned len, int r)
+{
+	unsigned i;
+	int factor = r % 2 ? 1 : 6;
+
+	for (i = 0; i < len; ++i)
+		cloog_int_set_si(row[i], (rand() % 21 - 10) * factor);
+}
+
+static double seconds(clock_t start)
+{
+	return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void bench(unsigned len)
+{
+	int r, k;
+	unsigned i;
+	cloog_int_t *a, *b, *c, *w, m1, m2, g;
+	double t_lib[4], t_ref[4];
+	clock_t start;
+
+	a = (cloog_int_t *) malloc(NB_ROWS * len * sizeof(cloog_int_t));
+	b = (cloog_int_t *) malloc(NB_ROWS * len * sizeof(cloog_int_t));
+	c = (cloog_int_t *) malloc(NB_ROWS * len * sizeof(cloog_int_t));
+	w = (cloog_int_t *) malloc(NB_ROWS * len * sizeof(cloog_int_t));
+	for (i = 0; i < NB_ROWS * len; ++i) {
+		cloog_int_init(a[i]);
+		cloog_int_init(b[i]);
+		cloog_int_init(c[i]);
+		cloog_int_init(w[i]);
+	}
+	cloog_int_init(m1);
+	cloog_int_init(m2);
+	cloog_int_init(g);
+	for (r = 0; r < NB_ROWS; ++r) {
+		fill(a + r * len, len, r);
+		fill(b + r * len, len, r + 1);
+	}
+	cloog_int_set_si(m1, 3);
+	cloog_int_set_si(m2, -7);
+
+	for (k = 0; k < 2; ++k) {
+		double *t = k ? t_ref : t_lib;
+
+		start = clock();
+		for (i = 0; i < NB_ROUNDS; ++i)
+			for (r = 0; r < NB_ROWS; ++r) {
+				if (k)
+					scalar_neg(c + r * len, a + r * len, len);
+				else
+					cloog_seq_neg(c + r * len, a + r * len, len);
+			}
+		t[0] = seconds(start);
+
+		start = clock();
+		for (i = 0; i < NB_ROUNDS; ++i)
+			for (r = 0; r < NB_ROWS; ++r) {
+				if (k)
+					scalar_combine(c + r * len, m1, a + r * len,
+						       m2, b + r * len, len);
+				else
+					cloog_seq_combine(c + r * len, m1, a + r * len,
+							  m2, b + r * len, len);
+			}
+		t[1] = seconds(start);
+
+		start = clock();
+		for (i = 0; i < NB_ROUNDS; ++i)
+			for (r = 0; r < NB_ROWS; ++r) {
+				if (k)
+					scalar_gcd(a + r * len, len, &g);
+				else
+					cloog_seq_gcd(a + r * len, len, &g);
+			}
+		t[2] = seconds(start);
+
+		start = clock();
+		for (i = 0; i < NB_ROUNDS; ++i) {
+			for (r = 0; r < NB_ROWS * (int) len; ++r)
+				cloog_int_set(w[r], a[r]);
+			for (r = 0; r < NB_ROWS; ++r) {
+				if (k)
+					scalar_normalize(w + r * len, len);
+				else
+					cloog_seq_normalize(w + r * len, len);
+			}
+		}
+		t[3] = seconds(start);
+	}
+
+	printf("%3u %10.3f %10.3f %10.3f %10.3f\n", len,
+	       t_ref[0] / t_lib[0], t_ref[1] / t_lib[1],
+	       t_ref[2] / t_lib[2], t_ref[3] / t_lib[3]);
+
+	cloog_int_clear(m1);
+	cloog_int_clear(m2);
+	cloog_int_clear(g);
+	for (i = 0; i < NB_ROWS * len; ++i) {
+		cloog_int_clear(a[i]);
+		cloog_int_clear(b[i]);
+		cloog_int_clear(c[i]);
+		cloog_int_clear(w[i]);
+	}
+	free(a);
+	free(b);
+	free(c);
+	free(w);
+}
+
+int main(void)
+{
+	unsigned len;
+
+	printf("speedup of cloog_seq_* over plain loops\n");
+	printf("len        neg    combine        gcd  normalize\n");
+	for (len = 8; len <= 64; len *= 2)
+		bench(len);
+	return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * This program checks and times the inline small integers of the GMP
+ * backend (see include/cloog/int.h.in) against plain mpz_t.  Values that
+ * fit in 32 bits are stored inline, larger ones point to an mpz_t.
+ * Additions and multiplications are applied around the two transitions,
+ * from small to big at 2^31 and past the 64 bit range of the fast path
+ * at 2^63, and back again.  Every result is compared with the one of GMP
+ * and must be stored inline again once it fits in 32 bits.
+ * It is not built by default; use "make test/sio_bench" and run it
+ * without arguments.  It exits with a non-zero status on a wrong result.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <cloog/cloog.h>
+
+#if defined(CLOOG_INT_GMP)
+
+#define NB_ROUNDS	2000000
+
+static int nb_errors = 0;
+
+/* Compare "v" with "ref", which is the result of "op", and check that
+ * "v" is stored inline if and only if it fits in 32 bits.
+ */
+static void check(const char *op, cloog_int_t v, mpz_t ref)
+{
+	int small = mpz_cmp_si(ref, INT32_MIN) >= 0 &&
+		    mpz_cmp_si(ref, INT32_MAX) <= 0;
+	mpz_t got;
+
+	mpz_init(got);
+	cloog_int_get_mpz(got, v);
+	if (mpz_cmp(got, ref) || small != (int) cloog_sio_is_small(*v)) {
+		gmp_fprintf(stderr, "%s: got %Zd (%s), expected %Zd\n", op, got,
+			    cloog_sio_is_small(*v) ? "small" : "big", ref);
+		nb_errors++;
+	}
+	mpz_clear(got);
+}
+
+/* Apply addition, subtraction, multiplication and exact division to
+ * "a" and "b", and then undo the addition and the multiplication,
+ * which brings the results back to the small representation
+ * when "a" is small.
+ */
+static void check_pair(mpz_t a, mpz_t b)
+{
+	cloog_int_t x, y, r;
+	mpz_t ref;
+
+	cloog_int_init(x);
+	cloog_int_init(y);
+	cloog_int_init(r);
+	mpz_init(ref);
+	cloog_int_set_mpz(x, a);
+	cloog_int_set_mpz(y, b);
+
+	cloog_int_add(r, x, y);
+	mpz_add(ref, a, b);
+	check("add", r, ref);
+	cloog_int_sub(r, r, y);
+	check("add then sub", r, a);
+
+	cloog_int_sub(r, x, y);
+	mpz_sub(ref, a, b);
+	check("sub", r, ref);
+
+	cloog_int_mul(r, x, y);
+	mpz_mul(ref, a, b);
+	check("mul", r, ref);
+	if (mpz_sgn(b)) {
+		cloog_int_divexact(r, r, y);
+		check("mul then divexact", r, a);
+	}
+
+	cloog_int_set(r, x);
+	cloog_int_addmul(r, x, y);
+	mpz_set(ref, a);
+	mpz_addmul(ref, a, b);
+	check("addmul", r, ref);
+
+	mpz_clear(ref);
+	cloog_int_clear(r);
+	cloog_int_clear(y);
+	cloog_int_clear(x);
+}
+
+/* Values around 0, 2^31 and 2^63, of both signs. */
+static void check_transitions(void)
+{
+	static const int shift[] = { 0, 16, 31, 32, 62, 63, 64 };
+	static const int delta[] = { -1, 0, 1 };
+	int n_shift = sizeof(shift) / sizeof(shift[0]);
+	int n = 2 * n_shift * 3;
+	mpz_t *v;
+	int i, j, k, s;
+
+	v = (mpz_t *) malloc(n * sizeof(mpz_t));
+	for (i = 0, k = 0; i < n_shift; ++i)
+		for (j = 0; j < 3; ++j)
+			for (s = -1; s <= 1; s += 2, ++k) {
+				mpz_init_set_ui(v[k], 1);
+				mpz_mul_2exp(v[k], v[k], shift[i]);
+				if (delta[j] < 0)
+					mpz_sub_ui(v[k], v[k], 1);
+				else if (delta[j] > 0)
+					mpz_add_ui(v[k], v[k], 1);
+				if (s < 0)
+					mpz_neg(v[k], v[k]);
+			}
+	for (i = 0; i < n; ++i)
+		for (j = 0; j < n; ++j)
+			check_pair(v[i], v[j]);
+	for (i = 0; i < n; ++i)
+		mpz_clear(v[i]);
+	free(v);
+}
+
+static double seconds(clock_t start)
+{
+	return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Time a chain of multiply-adds of "m" and "c" on an accumulator that
+ * is reduced modulo "mod" after each step, once with cloog_int_t and
+ * once with mpz_t, and print the ratio of the times.  With a modulus
+ * above 2^31, the accumulator keeps crossing the small/big boundary.
+ */
+static void bench(const char *name, long m, long c, long long mod)
+{
+	int i;
+	clock_t start;
+	double t_sio, t_mpz;
+	cloog_int_t acc, vm, vc, vmod;
+	mpz_t zacc, zm, zc, zmod, ref;
+
+	cloog_int_init(acc);
+	cloog_int_init(vm);
+	cloog_int_init(vc);
+	cloog_int_init(vmod);
+	cloog_int_set_si(acc, 1);
+	cloog_int_set_si(vm, m);
+	cloog_int_set_si(vc, c);
+	cloog_int_set_si(vmod, mod);
+	start = clock();
+	for (i = 0; i < NB_ROUNDS; ++i) {
+		cloog_int_mul(acc, acc, vm);
+		cloog_int_add(acc, acc, vc);
+		cloog_int_fdiv_r(acc, acc, vmod);
+	}
+	t_sio = seconds(start);
+
+	mpz_init_set_si(zacc, 1);
+	mpz_init_set_si(zm, m);
+	mpz_init_set_si(zc, c);
+	mpz_init(zmod);
+	mpz_set_si(zmod, mod);
+	start = clock();
+	for (i = 0; i < NB_ROUNDS; ++i) {
+		mpz_mul(zacc, zacc, zm);
+		mpz_add(zacc, zacc, zc);
+		mpz_fdiv_r(zacc, zacc, zmod);
+	}
+	t_mpz = seconds(start);
+
+	mpz_init(ref);
+	mpz_set(ref, zacc);
+	check(name, acc, ref);
+	printf("%-12s %10.3f\n", name, t_mpz / t_sio);
+
+	mpz_clear(ref);
+	mpz_clear(zmod);
+	mpz_clear(zc);
+	mpz_clear(zm);
+	mpz_clear(zacc);
+	cloog_int_clear(vmod);
+	cloog_int_clear(vc);
+	cloog_int_clear(vm);
+	cloog_int_clear(acc);
+}
+
+int main(void)
+{
+	check_transitions();
+
+	printf("speedup of cloog_int_t over mpz_t\n");
+	bench("small", 1103, 12345, 65521);
+	bench("2^31", 48271, 12345, 4294967291LL);
+	bench("2^63", 48271, 12345, 9223372036854775783LL);
+
+	if (nb_errors)
+		fprintf(stderr, "%d wrong results\n", nb_errors);
+	return nb_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main(void)
+{
+	printf("cloog_int_t only has a small representation with GMP\n");
+	return 0;
+}
+
+#endif
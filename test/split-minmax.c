@@ -0,0 +1,26 @@
+/* Generated from ../test/split-minmax.cloog by CLooG 0.20.0-4cd9074 gmp bits in 0.01s. */
+if (N >= 1) {
+  S1(0,(N-1));
+  for (p=-N+2;p<=-1;p++) {
+    for (i=0;i<=p+N-2;i++) {
+      S1(i,(-p+i));
+      S2(i,(-p+i+1));
+    }
+    S1((p+N-1),(N-1));
+  }
+  if (N >= 2) {
+    for (i=0;i<=N-2;i++) {
+      S1(i,i);
+      S2(i,(i+1));
+    }
+    S1((N-1),(N-1));
+  }
+  for (p=1;p<=N-1;p++) {
+    S2((p-1),0);
+    for (i=p;i<=N-1;i++) {
+      S1(i,(-p+i));
+      S2(i,(-p+i+1));
+    }
+  }
+  S2((N-1),0);
+}